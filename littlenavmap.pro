@@ -74,7 +74,7 @@
 # End of configuration documentation
 # =============================================================================
 
-QT += core gui sql xml network svg printsupport
+QT += core gui sql xml network svg printsupport concurrent
 
 CONFIG += build_all c++14
 CONFIG -= debug_and_release debug_and_release_target
@@ -224,6 +224,8 @@ message(-----------------------------------)
 
 SOURCES += \
   src/airspace/airspacecontroller.cpp \
+  src/airspace/airspacegeometrycache.cpp \
+  src/airspace/airspaceindex.cpp \
   src/airspace/airspacetoolbarhandler.cpp \
   src/track/trackcontroller.cpp \
   src/track/trackmanager.cpp \
@@ -233,8 +235,10 @@ SOURCES += \
   src/common/coordinateconverter.cpp \
   src/common/dialogrecordhelper.cpp \
   src/common/elevationprovider.cpp \
+  src/common/globemappedreader.cpp \
   src/common/formatter.cpp \
   src/common/fueltool.cpp \
+  src/common/htmlcellupdater.cpp \
   src/common/htmlinfobuilder.cpp \
   src/common/jumpback.cpp \
   src/common/mapcolors.cpp \
@@ -242,8 +246,10 @@ SOURCES += \
   src/common/maptools.cpp \
   src/common/maptypes.cpp \
   src/common/maptypesfactory.cpp \
+  src/common/moragrid.cpp \
   src/common/proctypes.cpp \
   src/common/settingsmigrate.cpp \
+  src/common/startuptracer.cpp \
   src/common/symbolpainter.cpp \
   src/common/tabindexes.cpp \
   src/common/textplacement.cpp \
@@ -253,6 +259,10 @@ SOURCES += \
   src/common/vehicleicons.cpp \
   src/connect/connectclient.cpp \
   src/connect/connectdialog.cpp \
+  src/connect/simdatarecorder.cpp \
+  src/connect/simdatareplay.cpp \
+  src/connect/simdatasnapshot.cpp \
+  src/connect/trafficgenerator.cpp \
   src/db/databasedialog.cpp \
   src/db/databasemanager.cpp \
   src/db/dbtypes.cpp \
@@ -282,6 +292,7 @@ SOURCES += \
   src/mapgui/mapmarkhandler.cpp \
   src/mapgui/mappaintwidget.cpp \
   src/mapgui/mapscale.cpp \
+  src/mapgui/mapscreengrid.cpp \
   src/mapgui/mapscreenindex.cpp \
   src/mapgui/maptooltip.cpp \
   src/mapgui/mapvisible.cpp \
@@ -304,6 +315,7 @@ SOURCES += \
   src/mappainter/mappaintlayer.cpp \
   src/navapp.cpp \
   src/online/onlinedatacontroller.cpp \
+  src/online/onlinemotionmodel.cpp \
   src/options/optiondata.cpp \
   src/options/optionsdialog.cpp \
   src/perf/aircraftperfcontroller.cpp \
@@ -331,13 +343,16 @@ SOURCES += \
   src/route/routealtitude.cpp \
   src/route/routealtitudeleg.cpp \
   src/route/routecalcwindow.cpp \
+  src/route/routecalcworker.cpp \
   src/route/routecommand.cpp \
   src/route/routecontroller.cpp \
   src/route/routeexport.cpp \
   src/route/routeexportdata.cpp \
   src/route/routeexportdialog.cpp \
   src/route/routeextractor.cpp \
+  src/route/routenetworkcache.cpp \
   src/route/routeleg.cpp \
+  src/route/routelegindex.cpp \
   src/route/userwaypointdialog.cpp \
   src/routestring/routestringdialog.cpp \
   src/routestring/routestringreader.cpp \
@@ -371,12 +386,15 @@ SOURCES += \
   src/web/webcontroller.cpp \
   src/web/requesthandler.cpp \
   src/web/webmapcontroller.cpp \
+  src/web/webtilecache.cpp \
     src/web/webtools.cpp \
     src/web/webflags.cpp \
     src/web/webapp.cpp
 
 HEADERS  += \
   src/airspace/airspacecontroller.h \
+  src/airspace/airspacegeometrycache.h \
+  src/airspace/airspaceindex.h \
   src/airspace/airspacetoolbarhandler.h \
   src/track/trackcontroller.h \
   src/track/trackmanager.h \
@@ -386,8 +404,10 @@ HEADERS  += \
   src/common/coordinateconverter.h \
   src/common/dialogrecordhelper.h \
   src/common/elevationprovider.h \
+  src/common/globemappedreader.h \
   src/common/formatter.h \
   src/common/fueltool.h \
+  src/common/htmlcellupdater.h \
   src/common/htmlinfobuilder.h \
   src/common/jumpback.h \
   src/common/mapcolors.h \
@@ -395,8 +415,10 @@ HEADERS  += \
   src/common/maptools.h \
   src/common/maptypes.h \
   src/common/maptypesfactory.h \
+  src/common/moragrid.h \
   src/common/proctypes.h \
   src/common/settingsmigrate.h \
+  src/common/startuptracer.h \
   src/common/symbolpainter.h \
   src/common/tabindexes.h \
   src/common/textplacement.h \
@@ -406,6 +428,10 @@ HEADERS  += \
   src/common/vehicleicons.h \
   src/connect/connectclient.h \
   src/connect/connectdialog.h \
+  src/connect/simdatarecorder.h \
+  src/connect/simdatareplay.h \
+  src/connect/simdatasnapshot.h \
+  src/connect/trafficgenerator.h \
   src/db/databasedialog.h \
   src/db/databasemanager.h \
   src/db/dbtypes.h \
@@ -434,6 +460,7 @@ HEADERS  += \
   src/mapgui/mapmarkhandler.h \
   src/mapgui/mappaintwidget.h \
   src/mapgui/mapscale.h \
+  src/mapgui/mapscreengrid.h \
   src/mapgui/mapscreenindex.h \
   src/mapgui/maptooltip.h \
   src/mapgui/mapvisible.h \
@@ -456,6 +483,7 @@ HEADERS  += \
   src/mappainter/mappaintlayer.h \
   src/navapp.h \
   src/online/onlinedatacontroller.h \
+  src/online/onlinemotionmodel.h \
   src/options/optiondata.h \
   src/options/optionsdialog.h \
   src/perf/aircraftperfcontroller.h \
@@ -483,13 +511,16 @@ HEADERS  += \
   src/route/routealtitude.h \
   src/route/routealtitudeleg.h \
   src/route/routecalcwindow.h \
+  src/route/routecalcworker.h \
   src/route/routecommand.h \
   src/route/routecontroller.h \
   src/route/routeexport.h \
   src/route/routeexportdata.h \
   src/route/routeexportdialog.h \
   src/route/routeextractor.h \
+  src/route/routenetworkcache.h \
   src/route/routeleg.h \
+  src/route/routelegindex.h \
   src/route/userwaypointdialog.h \
   src/routestring/routestringdialog.h \
   src/routestring/routestringreader.h \
@@ -523,6 +554,7 @@ HEADERS  += \
   src/web/webcontroller.h \
   src/web/requesthandler.h \
   src/web/webmapcontroller.h \
+  src/web/webtilecache.h \
     src/web/webtools.h \
     src/web/webflags.h \
     src/web/webapp.h
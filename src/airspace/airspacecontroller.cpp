@@ -23,6 +23,9 @@
 #include "common/constants.h"
 #include "db/databasemanager.h"
 #include "airspace/airspacetoolbarhandler.h"
+#include "airspace/airspacegeometrycache.h"
+#include "route/route.h"
+#include "connect/simdatasnapshot.h"
 #include "navapp.h"
 #include "ui_mainwindow.h"
 #include "gui/widgetstate.h"
@@ -37,10 +40,27 @@
 #include "exception.h"
 #include "gui/errorhandler.h"
 
+#include "sql/sqlquery.h"
+#include "sql/sqlutil.h"
+
 #include <QAction>
 #include <QDir>
 #include <QDirIterator>
+#include <QEventLoop>
+#include <QFutureWatcher>
 #include <QProgressDialog>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentMap>
+
+/* Connection names for parallel reading of user airspaces */
+static const QLatin1String DATABASE_NAME_AIRSPACE_TEMPLATE("LNMDBUSERAIRSPACETEMPLATE");
+static const QLatin1String DATABASE_NAME_AIRSPACE_READER("LNMDBUSERAIRSPACEREADER");
+static const QLatin1String DATABASE_NAME_AIRSPACE_MERGE("LNMDBUSERAIRSPACEMERGE");
+
+/* Recalculate airspaces at aircraft only if altitude changed more than this or moved more than about 100 m */
+static const float MIN_ALTITUDE_CHANGE_FT = 50.f;
 
 AirspaceController::AirspaceController(MainWindow *mainWindowParam,
                                        atools::sql::SqlDatabase *dbSim, atools::sql::SqlDatabase *dbNav,
@@ -60,6 +80,8 @@ AirspaceController::AirspaceController(MainWindow *mainWindowParam,
   for(AirspaceQuery *q:queries.values())
     q->initQueries();
 
+  geometryCache = new AirspaceGeometryCache;
+
   // Button and action handler =================================
   qDebug() << Q_FUNC_INFO << "Creating InfoController";
   airspaceHandler = new AirspaceToolBarHandler(NavApp::getMainWindow());
@@ -83,6 +105,11 @@ AirspaceController::~AirspaceController()
 
   qDeleteAll(queries);
   queries.clear();
+
+  delete geometryCache;
+
+  qDeleteAll(indexes);
+  indexes.clear();
 }
 
 void AirspaceController::sourceToggled()
@@ -93,6 +120,9 @@ void AirspaceController::sourceToggled()
   sources.setFlag(map::AIRSPACE_SRC_USER, ui->actionViewAirspaceSrcUser->isChecked());
   sources.setFlag(map::AIRSPACE_SRC_ONLINE, ui->actionViewAirspaceSrcOnline->isChecked());
 
+  // Indexes are kept per source - only results have to be updated
+  invalidateIndex(map::AIRSPACE_SRC_NONE);
+
   emit updateAirspaceSources(sources);
 }
 
@@ -219,6 +249,141 @@ const atools::geo::LineString *AirspaceController::getAirspaceGeometry(map::MapA
   return nullptr;
 }
 
+const atools::geo::LineString *AirspaceController::getAirspaceGeometry(map::MapAirspaceId id,
+                                                                       const Marble::ViewportParams *viewport)
+{
+  int band = AirspaceGeometryCache::zoomBand(viewport);
+  if(band == 0)
+    return getAirspaceGeometry(id);
+  else
+    return geometryCache->getGeometry(id, band, getAirspaceGeometry(id));
+}
+
+const Marble::GeoDataLinearRing *AirspaceController::getAirspaceRing(map::MapAirspaceId id,
+                                                                     const Marble::ViewportParams *viewport)
+{
+  if((id.src & map::AIRSPACE_SRC_USER) && loadingUserAirspaces)
+    // Avoid deadlock while loading user airspaces
+    return nullptr;
+
+  return geometryCache->getRing(id, AirspaceGeometryCache::zoomBand(viewport), getAirspaceGeometry(id));
+}
+
+void AirspaceController::getAirspacesAt(QVector<map::MapAirspace>& airspaces, const atools::geo::Pos& pos,
+                                        float altitudeFt)
+{
+  airspaces.clear();
+
+  QVector<const map::MapAirspace *> result;
+  for(map::MapAirspaceSources src : map::MAP_AIRSPACE_SRC_VALUES)
+  {
+    if(sources & src)
+    {
+      AirspaceIndex *index = airspaceIndex(src);
+      if(index != nullptr)
+      {
+        index->getAirspacesAt(result, pos, altitudeFt);
+        for(const map::MapAirspace *airspace : result)
+          airspaces.append(*airspace);
+      }
+    }
+  }
+}
+
+const QVector<AirspaceCrossing>& AirspaceController::getRouteCrossings()
+{
+  if(!routeCrossingsValid)
+  {
+    routeCrossings.clear();
+
+    // Use legs from departure to destination excluding alternates
+    const Route& route = NavApp::getRouteConst();
+    int destIndex = route.getDestinationAirportLegIndex();
+    if(destIndex != map::INVALID_INDEX_VALUE)
+    {
+      atools::geo::LineString line;
+      for(int i = 0; i <= destIndex; i++)
+        line.append(route.getPositionAt(i));
+
+      QVector<AirspaceCrossing> crossings;
+      for(map::MapAirspaceSources src : map::MAP_AIRSPACE_SRC_VALUES)
+      {
+        if(sources & src)
+        {
+          AirspaceIndex *index = airspaceIndex(src);
+          if(index != nullptr)
+          {
+            index->getCrossings(crossings, line, route.getCruisingAltitudeFeet());
+            routeCrossings.append(crossings);
+          }
+        }
+      }
+
+      std::stable_sort(routeCrossings.begin(), routeCrossings.end(),
+                       [](const AirspaceCrossing& c1, const AirspaceCrossing& c2) -> bool {
+        return c1.distanceNm < c2.distanceNm;
+      });
+    }
+    routeCrossingsValid = true;
+  }
+  return routeCrossings;
+}
+
+void AirspaceController::simDataChanged(const SimDataSnapshot& snapshot)
+{
+  const atools::fs::sc::SimConnectData& simulatorData = *snapshot;
+  if(!simulatorData.isUserAircraftValid())
+    return;
+
+  const atools::geo::Pos& pos = simulatorData.getUserAircraftConst().getPosition();
+  if(lastAircraftPos.isValid() && pos.almostEqual(lastAircraftPos, atools::geo::Pos::POS_EPSILON_100M) &&
+     std::abs(pos.getAltitude() - lastAircraftPos.getAltitude()) < MIN_ALTITUDE_CHANGE_FT)
+    return;
+
+  lastAircraftPos = pos;
+  getAirspacesAt(aircraftAirspaces, pos, pos.getAltitude());
+}
+
+void AirspaceController::routeChanged()
+{
+  routeCrossingsValid = false;
+}
+
+void AirspaceController::invalidateIndex(map::MapAirspaceSources sourcesToInvalidate)
+{
+  indexesOutdated |= sourcesToInvalidate;
+  routeCrossingsValid = false;
+  routeCrossings.clear();
+  aircraftAirspaces.clear();
+  lastAircraftPos = atools::geo::EMPTY_POS;
+}
+
+AirspaceIndex *AirspaceController::airspaceIndex(map::MapAirspaceSources src)
+{
+  AirspaceQuery *query = queries.value(src);
+  if(query == nullptr || ((src & map::AIRSPACE_SRC_USER) && loadingUserAirspaces))
+    return nullptr;
+
+  AirspaceIndex *index = indexes.value(src);
+  if(index == nullptr)
+  {
+    index = new AirspaceIndex;
+    indexes.insert(src, index);
+  }
+
+  if(indexesOutdated & src)
+  {
+    // Load all airspaces once - geometry is loaded and kept by the index on demand
+    QVector<map::MapAirspace> airspaces;
+    query->getAllAirspaces(airspaces);
+    index->build(airspaces, [ = ](map::MapAirspaceId id) -> const atools::geo::LineString * {
+      return getAirspaceGeometry(id);
+    });
+    indexesOutdated &= ~src;
+  }
+  return index;
+}
+
 void AirspaceController::restoreState()
 {
   Ui::MainWindow *ui = NavApp::getMainUi();
@@ -246,6 +411,8 @@ void AirspaceController::optionsChanged()
     for(AirspaceQuery *q:queries.values())
       // Also calls deinit before and clears caches
       q->initQueries();
+    geometryCache->clear();
+    invalidateIndex(map::AIRSPACE_SRC_ALL);
   }
 }
 
@@ -257,6 +424,8 @@ void AirspaceController::preDatabaseLoad()
   {
     for(AirspaceQuery *q:queries.values())
       q->deInitQueries();
+    geometryCache->clear();
+    invalidateIndex(map::AIRSPACE_SRC_ALL);
   }
 }
 
@@ -268,6 +437,7 @@ void AirspaceController::postDatabaseLoad()
   {
     for(AirspaceQuery *q:queries.values())
       q->initQueries();
+    invalidateIndex(map::AIRSPACE_SRC_ALL);
   }
 }
 
@@ -275,6 +445,8 @@ void AirspaceController::onlineClientAndAtcUpdated()
 {
   if(queries.contains(map::AIRSPACE_SRC_ONLINE))
     queries.value(map::AIRSPACE_SRC_ONLINE)->clearCache();
+  geometryCache->clear(map::AIRSPACE_SRC_ONLINE);
+  invalidateIndex(map::AIRSPACE_SRC_ONLINE);
 }
 
 void AirspaceController::resetAirspaceOnlineScreenGeometry()
@@ -284,6 +456,8 @@ void AirspaceController::resetAirspaceOnlineScreenGeometry()
     queries.value(map::AIRSPACE_SRC_ONLINE)->deInitQueries();
     queries.value(map::AIRSPACE_SRC_ONLINE)->initQueries();
   }
+  geometryCache->clear(map::AIRSPACE_SRC_ONLINE);
+  invalidateIndex(map::AIRSPACE_SRC_ONLINE);
 }
 
 void AirspaceController::resetSettingsToDefault()
@@ -338,76 +512,103 @@ void AirspaceController::loadAirspaces()
     preLoadAirpaces();
 
     bool success = false;
-    int sceneryId = 1, fileId = 1, numRead = 0, numFiles = 0;
+    int sceneryId = 1, numRead = 0, numFiles = 0, numUnchanged = 0;
     QStringList errors;
 
     try
     {
-      // Get database and drop and create schema =======================================
       atools::sql::SqlDatabase *dbUserAirspace = NavApp::getDatabaseUserAirspace();
 
-      // Use a manual transaction
-      atools::sql::SqlTransaction transaction(dbUserAirspace);
-
-      NavApp::getDatabaseManager()->createEmptySchema(dbUserAirspace, true /* boundary */);
-
-      // Write scenery area for display in information window =====================
-      atools::fs::common::MetadataWriter metadataWriter(*dbUserAirspace);
-      metadataWriter.writeSceneryArea(basePath, "User Airspaces", sceneryId);
-
       // Prepare filters and flags for folder search ========================
       QStringList filter = OptionData::instance().getCacheUserAirspaceExtensions().simplified().split(" ");
       QDir::Filters filterFlags = QDir::Files | QDir::Hidden | QDir::System;
       QDirIterator::IteratorFlags iterFlags = QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
 
-      // Count files for progress =================================================
-      QDirIterator countDirIter(basePath, filter, filterFlags, iterFlags);
-      while(countDirIter.hasNext())
-      {
-        countDirIter.next();
-        numFiles++;
-      }
-
-      // Set up progress dialog ==================================================
-      QProgressDialog progress(tr("Reading airspaces ..."), tr("&Cancel"), 0, numFiles, mainWindow);
-      progress.setWindowModality(Qt::WindowModal);
-      progress.setMinimumDuration(0);
-      progress.show();
-
-      // Read files ==================================================
-      atools::fs::userdata::AirspaceReaderOpenAir writer(dbUserAirspace);
-      int fileProgress = 0;
-      bool canceled = false;
+      // Collect files in one pass =================================================
+      QStringList files;
       QDirIterator dirIter(basePath, filter, filterFlags, iterFlags);
       while(dirIter.hasNext())
+        files.append(dirIter.next());
+      numFiles = files.size();
+
+      // Get files from last load to allow incremental updates =====================
+      // Maps file path to file id and signature
+      QHash<QString, std::pair<int, QString> > loadedFiles;
+      int fileId = 1;
+      bool incremental = false;
+      if(atools::sql::SqlUtil(dbUserAirspace).hasTableAndRows("bgl_file"))
       {
-        QString file = dirIter.next();
-        qDebug() << Q_FUNC_INFO << file;
+        incremental = true;
+        atools::sql::SqlQuery query(dbUserAirspace);
+        query.exec("select bgl_file_id, filepath, comment from bgl_file");
+        while(query.next())
+        {
+          QString filepath = query.valueStr("filepath");
+
+          // Do a full reload if base path has changed
+          if(!filepath.startsWith(basePath))
+            incremental = false;
 
-        // Write file metadata for display in information window
-        metadataWriter.writeFile(file, QString(), sceneryId, fileId);
+          loadedFiles.insert(filepath, std::make_pair(query.valueInt("bgl_file_id"), query.valueStr("comment")));
+          fileId = std::max(fileId, query.valueInt("bgl_file_id") + 1);
+        }
+      }
 
-        // Read OpenAir file =============================================================
-        writer.readFile(fileId, file);
-        numRead += writer.getNumAirspacesRead();
+      // Use a manual transaction
+      atools::sql::SqlTransaction transaction(dbUserAirspace);
+      atools::fs::common::MetadataWriter metadataWriter(*dbUserAirspace);
 
-        progress.setValue(fileProgress++);
+      QStringList filesToRead;
+      if(incremental)
+      {
+        // Remove airspaces of changed and deleted files ================================
+        QSet<QString> currentFiles = files.toSet();
+        atools::sql::SqlQuery deleteBoundary(dbUserAirspace), deleteFile(dbUserAirspace);
+        deleteBoundary.prepare("delete from boundary where file_id = :id");
+        deleteFile.prepare("delete from bgl_file where bgl_file_id = :id");
 
-        if(progress.wasCanceled())
+        for(auto it = loadedFiles.constBegin(); it != loadedFiles.constEnd(); ++it)
         {
-          canceled = true;
-          break;
+          if(!currentFiles.contains(it.key()) || fileSignature(it.key()) != it.value().second)
+          {
+            qDebug() << Q_FUNC_INFO << "Removing" << it.key();
+            deleteBoundary.bindValue(":id", it.value().first);
+            deleteBoundary.exec();
+            deleteFile.bindValue(":id", it.value().first);
+            deleteFile.exec();
+          }
         }
 
-        for(const atools::fs::userdata::AirspaceReaderOpenAir::AirspaceErr& err : writer.getErrors())
-          errors.append(tr("File \"%1\" line %2: %3").
-                        arg(QDir(basePath).relativeFilePath(err.file)).arg(err.line).arg(err.message));
+        // Read only new and changed files
+        for(const QString& file : files)
+        {
+          if(!loadedFiles.contains(file) || fileSignature(file) != loadedFiles.value(file).second)
+            filesToRead.append(file);
+        }
+        numUnchanged = files.size() - filesToRead.size();
+        qDebug() << Q_FUNC_INFO << "Incremental" << filesToRead.size() << "of" << files.size();
+      }
+      else
+      {
+        // Drop and create schema =======================================
+        fileId = 1;
+        NavApp::getDatabaseManager()->createEmptySchema(dbUserAirspace, true /* boundary */);
 
-        fileId++;
+        // Write scenery area for display in information window =====================
+        metadataWriter.writeSceneryArea(basePath, "User Airspaces", sceneryId);
+        filesToRead = files;
       }
-      progress.setValue(numFiles);
 
-      if(canceled)
+      // Write file metadata for display in information window and signature for next incremental load
+      QVector<int> fileIds;
+      for(const QString& file : filesToRead)
+      {
+        metadataWriter.writeFile(file, fileSignature(file), sceneryId, fileId);
+        fileIds.append(fileId++);
+      }
+
+      // Read files in parallel and copy results into user database ============================
+      if(readAirspaceFiles(dbUserAirspace, filesToRead, fileIds, basePath, numRead, errors))
         // User bailed out - restore previous state
         transaction.rollback();
       else
@@ -429,7 +630,10 @@ void AirspaceController::loadAirspaces()
     if(success)
     {
       QString message = tr("Loaded %1 airspaces from %2 files from base path\n"
-                           "\"%3\".").arg(numRead).arg(numFiles).arg(basePath);
+                           "\"%3\".").arg(numRead).arg(numFiles - numUnchanged).arg(basePath);
+
+      if(numUnchanged > 0)
+        message.append(tr("\nSkipped %1 unchanged files.").arg(numUnchanged));
 
       if(!errors.isEmpty())
       {
@@ -496,6 +700,8 @@ void AirspaceController::preLoadAirpaces()
   loadingUserAirspaces = true;
   if(queries.contains(map::AIRSPACE_SRC_USER))
     queries.value(map::AIRSPACE_SRC_USER)->deInitQueries();
+  geometryCache->clear(map::AIRSPACE_SRC_USER);
+  invalidateIndex(map::AIRSPACE_SRC_USER);
 
   emit preDatabaseLoadAirspaces();
 }
@@ -505,6 +711,7 @@ void AirspaceController::postLoadAirpaces()
   if(queries.contains(map::AIRSPACE_SRC_USER))
     queries.value(map::AIRSPACE_SRC_USER)->initQueries();
   loadingUserAirspaces = false;
+  invalidateIndex(map::AIRSPACE_SRC_USER);
 
   emit postDatabaseLoadAirspaces(NavApp::getCurrentSimulatorDb());
 }
@@ -520,3 +727,191 @@ QStringList AirspaceController::getAirspaceSourcesStr() const
 
   return retval;
 }
+
+QString AirspaceController::fileSignature(const QString& filepath)
+{
+  QFileInfo fi(filepath);
+  return QString("%1 %2").arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch());
+}
+
+bool AirspaceController::readAirspaceFiles(atools::sql::SqlDatabase *db, const QStringList& files,
+                                           const QVector<int>& fileIds, const QString& basePath,
+                                           int& numRead, QStringList& errors)
+{
+  using atools::sql::SqlDatabase;
+  using atools::sql::SqlQuery;
+
+  if(files.isEmpty())
+    return false;
+
+  QTemporaryDir tempDir;
+  if(!tempDir.isValid())
+    throw atools::Exception(tr("Cannot create temporary directory: %1").arg(tempDir.errorString()));
+
+  // Create template database with empty schema for the worker threads ===================
+  QString templateFile = tempDir.filePath("template.sqlite");
+  SqlDatabase::addDatabase("QSQLITE", DATABASE_NAME_AIRSPACE_TEMPLATE);
+  {
+    SqlDatabase templateDb(DATABASE_NAME_AIRSPACE_TEMPLATE);
+    templateDb.setDatabaseName(templateFile);
+    templateDb.open();
+    NavApp::getDatabaseManager()->createEmptySchema(&templateDb, true /* boundary */);
+    templateDb.close();
+  }
+  SqlDatabase::removeDatabase(DATABASE_NAME_AIRSPACE_TEMPLATE);
+
+  // Distribute files on jobs - each has its own database =================================
+  struct ReadJob
+  {
+    QStringList files;
+    QVector<int> fileIds;
+    QString dbFile, connectionName;
+  };
+
+  struct ReadResult
+  {
+    int numRead = 0;
+    QStringList errors;
+    QString exception;
+  };
+
+  int numJobs = std::max(1, std::min(QThread::idealThreadCount(), files.size()));
+  QVector<ReadJob> jobs(numJobs);
+  for(int i = 0; i < files.size(); i++)
+  {
+    jobs[i % numJobs].files.append(files.at(i));
+    jobs[i % numJobs].fileIds.append(fileIds.at(i));
+  }
+
+  for(int i = 0; i < numJobs; i++)
+  {
+    jobs[i].dbFile = tempDir.filePath(QString("airspace%1.sqlite").arg(i));
+    jobs[i].connectionName = DATABASE_NAME_AIRSPACE_READER + QString::number(i);
+    if(!QFile::copy(templateFile, jobs.at(i).dbFile))
+      throw atools::Exception(tr("Cannot create temporary database \"%1\"").arg(jobs.at(i).dbFile));
+  }
+
+  // Parse files in worker threads ===================================================
+  QAtomicInt filesDone(0), canceled(0);
+  std::function<ReadResult(const ReadJob&)> readFunc =
+    [&filesDone, &canceled, &basePath](const ReadJob& job) -> ReadResult
+  {
+    ReadResult result;
+    SqlDatabase::addDatabase("QSQLITE", job.connectionName);
+    try
+    {
+      SqlDatabase jobDb(job.connectionName);
+      jobDb.setDatabaseName(job.dbFile);
+      jobDb.open();
+      {
+        atools::sql::SqlTransaction transaction(&jobDb);
+        atools::fs::userdata::AirspaceReaderOpenAir reader(&jobDb);
+        for(int i = 0; i < job.files.size() && canceled.loadAcquire() == 0; i++)
+        {
+          reader.readFile(job.fileIds.at(i), job.files.at(i));
+          result.numRead += reader.getNumAirspacesRead();
+
+          for(const atools::fs::userdata::AirspaceReaderOpenAir::AirspaceErr& err : reader.getErrors())
+            result.errors.append(tr("File \"%1\" line %2: %3").
+                                 arg(QDir(basePath).relativeFilePath(err.file)).arg(err.line).arg(err.message));
+
+          filesDone.fetchAndAddRelease(1);
+        }
+        transaction.commit();
+      }
+      jobDb.close();
+    }
+    catch(atools::Exception& e)
+    {
+      result.exception = e.what();
+    }
+    catch(...)
+    {
+      result.exception = tr("Unknown exception");
+    }
+    SqlDatabase::removeDatabase(job.connectionName);
+    return result;
+  };
+
+  QFuture<ReadResult> future = QtConcurrent::mapped(jobs, readFunc);
+
+  // Set up progress dialog ==================================================
+  QProgressDialog progress(tr("Reading airspaces ..."), tr("&Cancel"), 0, files.size(), mainWindow);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(0);
+  progress.show();
+
+  // Wait in an event loop to keep the dialog and its cancel button responsive
+  QEventLoop loop;
+  QFutureWatcher<ReadResult> watcher;
+  connect(&watcher, &QFutureWatcher<ReadResult>::finished, &loop, &QEventLoop::quit);
+  connect(&progress, &QProgressDialog::canceled, &loop, [&canceled]() -> void {
+    canceled.storeRelease(1);
+  });
+
+  QTimer progressTimer;
+  connect(&progressTimer, &QTimer::timeout, &progress, [&progress, &filesDone]() -> void {
+    progress.setValue(filesDone.loadAcquire());
+  });
+  progressTimer.start(100);
+
+  watcher.setFuture(future);
+  if(!future.isFinished())
+    // Finished signal is queued if the future completes before the loop runs
+    loop.exec();
+  progressTimer.stop();
+  future.waitForFinished();
+  progress.setValue(files.size());
+
+  if(canceled.loadAcquire() != 0)
+    return true;
+
+  // Copy results from worker databases into user database - single writer ==================
+  atools::sql::SqlRecord boundaryRec = db->record("boundary");
+  QStringList columns, bindColumns;
+  for(int i = 0; i < boundaryRec.count(); i++)
+  {
+    // Let database assign new ids
+    if(boundaryRec.fieldName(i) != "boundary_id")
+    {
+      columns.append(boundaryRec.fieldName(i));
+      bindColumns.append(":" + boundaryRec.fieldName(i));
+    }
+  }
+
+  SqlQuery insert(db);
+  insert.prepare("insert into boundary (" + columns.join(", ") + ") values (" + bindColumns.join(", ") + ")");
+
+  const QList<ReadResult> results = future.results();
+  for(int i = 0; i < results.size(); i++)
+  {
+    const ReadResult& result = results.at(i);
+    if(!result.exception.isEmpty())
+      throw atools::Exception(result.exception);
+
+    numRead += result.numRead;
+    errors.append(result.errors);
+
+    SqlDatabase::addDatabase("QSQLITE", DATABASE_NAME_AIRSPACE_MERGE);
+    {
+      SqlDatabase jobDb(DATABASE_NAME_AIRSPACE_MERGE);
+      jobDb.setDatabaseName(jobs.at(i).dbFile);
+      jobDb.setReadonly();
+      jobDb.open();
+
+      SqlQuery select(&jobDb);
+      select.exec("select " + columns.join(", ") + " from boundary");
+      while(select.next())
+      {
+        for(int col = 0; col < columns.size(); col++)
+          insert.bindValue(bindColumns.at(col), select.value(col));
+        insert.exec();
+      }
+      select.finish();
+      jobDb.close();
+    }
+    SqlDatabase::removeDatabase(DATABASE_NAME_AIRSPACE_MERGE);
+  }
+
+  return false;
+}
@@ -18,11 +18,16 @@
 #ifndef LNM_AIRSPACECONTROLLER_H
 #define LNM_AIRSPACECONTROLLER_H
 
-#include "common/maptypes.h"
+#include "airspace/airspaceindex.h"
 
 #include <QObject>
 
 namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+}
+}
 namespace sql {
 class SqlDatabase;
 class SqlRecord;
@@ -31,10 +36,14 @@ class SqlRecord;
 
 namespace Marble {
 class GeoDataLatLonBox;
+class GeoDataLinearRing;
+class ViewportParams;
 }
 
 class AirspaceQuery;
+class AirspaceGeometryCache;
 class MapLayer;
+class SimDataSnapshot;
 class AirspaceToolBarHandler;
 class MainWindow;
 
@@ -75,6 +84,32 @@ public:
   /* Get Geometry for any airspace and source database */
   const atools::geo::LineString *getAirspaceGeometry(map::MapAirspaceId id);
 
+  /* Get geometry simplified for the zoom level of the viewport. Pointer is valid until the next call. */
+  const atools::geo::LineString *getAirspaceGeometry(map::MapAirspaceId id, const Marble::ViewportParams *viewport);
+
+  /* Get prepared and simplified ring for painting. Pointer is valid until the next call. */
+  const Marble::GeoDataLinearRing *getAirspaceRing(map::MapAirspaceId id, const Marble::ViewportParams *viewport);
+
+  /* Get airspaces from all enabled sources containing the position at the given altitude.
+   * Uses the spatial index and does not query the database after the first call. */
+  void getAirspacesAt(QVector<map::MapAirspace>& airspaces, const atools::geo::Pos& pos, float altitudeFt);
+
+  /* Airspaces around the user aircraft from the last simulator update */
+  const QVector<map::MapAirspace>& getAirspacesAtAircraft() const
+  {
+    return aircraftAirspaces;
+  }
+
+  /* Entries and exits of airspaces along the flight plan at cruise altitude sorted by distance from departure.
+   * Calculated on demand after flight plan changes. */
+  const QVector<AirspaceCrossing>& getRouteCrossings();
+
+  /* Update airspaces at user aircraft position */
+  void simDataChanged(const SimDataSnapshot& snapshot);
+
+  /* Flight plan or its cruise altitude changed - invalidate crossings */
+  void routeChanged();
+
   /* Read and write widget states, source and airspace selection */
   void restoreState();
   void saveState();
@@ -145,9 +180,37 @@ private:
   void preLoadAirpaces();
   void postLoadAirpaces();
 
+  /* Read OpenAir files in parallel into temporary databases and copy the airspaces into db.
+   * Errors are appended to errors. Returns true if canceled by user. Throws exception on error. */
+  bool readAirspaceFiles(atools::sql::SqlDatabase *db, const QStringList& files, const QVector<int>& fileIds,
+                         const QString& basePath, int& numRead, QStringList& errors);
+
+  /* Size and modification time of file. Stored in the file metadata to detect changes. */
+  static QString fileSignature(const QString& filepath);
+
+  /* Mark spatial indexes for sources as outdated and clear dependent results */
+  void invalidateIndex(map::MapAirspaceSources sourcesToInvalidate);
+
+  /* Get spatial index for source and rebuild it if needed. Returns null if not available. */
+  AirspaceIndex *airspaceIndex(map::MapAirspaceSources src);
+
   AirspaceQueryMapType queries;
   map::MapAirspaceSources sources = map::AIRSPACE_SRC_NONE;
   AirspaceToolBarHandler *airspaceHandler = nullptr;
+
+  /* Simplified geometry for all zoom levels */
+  AirspaceGeometryCache *geometryCache = nullptr;
+
+  /* Spatial index for each source database and flag for outdated ones */
+  QHash<map::MapAirspaceSources, AirspaceIndex *> indexes;
+  map::MapAirspaceSources indexesOutdated = map::AIRSPACE_SRC_ALL;
+
+  /* Airspaces at last aircraft position */
+  QVector<map::MapAirspace> aircraftAirspaces;
+  atools::geo::Pos lastAircraftPos;
+
+  QVector<AirspaceCrossing> routeCrossings;
+  bool routeCrossingsValid = false;
   MainWindow *mainWindow;
   bool loadingUserAirspaces = false;
 };
@@ -0,0 +1,223 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "airspace/airspacegeometrycache.h"
+
+#include <marble/ViewportParams.h>
+
+#include <QDebug>
+
+#include <cmath>
+
+/* Maximum approximate size in bytes of all cached line strings and rings */
+static const int MAX_CACHE_BYTES = 64 * 1024 * 1024;
+
+/* Approximate size of a ring coordinate including the shared private data allocated on the heap */
+static const int RING_POINT_BYTES = 96;
+
+/* Tolerance for zoom band 1. Doubles with each band. */
+static const float MIN_TOLERANCE_DEG = 0.0005f;
+static const int MAX_ZOOM_BAND = 20;
+
+inline uint qHash(const AirspaceGeometryCache::Key& key)
+{
+  return qHash(key.id) ^ static_cast<uint>(key.band << 24);
+}
+
+AirspaceGeometryCache::AirspaceGeometryCache()
+{
+  cache.setMaxCost(MAX_CACHE_BYTES);
+}
+
+AirspaceGeometryCache::~AirspaceGeometryCache()
+{
+
+}
+
+int AirspaceGeometryCache::zoomBand(const Marble::ViewportParams *viewport)
+{
+  if(viewport == nullptr || viewport->radius() <= 0)
+    return 0;
+
+  // Degree covered by one pixel at the equator
+  float degPerPixel = static_cast<float>(360. / (2. * M_PI * viewport->radius()));
+
+  if(degPerPixel < MIN_TOLERANCE_DEG)
+    // Full resolution
+    return 0;
+  else
+    return std::min(1 + static_cast<int>(std::log2(degPerPixel / MIN_TOLERANCE_DEG)), MAX_ZOOM_BAND);
+}
+
+const atools::geo::LineString *AirspaceGeometryCache::getGeometry(map::MapAirspaceId id, int band,
+                                                                  const atools::geo::LineString *geometry)
+{
+  if(band == 0)
+    return geometry;
+
+  Entry *e = entry(id, band, geometry);
+  return e != nullptr ? &e->lines : nullptr;
+}
+
+const Marble::GeoDataLinearRing *AirspaceGeometryCache::getRing(map::MapAirspaceId id, int band,
+                                                                const atools::geo::LineString *geometry)
+{
+  Entry *e = entry(id, band, geometry);
+  return e != nullptr ? &e->ring : nullptr;
+}
+
+AirspaceGeometryCache::Entry *AirspaceGeometryCache::entry(map::MapAirspaceId id, int band,
+                                                           const atools::geo::LineString *geometry)
+{
+  Key key = {id, band};
+  Entry *e = cache.object(key);
+
+  if(e == nullptr && geometry != nullptr)
+  {
+    e = new Entry;
+    if(band == 0)
+      e->lines = *geometry;
+    else
+      simplify(e->lines, *geometry, MIN_TOLERANCE_DEG * static_cast<float>(1 << (band - 1)));
+
+    // Prepare ring for painting
+    e->ring.setTessellate(true);
+    for(const atools::geo::Pos& pos : e->lines)
+      e->ring.append(Marble::GeoDataCoordinates(pos.getLonX(), pos.getLatY(), 0, Marble::GeoDataCoordinates::Degree));
+
+    // Ring coordinates are a lot larger than the positions of the line string
+    int cost = std::max(e->lines.size() * static_cast<int>(sizeof(atools::geo::Pos)) +
+                        e->ring.size() * (static_cast<int>(sizeof(Marble::GeoDataCoordinates)) + RING_POINT_BYTES), 1);
+    cache.insert(key, e, cost);
+
+    // Might be deleted immediately if too big
+    e = cache.object(key);
+  }
+  return e;
+}
+
+void AirspaceGeometryCache::clear()
+{
+  cache.clear();
+}
+
+void AirspaceGeometryCache::clear(map::MapAirspaceSources sources)
+{
+  for(const Key& key : cache.keys())
+  {
+    if(key.id.src & sources)
+      cache.remove(key);
+  }
+}
+
+void AirspaceGeometryCache::simplify(atools::geo::LineString& simplified, const atools::geo::LineString& lines,
+                                     float tolerance)
+{
+  simplified.clear();
+
+  int size = lines.size();
+  if(size < 4 || tolerance <= 0.f)
+  {
+    simplified = lines;
+    return;
+  }
+
+  // Scale longitude by average latitude to get an approximately isotropic plane
+  float latSum = 0.f;
+  for(const atools::geo::Pos& pos : lines)
+    latSum += pos.getLatY();
+  float lonScale = std::cos(latSum / size * static_cast<float>(M_PI / 180.));
+
+  QVector<float> x(size), y(size);
+  for(int i = 0; i < size; i++)
+  {
+    x[i] = lines.at(i).getLonX() * lonScale;
+    y[i] = lines.at(i).getLatY();
+  }
+
+  QVector<bool> keep(size, false);
+  keep[0] = keep[size - 1] = true;
+
+  // Split rings at the point farthest from the first to avoid degenerated segments
+  int farthest = 0;
+  float maxDist = -1.f;
+  for(int i = 1; i < size - 1; i++)
+  {
+    float dist = (x.at(i) - x.at(0)) * (x.at(i) - x.at(0)) + (y.at(i) - y.at(0)) * (y.at(i) - y.at(0));
+    if(dist > maxDist)
+    {
+      maxDist = dist;
+      farthest = i;
+    }
+  }
+
+  QVector<std::pair<int, int> > stack;
+  if(farthest > 0)
+  {
+    keep[farthest] = true;
+    stack.append(std::make_pair(0, farthest));
+    stack.append(std::make_pair(farthest, size - 1));
+  }
+  else
+    stack.append(std::make_pair(0, size - 1));
+
+  float toleranceSq = tolerance * tolerance;
+  while(!stack.isEmpty())
+  {
+    std::pair<int, int> range = stack.takeLast();
+    int first = range.first, last = range.second;
+
+    float dx = x.at(last) - x.at(first), dy = y.at(last) - y.at(first);
+    float lenSq = dx * dx + dy * dy;
+
+    // Find point with largest distance to segment first-last
+    int index = -1;
+    float maxDistSq = toleranceSq;
+    for(int i = first + 1; i < last; i++)
+    {
+      float px = x.at(i) - x.at(first), py = y.at(i) - y.at(first);
+      float distSq;
+      if(lenSq > 0.f)
+      {
+        float t = std::min(std::max((px * dx + py * dy) / lenSq, 0.f), 1.f);
+        float ex = px - t * dx, ey = py - t * dy;
+        distSq = ex * ex + ey * ey;
+      }
+      else
+        distSq = px * px + py * py;
+
+      if(distSq > maxDistSq)
+      {
+        maxDistSq = distSq;
+        index = i;
+      }
+    }
+
+    if(index != -1)
+    {
+      keep[index] = true;
+      stack.append(std::make_pair(first, index));
+      stack.append(std::make_pair(index, last));
+    }
+  }
+
+  for(int i = 0; i < size; i++)
+  {
+    if(keep.at(i))
+      simplified.append(lines.at(i));
+  }
+}
@@ -0,0 +1,89 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_AIRSPACEGEOMETRYCACHE_H
+#define LNM_AIRSPACEGEOMETRYCACHE_H
+
+#include "common/mapflags.h"
+#include "geo/linestring.h"
+
+#include <QCache>
+
+#include <marble/GeoDataLinearRing.h>
+
+namespace Marble {
+class ViewportParams;
+}
+
+/*
+ * Multi resolution cache for airspace boundaries.
+ *
+ * Geometry is simplified with the Douglas-Peucker algorithm using a tolerance of about one pixel for each
+ * zoom band. Simplified line strings and prepared Marble rings are kept per airspace and zoom band, so painting and
+ * screen index updates at low zoom touch only a fraction of the vertices.
+ */
+class AirspaceGeometryCache
+{
+public:
+  AirspaceGeometryCache();
+  ~AirspaceGeometryCache();
+
+  /* Get zoom band for viewport. 0 is full resolution. */
+  static int zoomBand(const Marble::ViewportParams *viewport);
+
+  /* Get simplified geometry for zoom band. geometry is the full resolution geometry which is used to build the cache
+   * entry if needed. Returns null if geometry is null. Pointer is valid until the next call. */
+  const atools::geo::LineString *getGeometry(map::MapAirspaceId id, int band, const atools::geo::LineString *geometry);
+
+  /* Same as above but returns a prepared tessellated ring for painting */
+  const Marble::GeoDataLinearRing *getRing(map::MapAirspaceId id, int band, const atools::geo::LineString *geometry);
+
+  /* Remove all entries or entries for the given sources only */
+  void clear();
+  void clear(map::MapAirspaceSources sources);
+
+  /* Douglas-Peucker simplification of a line string or ring. Tolerance is degree. */
+  static void simplify(atools::geo::LineString& simplified, const atools::geo::LineString& lines, float tolerance);
+
+private:
+  struct Key
+  {
+    map::MapAirspaceId id;
+    int band;
+
+    bool operator==(const Key& other) const
+    {
+      return id == other.id && band == other.band;
+    }
+
+  };
+
+  friend uint qHash(const AirspaceGeometryCache::Key& key);
+
+  struct Entry
+  {
+    atools::geo::LineString lines;
+    Marble::GeoDataLinearRing ring;
+  };
+
+  Entry *entry(map::MapAirspaceId id, int band, const atools::geo::LineString *geometry);
+
+  /* Cost is approximate size in bytes of line string and ring */
+  QCache<Key, Entry> cache;
+};
+
+#endif // LNM_AIRSPACEGEOMETRYCACHE_H
@@ -0,0 +1,310 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "airspace/airspaceindex.h"
+
+#include "geo/calculations.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <cmath>
+
+/* Maximum number of children for each R-tree node */
+static const int NODE_SIZE = 16;
+
+/* Get longitude difference in range -180 to 180 */
+inline static float wrapDelta(float delta)
+{
+  while(delta > 180.f)
+    delta -= 360.f;
+  while(delta < -180.f)
+    delta += 360.f;
+  return delta;
+}
+
+AirspaceIndex::AirspaceIndex()
+{
+
+}
+
+AirspaceIndex::~AirspaceIndex()
+{
+
+}
+
+void AirspaceIndex::build(const QVector<map::MapAirspace>& airspacesParam, GeometryFuncType geometryFuncParam)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  clear();
+  airspaces = airspacesParam;
+  geometryFunc = geometryFuncParam;
+
+  for(int i = 0; i < airspaces.size(); i++)
+  {
+    const atools::geo::Rect& rect = airspaces.at(i).bounding;
+    if(!rect.isValid())
+      continue;
+
+    if(rect.crossesAntiMeridian())
+    {
+      // Split into east and west part
+      items.append({{rect.getWest(), rect.getSouth(), 180.f, rect.getNorth()}, i});
+      items.append({{-180.f, rect.getSouth(), rect.getEast(), rect.getNorth()}, i});
+    }
+    else
+      items.append({{rect.getWest(), rect.getSouth(), rect.getEast(), rect.getNorth()}, i});
+  }
+
+  if(items.isEmpty())
+    return;
+
+  // Pack items into leaves
+  sortTileRecursive(items);
+  QVector<Node> level;
+  for(int i = 0; i < items.size(); i += NODE_SIZE)
+  {
+    Node node = {items.at(i).box, i, std::min(NODE_SIZE, items.size() - i), true};
+    for(int j = i + 1; j < node.first + node.count; j++)
+      node.box.extend(items.at(j).box);
+    level.append(node);
+  }
+
+  // Pack nodes of each level into parents until only the root is left
+  while(level.size() > 1)
+  {
+    sortTileRecursive(level);
+    int offset = nodes.size();
+    nodes.append(level);
+
+    QVector<Node> parents;
+    for(int i = 0; i < level.size(); i += NODE_SIZE)
+    {
+      Node node = {level.at(i).box, offset + i, std::min(NODE_SIZE, level.size() - i), false};
+      for(int j = i + 1; j < i + node.count; j++)
+        node.box.extend(level.at(j).box);
+      parents.append(node);
+    }
+    level = parents;
+  }
+
+  root = nodes.size();
+  nodes.append(level.first());
+
+  qDebug() << Q_FUNC_INFO << "airspaces" << airspaces.size() << "items" << items.size() << "nodes" << nodes.size()
+           << timer.elapsed() << "ms";
+}
+
+void AirspaceIndex::clear()
+{
+  airspaces.clear();
+  items.clear();
+  nodes.clear();
+  geometries.clear();
+  geometryFunc = nullptr;
+  root = -1;
+}
+
+template<typename T>
+void AirspaceIndex::sortTileRecursive(QVector<T>& entries)
+{
+  // Sort by x into vertical slices of about sqrt(number of nodes) nodes and each slice by y
+  int numNodes = (entries.size() + NODE_SIZE - 1) / NODE_SIZE;
+  int sliceSize = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numNodes)))) * NODE_SIZE;
+
+  std::sort(entries.begin(), entries.end(), [](const T& e1, const T& e2) -> bool {
+    return e1.box.centerX() < e2.box.centerX();
+  });
+
+  for(int i = 0; i < entries.size(); i += sliceSize)
+  {
+    std::sort(entries.begin() + i, entries.begin() + std::min(i + sliceSize, entries.size()),
+              [](const T& e1, const T& e2) -> bool {
+      return e1.box.centerY() < e2.box.centerY();
+    });
+  }
+}
+
+void AirspaceIndex::search(QVector<int>& result, Box box) const
+{
+  if(root == -1)
+    return;
+
+  QVector<int> stack({root});
+  while(!stack.isEmpty())
+  {
+    const Node& node = nodes.at(stack.takeLast());
+    for(int i = node.first; i < node.first + node.count; i++)
+    {
+      if(node.leaf)
+      {
+        if(items.at(i).box.overlaps(box))
+          result.append(items.at(i).index);
+      }
+      else if(nodes.at(i).box.overlaps(box))
+        stack.append(i);
+    }
+  }
+}
+
+void AirspaceIndex::searchWrapped(QVector<int>& result, const Box& box) const
+{
+  if(box.west < -180.f)
+  {
+    search(result, {-180.f, box.south, box.east, box.north});
+    search(result, {box.west + 360.f, box.south, 180.f, box.north});
+  }
+  else if(box.east > 180.f)
+  {
+    search(result, {box.west, box.south, 180.f, box.north});
+    search(result, {-180.f, box.south, box.east - 360.f, box.north});
+  }
+  else
+    search(result, box);
+
+  // Remove duplicates from anti-meridian splits and keep database order
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+const atools::geo::LineString& AirspaceIndex::geometry(int index)
+{
+  auto it = geometries.find(index);
+  if(it == geometries.end())
+  {
+    const atools::geo::LineString *lines = geometryFunc ? geometryFunc(airspaces.at(index).combinedId()) : nullptr;
+    it = geometries.insert(index, lines != nullptr ? *lines : atools::geo::LineString());
+  }
+  return it.value();
+}
+
+bool AirspaceIndex::atAltitude(int index, float altitudeFt) const
+{
+  const map::MapAirspace& airspace = airspaces.at(index);
+  return altitudeFt >= airspace.minAltitude && altitudeFt <= airspace.maxAltitude;
+}
+
+bool AirspaceIndex::containsPoint(const atools::geo::LineString& polygon, float x, float y)
+{
+  bool inside = false;
+  int size = polygon.size();
+  for(int i = 0, j = size - 1; i < size; j = i++)
+  {
+    float xi = wrapDelta(polygon.at(i).getLonX() - x), yi = polygon.at(i).getLatY();
+    float xj = wrapDelta(polygon.at(j).getLonX() - x), yj = polygon.at(j).getLatY();
+
+    // Count edges crossing the ray from the point to the east
+    if((yi > y) != (yj > y) && 0.f < (xj - xi) * (y - yi) / (yj - yi) + xi)
+      inside = !inside;
+  }
+  return inside;
+}
+
+void AirspaceIndex::getAirspacesAt(QVector<const map::MapAirspace *>& result, const atools::geo::Pos& pos,
+                                   float altitudeFt)
+{
+  result.clear();
+  if(root == -1 || !pos.isValid())
+    return;
+
+  float x = pos.getLonX(), y = pos.getLatY();
+  QVector<int> candidates;
+  searchWrapped(candidates, {x, y, x, y});
+
+  for(int index : candidates)
+  {
+    if(atAltitude(index, altitudeFt) && containsPoint(geometry(index), x, y))
+      result.append(&airspaces.at(index));
+  }
+}
+
+void AirspaceIndex::getCrossings(QVector<AirspaceCrossing>& crossings, const atools::geo::LineString& line,
+                                 float altitudeFt)
+{
+  crossings.clear();
+  if(root == -1 || line.size() < 2)
+    return;
+
+  float distanceNm = 0.f;
+  QVector<int> candidates;
+  QVector<float> params;
+  for(int i = 0; i < line.size() - 1; i++)
+  {
+    const atools::geo::Pos& p1 = line.at(i), & p2 = line.at(i + 1);
+    if(!p1.isValid() || !p2.isValid())
+      continue;
+
+    // Segment relative to the first point
+    float x1 = p1.getLonX(), y1 = p1.getLatY();
+    float dx = wrapDelta(p2.getLonX() - x1), dy = p2.getLatY() - y1;
+    float lengthNm = atools::geo::meterToNm(p1.distanceMeterTo(p2));
+
+    candidates.clear();
+    searchWrapped(candidates, {std::min(x1, x1 + dx), std::min(y1, y1 + dy),
+                               std::max(x1, x1 + dx), std::max(y1, y1 + dy)});
+
+    for(int index : candidates)
+    {
+      if(!atAltitude(index, altitudeFt))
+        continue;
+
+      const atools::geo::LineString& polygon = geometry(index);
+      int size = polygon.size();
+      if(size < 3)
+        continue;
+
+      // Collect intersections of segment with all polygon edges as fraction of the segment
+      params.clear();
+      for(int j = 0; j < size; j++)
+      {
+        const atools::geo::Pos& e1 = polygon.at(j), & e2 = polygon.at((j + 1) % size);
+        float ax = wrapDelta(e1.getLonX() - x1), ay = e1.getLatY() - y1;
+        float ex = wrapDelta(e2.getLonX() - e1.getLonX()), ey = e2.getLatY() - e1.getLatY();
+
+        float denom = dx * ey - dy * ex;
+        if(std::abs(denom) < 1.e-9f)
+          // Parallel or degenerated edge
+          continue;
+
+        float t = (ax * ey - ay * ex) / denom, u = (ax * dy - ay * dx) / denom;
+        if(t >= 0.f && t < 1.f && u >= 0.f && u < 1.f)
+          params.append(t);
+      }
+
+      if(params.isEmpty())
+        continue;
+
+      // Each intersection toggles the state starting from the state at the first point
+      std::sort(params.begin(), params.end());
+      bool inside = containsPoint(polygon, x1, y1);
+      for(float t : params)
+      {
+        inside = !inside;
+        atools::geo::Pos pos(wrapDelta(x1 + t * dx), y1 + t * dy);
+        crossings.append({airspaces.at(index), distanceNm + t * lengthNm, pos, inside});
+      }
+    }
+    distanceNm += lengthNm;
+  }
+
+  std::stable_sort(crossings.begin(), crossings.end(), [](const AirspaceCrossing& c1,
+                                                          const AirspaceCrossing& c2) -> bool {
+    return c1.distanceNm < c2.distanceNm;
+  });
+}
@@ -0,0 +1,149 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_AIRSPACEINDEX_H
+#define LNM_AIRSPACEINDEX_H
+
+#include "common/maptypes.h"
+#include "geo/linestring.h"
+
+#include <algorithm>
+#include <functional>
+
+/* Airspace boundary crossed by a line */
+struct AirspaceCrossing
+{
+  map::MapAirspace airspace;
+  float distanceNm; /* Distance from start of the line */
+  atools::geo::Pos pos;
+  bool entry; /* true if entering, false if leaving the airspace */
+};
+
+/*
+ * In memory spatial index for geographic airspace lookups.
+ *
+ * Bounding rectangles are kept in a packed R-tree which is built once with the sort-tile-recursive algorithm.
+ * Candidates from the tree are checked with an exact point in polygon test. Boundaries are fetched once through
+ * the geometry callback and kept in the index, so lookups for each simulator update do not run any SQL.
+ *
+ * Polygons are handled in a plane of degrees with longitudes unwrapped relative to the tested position which is
+ * sufficient for the size of airspaces and works across the anti-meridian.
+ */
+class AirspaceIndex
+{
+public:
+  /* Returns full resolution geometry for airspace or null if not found */
+  typedef std::function<const atools::geo::LineString *(map::MapAirspaceId id)> GeometryFuncType;
+
+  AirspaceIndex();
+  ~AirspaceIndex();
+
+  /* Build index from airspaces. Geometry is not needed in the given objects and is loaded on demand. */
+  void build(const QVector<map::MapAirspace>& airspacesParam, GeometryFuncType geometryFuncParam);
+  void clear();
+
+  bool isEmpty() const
+  {
+    return airspaces.isEmpty();
+  }
+
+  int size() const
+  {
+    return airspaces.size();
+  }
+
+  /* Get all airspaces containing the position at the given altitude in feet.
+   * Pointers are valid until the index is rebuilt. */
+  void getAirspacesAt(QVector<const map::MapAirspace *>& result, const atools::geo::Pos& pos, float altitudeFt);
+
+  /* Get all entries and exits of airspaces along line at the given altitude in feet sorted by distance from
+   * start of line. Airspaces containing the first point are only reported when leaving. */
+  void getCrossings(QVector<AirspaceCrossing>& crossings, const atools::geo::LineString& line, float altitudeFt);
+
+private:
+  struct Box
+  {
+    float west, south, east, north;
+
+    bool overlaps(const Box& other) const
+    {
+      return !(other.east < west || other.west > east || other.north < south || other.south > north);
+    }
+
+    void extend(const Box& other)
+    {
+      west = std::min(west, other.west);
+      south = std::min(south, other.south);
+      east = std::max(east, other.east);
+      north = std::max(north, other.north);
+    }
+
+    float centerX() const
+    {
+      return (west + east) / 2.f;
+    }
+
+    float centerY() const
+    {
+      return (south + north) / 2.f;
+    }
+
+  };
+
+  /* Leaf entry. Airspaces crossing the anti-meridian have two entries. */
+  struct Item
+  {
+    Box box;
+    int index; /* Index into airspaces */
+  };
+
+  /* Children are items for leaves or nodes otherwise. Children are stored consecutively. */
+  struct Node
+  {
+    Box box;
+    int first, count;
+    bool leaf;
+  };
+
+  /* Sort entries into tiles for packing - T needs a box member */
+  template<typename T>
+  static void sortTileRecursive(QVector<T>& entries);
+
+  /* Collect indexes of airspaces whose bounding rectangle overlaps box */
+  void search(QVector<int>& result, Box box) const;
+
+  /* Search and remove duplicates from anti-meridian splits. Box can exceed -180 or 180 degree longitude. */
+  void searchWrapped(QVector<int>& result, const Box& box) const;
+
+  /* Get cached geometry for airspace index */
+  const atools::geo::LineString& geometry(int index);
+
+  bool atAltitude(int index, float altitudeFt) const;
+
+  /* Even-odd rule with polygon longitudes unwrapped relative to x */
+  static bool containsPoint(const atools::geo::LineString& polygon, float x, float y);
+
+  QVector<map::MapAirspace> airspaces;
+  QVector<Item> items;
+  QVector<Node> nodes;
+  int root = -1;
+
+  QHash<int, atools::geo::LineString> geometries;
+  GeometryFuncType geometryFunc;
+};
+
+#endif // LNM_AIRSPACEINDEX_H
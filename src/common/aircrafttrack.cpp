@@ -25,9 +25,71 @@
 #include <QDateTime>
 #include <QFile>
 
-AircraftTrack::AircraftTrack()
+#include <cmath>
+
+/* Fixed point factor for coordinates. Gives about 0.1 meter resolution. */
+static const double COORD_FACTOR = 1000000.;
+
+/* Zigzag encoding maps small negative numbers to small positive numbers */
+static quint64 zigzag(qint64 value)
+{
+  return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+static qint64 unzigzag(quint64 value)
+{
+  return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+/* Write value using seven bits per byte with the high bit indicating that more bytes follow */
+static void writeVarint(QDataStream& out, quint64 value)
+{
+  while(value >= 0x80)
+  {
+    out << static_cast<quint8>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out << static_cast<quint8>(value);
+}
+
+static quint64 readVarint(QDataStream& in)
+{
+  quint64 value = 0;
+  for(int shift = 0; shift < 64 && in.status() == QDataStream::Ok; shift += 7)
+  {
+    quint8 byte = 0;
+    in >> byte;
+    value |= static_cast<quint64>(byte & 0x7f) << shift;
+    if(!(byte & 0x80))
+      break;
+  }
+  return value;
+}
+
+/* Approximate distance of point p from segment a-b in nautical miles using an equirectangular projection.
+ * Good enough for the short segments used in track simplification. */
+static float segmentDistanceNm(const atools::geo::Pos& p, const atools::geo::Pos& a, const atools::geo::Pos& b)
 {
+  float cosLat = std::cos(atools::geo::toRadians(a.getLatY()));
+  float px = (p.getLonX() - a.getLonX()) * cosLat * 60.f, py = (p.getLatY() - a.getLatY()) * 60.f;
+  float bx = (b.getLonX() - a.getLonX()) * cosLat * 60.f, by = (b.getLatY() - a.getLatY()) * 60.f;
 
+  float lenSq = bx * bx + by * by;
+  float t = lenSq > 0.f ? std::max(0.f, std::min(1.f, (px * bx + py * by) / lenSq)) : 0.f;
+  float dx = px - t * bx, dy = py - t * by;
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+AircraftTrack::AircraftTrack()
+{
+  float tolerance = TRACK_LEVEL_MIN_TOLERANCE_NM;
+  for(int i = 0; i < NUM_TRACK_LEVELS; i++)
+  {
+    TrackLevel level;
+    level.toleranceNm = tolerance;
+    levels.append(level);
+    tolerance *= 4.f;
+  }
 }
 
 AircraftTrack::~AircraftTrack()
@@ -51,23 +113,244 @@ QDataStream& operator<<(QDataStream& dataStream, const at::AircraftTrackPos& tra
 
 }
 
+void AircraftTrack::clearTrack()
+{
+  lonX.clear();
+  latY.clear();
+  altitude.clear();
+  timestamps.clear();
+  groundFlags.clear();
+  head = numEntries = savedEntries = prunedFileEntries = writtenPrunedEntries = 0;
+  firstSequence = 0;
+  rewriteFile = true;
+  clearLevels();
+}
+
+void AircraftTrack::setMaxTrackEntries(int value)
+{
+  maxTrackEntries = std::max(value, 1);
+
+  if(numEntries > maxTrackEntries)
+    removeOldest(numEntries - maxTrackEntries);
+
+  // Compact storage to allow growing or shrinking
+  linearize();
+}
+
+void AircraftTrack::appendInternal(const atools::geo::Pos& pos, quint32 timestamp, bool ground)
+{
+  if(numEntries == lonX.size())
+  {
+    // Storage is full but below maximum - grow at the end. head is always 0 here. See linearize()
+    lonX.append(pos.getLonX());
+    latY.append(pos.getLatY());
+    altitude.append(pos.getAltitude());
+    timestamps.append(timestamp);
+    groundFlags.append(ground);
+  }
+  else
+  {
+    // Overwrite a free slot in the ring buffer
+    int idx = physicalIndex(numEntries);
+    lonX[idx] = pos.getLonX();
+    latY[idx] = pos.getLatY();
+    altitude[idx] = pos.getAltitude();
+    timestamps[idx] = timestamp;
+    groundFlags[idx] = ground;
+  }
+  numEntries++;
+
+  updateLevels(firstSequence + numEntries - 1);
+}
+
+void AircraftTrack::removeOldest(int num)
+{
+  num = std::min(num, numEntries);
+  if(num > 0)
+  {
+    head = (head + num) % lonX.size();
+    numEntries -= num;
+    firstSequence += num;
+    trimLevels();
+
+    // Leave removed entries in the file since they are skipped on reading - compact only occasionally
+    prunedFileEntries += std::min(num, savedEntries);
+    savedEntries = std::max(savedEntries - num, 0);
+    if(prunedFileEntries > maxTrackEntries)
+      rewriteFile = true;
+  }
+}
+
+void AircraftTrack::updateLevels(qint64 sequence)
+{
+  atools::geo::Pos pos = getPos(static_cast<int>(sequence - firstSequence));
+
+  for(TrackLevel& level : levels)
+  {
+    if(level.sequences.isEmpty())
+    {
+      // First position is always kept
+      level.sequences.append(sequence);
+      level.anchor = sequence;
+      level.pending.clear();
+      continue;
+    }
+
+    // Check if line from anchor to new position still covers all undecided positions
+    bool keepLast = level.pending.size() >= MAX_TRACK_LEVEL_PENDING;
+    if(!keepLast)
+    {
+      atools::geo::Pos anchorPos = getPos(static_cast<int>(level.anchor - firstSequence));
+      for(qint64 pendingSeq : level.pending)
+      {
+        if(segmentDistanceNm(getPos(static_cast<int>(pendingSeq - firstSequence)), anchorPos, pos) >
+           level.toleranceNm)
+        {
+          keepLast = true;
+          break;
+        }
+      }
+    }
+
+    if(keepLast && !level.pending.isEmpty())
+    {
+      // Keep previous position and use it as new anchor
+      level.anchor = level.pending.last();
+      level.sequences.append(level.anchor);
+      level.pending.clear();
+    }
+    level.pending.append(sequence);
+  }
+}
+
+void AircraftTrack::trimLevels()
+{
+  for(TrackLevel& level : levels)
+  {
+    while(!level.sequences.isEmpty() && level.sequences.first() < firstSequence)
+      level.sequences.removeFirst();
+
+    if(numEntries > 0 && (level.sequences.isEmpty() || level.sequences.first() != firstSequence))
+      // Oldest remaining position is always kept
+      level.sequences.prepend(firstSequence);
+
+    level.anchor = std::max(level.anchor, firstSequence);
+
+    int numRemove = 0;
+    while(numRemove < level.pending.size() && level.pending.at(numRemove) <= level.anchor)
+      numRemove++;
+    level.pending.remove(0, numRemove);
+  }
+}
+
+void AircraftTrack::clearLevels()
+{
+  for(TrackLevel& level : levels)
+  {
+    level.sequences.clear();
+    level.pending.clear();
+    level.anchor = -1;
+  }
+}
+
+void AircraftTrack::getSimplifiedIndexes(float toleranceNm, QVector<int>& indexes) const
+{
+  indexes.clear();
+
+  // Find coarsest level within tolerance
+  const TrackLevel *found = nullptr;
+  for(const TrackLevel& level : levels)
+  {
+    if(level.toleranceNm <= toleranceNm)
+      found = &level;
+  }
+
+  if(found == nullptr)
+  {
+    // Zoomed in closely - use all positions
+    indexes.reserve(numEntries);
+    for(int i = 0; i < numEntries; i++)
+      indexes.append(i);
+  }
+  else
+  {
+    indexes.reserve(found->sequences.size() + 1);
+    for(qint64 sequence : found->sequences)
+      indexes.append(static_cast<int>(sequence - firstSequence));
+
+    // Add current position which is not decided yet
+    if(numEntries > 0 && (indexes.isEmpty() || indexes.last() != numEntries - 1))
+      indexes.append(numEntries - 1);
+  }
+}
+
+void AircraftTrack::linearize()
+{
+  if(head == 0 && numEntries == lonX.size())
+    return;
+
+  QVector<float> newLonX, newLatY, newAltitude;
+  QVector<quint32> newTimestamps;
+  QVector<bool> newOnGround;
+  newLonX.reserve(numEntries);
+  newLatY.reserve(numEntries);
+  newAltitude.reserve(numEntries);
+  newTimestamps.reserve(numEntries);
+  newOnGround.reserve(numEntries);
+
+  for(int i = 0; i < numEntries; i++)
+  {
+    int idx = physicalIndex(i);
+    newLonX.append(lonX.at(idx));
+    newLatY.append(latY.at(idx));
+    newAltitude.append(altitude.at(idx));
+    newTimestamps.append(timestamps.at(idx));
+    newOnGround.append(groundFlags.at(idx));
+  }
+
+  lonX.swap(newLonX);
+  latY.swap(newLatY);
+  altitude.swap(newAltitude);
+  timestamps.swap(newTimestamps);
+  groundFlags.swap(newOnGround);
+  head = 0;
+}
+
 void AircraftTrack::saveState()
 {
   QFile trackFile(atools::settings::Settings::getConfigFilename(".track"));
 
-  if(trackFile.open(QIODevice::WriteOnly))
+  if(!rewriteFile && trackFile.exists() && savedEntries <= numEntries)
   {
-    QDataStream out(&trackFile);
-    saveToStream(out);
-    trackFile.close();
+    // Append only new positions or changed number of pruned positions to existing file
+    if(savedEntries < numEntries || writtenPrunedEntries != prunedFileEntries)
+    {
+      if(trackFile.open(QIODevice::WriteOnly | QIODevice::Append))
+      {
+        QDataStream out(&trackFile);
+        appendToStream(out);
+        trackFile.close();
+      }
+      else
+        qWarning() << "Cannot append track" << trackFile.fileName() << ":" << trackFile.errorString();
+    }
   }
   else
-    qWarning() << "Cannot write track" << trackFile.fileName() << ":" << trackFile.errorString();
+  {
+    if(trackFile.open(QIODevice::WriteOnly))
+    {
+      QDataStream out(&trackFile);
+      saveToStream(out);
+      trackFile.close();
+    }
+    else
+      qWarning() << "Cannot write track" << trackFile.fileName() << ":" << trackFile.errorString();
+  }
 }
 
 void AircraftTrack::restoreState()
 {
-  clear();
+  clearTrack();
 
   QFile trackFile(atools::settings::Settings::getConfigFilename(".track"));
   if(trackFile.exists())
@@ -86,14 +369,105 @@ void AircraftTrack::restoreState()
 void AircraftTrack::saveToStream(QDataStream& out)
 {
   out.setVersion(QDataStream::Qt_5_5);
-  out.setFloatingPointPrecision(QDataStream::SinglePrecision);
-  out << FILE_MAGIC_NUMBER << FILE_VERSION << *this;
+  out << FILE_MAGIC_NUMBER << FILE_VERSION;
+
+  // File contains only the current positions
+  prunedFileEntries = 0;
+  writeBlock(out, 0);
+
+  savedEntries = numEntries;
+  rewriteFile = false;
+}
+
+void AircraftTrack::appendToStream(QDataStream& out)
+{
+  out.setVersion(QDataStream::Qt_5_5);
+  writeBlock(out, savedEntries);
+  savedEntries = numEntries;
+}
+
+void AircraftTrack::writeBlock(QDataStream& out, int from)
+{
+  // Number of pruned positions is written with each block since pruning can happen between saves
+  out << FILE_BLOCK_MARKER;
+  writeVarint(out, static_cast<quint64>(prunedFileEntries));
+  writeVarint(out, static_cast<quint64>(numEntries - from));
+  writtenPrunedEntries = prunedFileEntries;
+
+  // Each block starts with absolute values
+  qint64 lastLonX = 0, lastLatY = 0, lastAlt = 0, lastTime = 0;
+  for(int i = from; i < numEntries; i++)
+  {
+    int idx = physicalIndex(i);
+    qint64 lon = qRound64(lonX.at(idx) * COORD_FACTOR), lat = qRound64(latY.at(idx) * COORD_FACTOR),
+           alt = qRound64(altitude.at(idx)), time = timestamps.at(idx);
+
+    writeVarint(out, zigzag(lon - lastLonX));
+    writeVarint(out, zigzag(lat - lastLatY));
+    writeVarint(out, zigzag(alt - lastAlt));
+
+    // Ground flag is stored in lowest bit of time difference
+    writeVarint(out, (zigzag(time - lastTime) << 1) | (groundFlags.at(idx) ? 1 : 0));
+
+    lastLonX = lon;
+    lastLatY = lat;
+    lastAlt = alt;
+    lastTime = time;
+  }
+}
+
+bool AircraftTrack::readBlocks(QDataStream& in, QVector<at::AircraftTrackPos>& positions, int& prunedEntries)
+{
+  while(!in.atEnd())
+  {
+    quint8 marker = 0;
+    in >> marker;
+    if(marker != FILE_BLOCK_MARKER)
+    {
+      qWarning() << "Cannot read track. Invalid block marker:" << marker;
+      return false;
+    }
+
+    quint64 pruned = readVarint(in);
+    quint64 num = readVarint(in);
+    if(in.status() != QDataStream::Ok)
+    {
+      qWarning() << "Cannot read track. Truncated block header";
+      return false;
+    }
+
+    // Last block has the valid number
+    prunedEntries = static_cast<int>(pruned);
+
+    qint64 lastLonX = 0, lastLatY = 0, lastAlt = 0, lastTime = 0;
+    for(quint64 i = 0; i < num; i++)
+    {
+      lastLonX += unzigzag(readVarint(in));
+      lastLatY += unzigzag(readVarint(in));
+      lastAlt += unzigzag(readVarint(in));
+      quint64 timeGround = readVarint(in);
+      lastTime += unzigzag(timeGround >> 1);
+
+      if(in.status() != QDataStream::Ok)
+      {
+        // Truncated block - for example after a crash while saving
+        qWarning() << "Cannot read track. Truncated block";
+        return false;
+      }
+
+      positions.append({atools::geo::Pos(static_cast<float>(lastLonX / COORD_FACTOR),
+                                         static_cast<float>(lastLatY / COORD_FACTOR),
+                                         static_cast<float>(lastAlt)),
+                        static_cast<quint32>(lastTime), (timeGround & 1) != 0});
+    }
+  }
+  return true;
 }
 
 bool AircraftTrack::readFromStream(QDataStream& in)
 {
   bool retval = false;
-  clear();
+  clearTrack();
 
   quint32 magic;
   quint16 version;
@@ -104,13 +478,38 @@ bool AircraftTrack::readFromStream(QDataStream& in)
   if(magic == FILE_MAGIC_NUMBER)
   {
     in >> version;
+    QVector<at::AircraftTrackPos> positions;
+    bool complete = false;
+    int filePrunedEntries = 0;
     if(version == FILE_VERSION)
     {
-      in >> *this;
+      complete = readBlocks(in, positions, filePrunedEntries);
+      retval = true;
+    }
+    else if(version == FILE_VERSION_LIST)
+    {
+      // Old format - whole list written by QDataStream. Rewritten in new format on next save.
+      QList<at::AircraftTrackPos> list;
+      in >> list;
+      positions = list.toVector();
       retval = true;
     }
     else
       qWarning() << "Cannot read track. Invalid version number:" << version;
+
+    // Skip entries pruned before saving and keep only the newest entries if file exceeds the limit
+    int first = std::max(std::min(filePrunedEntries, positions.size()), positions.size() - maxTrackEntries);
+    for(int i = first; i < positions.size(); i++)
+    {
+      const at::AircraftTrackPos& trackPos = positions.at(i);
+      appendInternal(trackPos.pos, trackPos.timestamp, trackPos.onGround);
+    }
+
+    // File can be appended to if it was read completely and does not contain too many dropped entries
+    prunedFileEntries = positions.size() - numEntries;
+    writtenPrunedEntries = filePrunedEntries;
+    rewriteFile = !complete || prunedFileEntries > maxTrackEntries;
+    savedEntries = rewriteFile ? 0 : numEntries;
   }
   else
     qWarning() << "Cannot read track. Invalid magic number:" << magic;
@@ -126,29 +525,28 @@ bool AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, const QDateTime&
   long timeDiff = onGround ? MIN_POSITION_TIME_DIFF_GROUND_MS : MIN_POSITION_TIME_DIFF_MS;
 
   if(isEmpty())
-    append({pos, timestamp.toTime_t(), onGround});
+    appendInternal(pos, timestamp.toTime_t(), onGround);
   else
   {
     long time = timestamp.toMSecsSinceEpoch();
-    long lastTime = last().timestamp * 1000L;
+    int lastIdx = physicalIndex(numEntries - 1);
+    long lastTime = timestamps.at(lastIdx) * 1000L;
+    atools::geo::Pos lastPos = getPosInternal(lastIdx);
 
-    if(!pos.almostEqual(last().pos, epsilon) && !atools::almostEqual(lastTime, time, timeDiff))
+    if(!pos.almostEqual(lastPos, epsilon) && !atools::almostEqual(lastTime, time, timeDiff))
     {
-      if(pos.distanceMeterTo(last().pos) > atools::geo::nmToMeter(MAX_POINT_DISTANCE_NM))
+      if(pos.distanceMeterTo(lastPos) > atools::geo::nmToMeter(MAX_POINT_DISTANCE_NM))
       {
-        clear();
+        clearTrack();
         pruned = true;
       }
-      else
+      else if(numEntries >= maxTrackEntries)
       {
-        if(size() > maxTrackEntries)
-        {
-          for(int i = 0; i < PRUNE_TRACK_ENTRIES; i++)
-            removeFirst();
-          pruned = true;
-        }
+        // Moves only the head of the ring buffer
+        removeOldest(PRUNE_TRACK_ENTRIES);
+        pruned = true;
       }
-      append({pos, timestamp.toTime_t(), onGround});
+      appendInternal(pos, timestamp.toTime_t(), onGround);
     }
   }
   return pruned;
@@ -157,7 +555,7 @@ bool AircraftTrack::appendTrackPos(const atools::geo::Pos& pos, const QDateTime&
 float AircraftTrack::getMaxAltitude() const
 {
   float maxAlt = 0.f;
-  for(const at::AircraftTrackPos& trackPos : *this)
-    maxAlt = std::max(maxAlt, trackPos.pos.getAltitude());
+  for(int i = 0; i < numEntries; i++)
+    maxAlt = std::max(maxAlt, altitude.at(physicalIndex(i)));
   return maxAlt;
 }
@@ -20,6 +20,8 @@
 
 #include "geo/pos.h"
 
+#include <QVector>
+
 namespace at {
 /* Track position. Can be converted to QVariant and thus be saved to settings */
 struct AircraftTrackPos
@@ -38,23 +40,66 @@ Q_DECLARE_TYPEINFO(at::AircraftTrackPos, Q_PRIMITIVE_TYPE);
 Q_DECLARE_METATYPE(at::AircraftTrackPos);
 
 /*
- * Stores the track of the flight simulator aircraft
+ * Stores the track of the flight simulator aircraft.
+ *
+ * Positions are kept in a ring buffer with one array per column (structure of arrays).
+ * Removing the oldest entries when exceeding the maximum size is therefore O(1).
+ *
+ * The track file uses an append only format where each save adds a block containing only the new positions.
+ * Positions are delta and variable length encoded. Pruned positions are left in the file and skipped when reading.
+ * Each block contains the number of pruned positions at the start of the file at the time of writing.
+ * The file is rewritten completely only if the track was cleared or the number of pruned positions in the file
+ * exceeds the maximum number of track entries.
+ *
+ * A simplified representation with several levels of detail is updated incrementally when adding positions.
+ * This allows painting to use a number of points depending on screen resolution and not on track length.
  */
-class AircraftTrack :
-  private QList<at::AircraftTrackPos>
+class AircraftTrack
 {
 public:
   AircraftTrack();
   ~AircraftTrack();
 
+  /* Iterates over positions in chronological order. Dereferencing returns a copy. */
+  class const_iterator
+  {
+public:
+    const_iterator(const AircraftTrack *trackParam, int indexParam)
+      : track(trackParam), index(indexParam)
+    {
+    }
+
+    at::AircraftTrackPos operator*() const
+    {
+      return track->at(index);
+    }
+
+    const_iterator& operator++()
+    {
+      index++;
+      return *this;
+    }
+
+    bool operator==(const const_iterator& other) const
+    {
+      return track == other.track && index == other.index;
+    }
+
+    bool operator!=(const const_iterator& other) const
+    {
+      return !(*this == other);
+    }
+
+private:
+    const AircraftTrack *track;
+    int index;
+  };
+
   /* Saves and restores track into a separate file (little_navmap.track) */
   void saveState();
   void restoreState();
 
-  void clearTrack()
-  {
-    clear();
-  }
+  void clearTrack();
 
   /*
    * Add a track position. Accurracy depends on the ground flag which will cause more
@@ -65,32 +110,152 @@ public:
 
   float getMaxAltitude() const;
 
-  /* Pull only needed methods into public space */
-  using QList::isEmpty;
-  using QList::first;
-  using QList::last;
-  using QList::size;
-  using QList::at;
-  using QList::begin;
-  using QList::end;
+  bool isEmpty() const
+  {
+    return numEntries == 0;
+  }
 
-  /* Track will be pruned if it contains more track entries than this value. Default is 20000. */
-  void setMaxTrackEntries(int value)
+  int size() const
+  {
+    return numEntries;
+  }
+
+  /* Get position at index where 0 is the oldest */
+  at::AircraftTrackPos at(int i) const
+  {
+    int idx = physicalIndex(i);
+    return {getPosInternal(idx), timestamps.at(idx), groundFlags.at(idx)};
+  }
+
+  /* Position only. Cheaper than at() */
+  atools::geo::Pos getPos(int i) const
+  {
+    return getPosInternal(physicalIndex(i));
+  }
+
+  at::AircraftTrackPos first() const
+  {
+    return at(0);
+  }
+
+  at::AircraftTrackPos last() const
+  {
+    return at(numEntries - 1);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator end() const
   {
-    maxTrackEntries = value;
+    return const_iterator(this, numEntries);
   }
 
+  /* Get indexes of a simplified track where no dropped position deviates more than toleranceNm from
+   * the lines between remaining positions. Contains all indexes if tolerance is smaller than the finest level.
+   * First and last index are always included. */
+  void getSimplifiedIndexes(float toleranceNm, QVector<int>& indexes) const;
+
+  /* Track will be pruned if it contains more track entries than this value. Default is 20000. */
+  void setMaxTrackEntries(int value);
+
   /* Write and read the whole track to and from a binary stream */
   void saveToStream(QDataStream& out);
 
+  /* Append a block with positions added since the last write and the current number of pruned
+   * positions to a stream created by saveToStream() */
+  void appendToStream(QDataStream& out);
+
   bool readFromStream(QDataStream & in);
 
 private:
+  int physicalIndex(int i) const
+  {
+    return (head + i) % lonX.size();
+  }
+
+  atools::geo::Pos getPosInternal(int idx) const
+  {
+    return atools::geo::Pos(lonX.at(idx), latY.at(idx), altitude.at(idx));
+  }
+
+  /* Add to end of ring buffer. Buffer has to have space left. */
+  void appendInternal(const atools::geo::Pos& pos, quint32 timestamp, bool ground);
+
+  /* Remove number of oldest entries */
+  void removeOldest(int num);
+
+  /* Copy entries into new storage in chronological order with head at 0 */
+  void linearize();
+
+  /* Level of detail for track simplification. Sequence numbers count all positions ever added and
+   * are independent of the ring buffer position. */
+  struct TrackLevel
+  {
+    float toleranceNm;
+
+    /* Sequence numbers of kept positions in ascending order */
+    QList<qint64> sequences;
+
+    /* Last kept position and positions after it which are not decided yet */
+    qint64 anchor = -1;
+    QVector<qint64> pending;
+  };
+
+  /* Add position with sequence number to all levels */
+  void updateLevels(qint64 sequence);
+
+  /* Remove sequence numbers of positions dropped from the ring buffer */
+  void trimLevels();
+  void clearLevels();
+
+  /* Write number of pruned positions and delta encoded positions from index from to the end of the track */
+  void writeBlock(QDataStream& out, int from);
+
+  /* Read format version 3 blocks. prunedEntries is set to the number of pruned positions from the last block.
+   * Returns false if a truncated or corrupt block was found. */
+  bool readBlocks(QDataStream& in, QVector<at::AircraftTrackPos>& positions, int& prunedEntries);
+
+  /* Column storage. All have the same size which is the capacity actually used. */
+  QVector<float> lonX, latY, altitude;
+  QVector<quint32> timestamps;
+  QVector<bool> groundFlags;
+
+  /* Physical index of the oldest entry and number of valid entries */
+  int head = 0, numEntries = 0;
+
+  /* Sequence number of the oldest entry */
+  qint64 firstSequence = 0;
+
+  QVector<TrackLevel> levels;
+
+  /* Number of entries (counted from the oldest) which are already saved in the track file */
+  int savedEntries = 0;
+
+  /* Number of positions in the track file which were already pruned from the track */
+  int prunedFileEntries = 0;
+
+  /* Value of prunedFileEntries written with the last block */
+  int writtenPrunedEntries = 0;
+
+  /* Track file has to be rewritten completely on next save since it was cleared or contains too many
+   * pruned entries */
+  bool rewriteFile = true;
+
   /* Maximum number of track points. If exceeded entries will be removed from beginning of the list */
   int maxTrackEntries = 20000;
   /* Number of entries to remove at once */
   static Q_DECL_CONSTEXPR int PRUNE_TRACK_ENTRIES = 200;
 
+  /* Number of simplified levels. Tolerance starts at the given value and is multiplied by four for each level. */
+  static Q_DECL_CONSTEXPR int NUM_TRACK_LEVELS = 8;
+  static Q_DECL_CONSTEXPR float TRACK_LEVEL_MIN_TOLERANCE_NM = 0.01f;
+
+  /* Keep a position if this number of undecided positions is reached to limit cost */
+  static Q_DECL_CONSTEXPR int MAX_TRACK_LEVEL_PENDING = 64;
+
   /* Minimum time difference between recordings */
   static Q_DECL_CONSTEXPR int MIN_POSITION_TIME_DIFF_MS = 1000;
   static Q_DECL_CONSTEXPR int MIN_POSITION_TIME_DIFF_GROUND_MS = 250;
@@ -100,8 +265,13 @@ private:
 
   static Q_DECL_CONSTEXPR quint32 FILE_MAGIC_NUMBER = 0x5B6C1A2B;
 
-  /* Version 2 to adds timstamp and single floating point precision */
-  static Q_DECL_CONSTEXPR quint16 FILE_VERSION = 2;
+  /* Version 2 to adds timstamp and single floating point precision.
+   * Version 3 uses append only blocks of delta encoded positions. */
+  static Q_DECL_CONSTEXPR quint16 FILE_VERSION_LIST = 2;
+  static Q_DECL_CONSTEXPR quint16 FILE_VERSION = 3;
+
+  /* Marks the start of a block in version 3 files */
+  static Q_DECL_CONSTEXPR quint8 FILE_BLOCK_MARKER = 0xB7;
 };
 
 #endif // LITTLENAVMAP_AIRCRAFTTRACK_H
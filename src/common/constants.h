@@ -166,6 +166,8 @@ const QLatin1Literal HOLD_DIALOG("Route/HoldDialog");
 const QLatin1Literal HOLD_DIALOG_COLOR("Route/HoldDialogColor");
 const QLatin1Literal CUSTOM_PROCEDURE_DIALOG("Route/CustomProcedureDialog");
 const QLatin1Literal ROUTE_CALC_DIALOG("Route/RouteCalcDialog");
+const QLatin1Literal ROUTE_CALC_TIMEOUT_SECONDS("Route/RouteCalcTimeoutSeconds");
+const QLatin1Literal ROUTE_CALC_NUM_ALTERNATIVES("Route/RouteCalcNumAlternatives");
 const QLatin1Literal SEARCHTAB_AIRPORT_WIDGET("SearchPaneAirport/Widget");
 const QLatin1Literal SEARCHTAB_WIDGET_TABS("SearchPaneAirport/WidgetTabs");
 const QLatin1Literal SEARCHTAB_NAV_WIDGET("SearchPaneNav/Widget");
@@ -254,14 +256,26 @@ const QLatin1Literal OPTIONS_FONT_PIXEL_SIZE("Options/GuiFontPixelSize");
 const QLatin1Literal OPTIONS_FONT_FILE("Options/GuiFontFile");
 const QLatin1Literal OPTIONS_MARBLE_DEBUG("Options/MarbleDebug");
 const QLatin1Literal OPTIONS_CONNECTCLIENT_DEBUG("Options/ConnectClientDebug");
+const QLatin1Literal OPTIONS_CONNECTCLIENT_RECORD_FILE("Options/ConnectClientRecordFile");
+const QLatin1Literal OPTIONS_CONNECTCLIENT_REPLAY_FILE("Options/ConnectClientReplayFile");
+const QLatin1Literal OPTIONS_CONNECTCLIENT_REPLAY_SPEED("Options/ConnectClientReplaySpeed");
+const QLatin1Literal OPTIONS_CONNECTCLIENT_REPLAY_QUIT("Options/ConnectClientReplayQuit");
+const QLatin1Literal OPTIONS_TRAFFIC_GENERATOR_AIRCRAFT("Options/TrafficGeneratorAircraft");
+const QLatin1Literal OPTIONS_TRAFFIC_GENERATOR_PORT("Options/TrafficGeneratorPort");
+const QLatin1Literal OPTIONS_TRAFFIC_GENERATOR_UPDATE_MS("Options/TrafficGeneratorUpdateMs");
 const QLatin1Literal OPTIONS_WHAZZUP_PARSER_DEBUG("Options/WhazzupParserDebug");
 const QLatin1Literal OPTIONS_DATAREADER_DEBUG("Options/DataReaderDebug");
 const QLatin1Literal OPTIONS_WEATHER_DEBUG("Options/WeatherDebug");
 const QLatin1Literal OPTIONS_TRACK_DEBUG("Options/TrackDebug");
+const QLatin1Literal OPTIONS_STARTUP_TRACE_FILE("Options/StartupTraceFile");
 const QLatin1Literal OPTIONS_WEATHER_LEVELS("Options/WeatherLevels");
 const QLatin1Literal OPTIONS_WEATHER_INDEX_SIZE("Options/WeatherIndexSize");
+const QLatin1Literal OPTIONS_WEATHER_METAR_CACHE_SIZE("Options/WeatherMetarCacheSize");
 const QLatin1Literal OPTIONS_WIND_DEBUG("Options/WindDebug");
 const QLatin1Literal OPTIONS_WEBSERVER_DEBUG("Options/WebserverDebug");
+const QLatin1Literal OPTIONS_WEBSERVER_RENDER_POOL_SIZE("Options/WebserverRenderPoolSize");
+const QLatin1Literal OPTIONS_WEBSERVER_TILE_CACHE_MEMORY_MB("Options/WebserverTileCacheMemoryMb");
+const QLatin1Literal OPTIONS_WEBSERVER_TILE_CACHE_DISK_MB("Options/WebserverTileCacheDiskMb");
 const QLatin1Literal OPTIONS_VERSION("Options/Version");
 const QLatin1Literal OPTIONS_NO_USER_AGENT("Options/NoUserAgent");
 const QLatin1Literal OPTIONS_WEATHER_UPDATE("Options/WeatherUpdate");
@@ -113,6 +113,11 @@ public:
   atools::geo::Pos sToW(const QPoint& point) const;
   atools::geo::Pos sToW(const QPointF& point) const;
 
+  const Marble::ViewportParams *getViewport() const
+  {
+    return viewport;
+  }
+
   /* Shortcuts for more readable code */
   static Q_DECL_CONSTEXPR Marble::GeoDataCoordinates::Unit DEG = Marble::GeoDataCoordinates::Degree;
   static Q_DECL_CONSTEXPR Marble::GeoDataCoordinates::BearingType INITBRG =
@@ -18,6 +18,7 @@
 #include "common/elevationprovider.h"
 
 #include "navapp.h"
+#include "common/globemappedreader.h"
 #include "fs/common/globereader.h"
 #include "options/optiondata.h"
 #include "geo/line.h"
@@ -29,12 +30,17 @@
 #include <marble/GeoDataCoordinates.h>
 #include <marble/ElevationModel.h>
 
+#include <QElapsedTimer>
 #include <QMessageBox>
 
 /* Limt altitude to this value */
 static Q_DECL_CONSTEXPR float ALTITUDE_LIMIT_METER = 8800.f;
 /* Point removal equality tolerance in meter */
 static Q_DECL_CONSTEXPR float SAME_ONLINE_ELEVATION_EPSILON = 1.f;
+/* Maximum number of cached elevation points for GLOBE lines */
+static Q_DECL_CONSTEXPR int LINE_CACHE_MAX_POINTS = 500000;
+/* Print latency statistics after this number of GLOBE queries */
+static Q_DECL_CONSTEXPR qint64 LATENCY_LOG_INTERVAL = 1000;
 
 using atools::geo::Pos;
 using atools::geo::Line;
@@ -48,12 +54,33 @@ ElevationProvider::ElevationProvider(QObject *parent, const Marble::ElevationMod
 {
   // Marble will let us know when updates are available
   connect(marbleModel, &ElevationModel::updateAvailable, this, &ElevationProvider::marbleUpdateAvailable);
+  lineCache.setMaxCost(LINE_CACHE_MAX_POINTS);
   updateReader();
 }
 
 ElevationProvider::~ElevationProvider()
 {
-  delete globeReader;
+  deleteReader();
+}
+
+void ElevationProvider::addLatency(qint64 nanoseconds)
+{
+  qint64 num = numQueries.fetchAndAddRelaxed(1) + 1;
+  qint64 total = totalQueryNs.fetchAndAddRelaxed(nanoseconds) + nanoseconds;
+
+  qint64 max = maxQueryNs.load();
+  while(nanoseconds > max && !maxQueryNs.testAndSetRelaxed(max, nanoseconds))
+    max = maxQueryNs.load();
+
+#ifdef DEBUG_INFORMATION
+  if(num % LATENCY_LOG_INTERVAL == 0)
+    qDebug() << Q_FUNC_INFO << "GLOBE queries" << num << "avg" << total / num / 1000 << "us max"
+             << std::max(max, nanoseconds) / 1000 << "us block cache hits" << globeReader->getCacheHits()
+             << "misses" << globeReader->getCacheMisses();
+#else
+  Q_UNUSED(num);
+  Q_UNUSED(total);
+#endif
 }
 
 void ElevationProvider::marbleUpdateAvailable()
@@ -64,11 +91,15 @@ void ElevationProvider::marbleUpdateAvailable()
 
 float ElevationProvider::getElevationMeter(const atools::geo::Pos& pos)
 {
-  QMutexLocker locker(&mutex);
+  QReadLocker locker(&readerLock);
 
   if(isGlobeOfflineProvider())
   {
+    QElapsedTimer timer;
+    timer.start();
     float elevation = globeReader->getElevation(pos);
+    addLatency(timer.nsecsElapsed());
+
     if(!(elevation > atools::fs::common::OCEAN && elevation < atools::fs::common::INVALID))
       return 0.f;
     else
@@ -83,21 +114,14 @@ void ElevationProvider::getElevations(atools::geo::LineString& elevations, const
   if(!line.isValid())
     return;
 
-  QMutexLocker locker(&mutex);
+  QReadLocker locker(&readerLock);
 
   if(isGlobeOfflineProvider())
-  {
-    globeReader->getElevations(elevations, LineString(line.getPos1(), line.getPos2()));
-    for(Pos& pos : elevations)
-    {
-      float alt = pos.getAltitude();
-      if(!(alt > atools::fs::common::OCEAN && alt < atools::fs::common::INVALID))
-        // Reset all invalid and ocean indicators to 0
-        pos.setAltitude(0.f);
-    }
-  }
+    getGlobeElevations(elevations, line);
   else
   {
+    QMutexLocker marbleLocker(&marbleMutex);
+
     // Get altitude points for the line segment
     // The might not be complete and will be more complete on further iterations when we get a signal
     // from the elevation model
@@ -134,11 +158,77 @@ void ElevationProvider::getElevations(atools::geo::LineString& elevations, const
       elevations.append(line.getPos1());
       elevations.append(line.getPos2());
     }
+
+    for(Pos& pos : elevations)
+      // Limit ground altitude
+      pos.setAltitude(std::min(pos.getAltitude(), ALTITUDE_LIMIT_METER));
   }
+}
+
+void ElevationProvider::getElevations(atools::geo::LineString& elevations, const atools::geo::LineString& linestring)
+{
+  if(linestring.size() < 2)
+    return;
 
-  for(Pos& pos : elevations)
-    // Limit ground altitude
-    pos.setAltitude(std::min(pos.getAltitude(), ALTITUDE_LIMIT_METER));
+  // Lock before checking the reader since it can be deleted in optionsChanged()
+  QReadLocker locker(&readerLock);
+
+  if(isGlobeOfflineProvider())
+  {
+    // Read lock is held for all segments - results are taken from the line cache where available
+    for(int i = 0; i < linestring.size() - 1; i++)
+    {
+      Line line(linestring.at(i), linestring.at(i + 1));
+      if(line.isValid())
+        getGlobeElevations(elevations, line);
+    }
+  }
+  else
+  {
+    // Line method locks again
+    locker.unlock();
+    for(int i = 0; i < linestring.size() - 1; i++)
+      getElevations(elevations, Line(linestring.at(i), linestring.at(i + 1)));
+  }
+}
+
+void ElevationProvider::getGlobeElevations(atools::geo::LineString& elevations, const atools::geo::Line& line)
+{
+  LineKey key(qMakePair(line.getPos1().getLonX(), line.getPos1().getLatY()),
+              qMakePair(line.getPos2().getLonX(), line.getPos2().getLatY()));
+
+  {
+    QMutexLocker cacheLocker(&lineCacheMutex);
+    LineString *cachedElevations = lineCache.object(key);
+    if(cachedElevations != nullptr)
+    {
+      elevations.append(*cachedElevations);
+      return;
+    }
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  LineString lineElevations;
+  globeReader->getElevations(lineElevations, LineString(line.getPos1(), line.getPos2()));
+  addLatency(timer.nsecsElapsed());
+
+  for(Pos& pos : lineElevations)
+  {
+    float alt = pos.getAltitude();
+    if(!(alt > atools::fs::common::OCEAN && alt < atools::fs::common::INVALID))
+      // Reset all invalid and ocean indicators to 0
+      pos.setAltitude(0.f);
+    else
+      // Limit ground altitude
+      pos.setAltitude(std::min(alt, ALTITUDE_LIMIT_METER));
+  }
+
+  {
+    QMutexLocker cacheLocker(&lineCacheMutex);
+    lineCache.insert(key, new LineString(lineElevations), std::max(lineElevations.size(), 1));
+  }
+  elevations.append(lineElevations);
 }
 
 bool ElevationProvider::isGlobeDirectoryValid(const QString& path) const
@@ -149,43 +239,60 @@ bool ElevationProvider::isGlobeDirectoryValid(const QString& path) const
 
 void ElevationProvider::optionsChanged()
 {
-  // Make sure to wait for other methods to finish before changing the reader
-  QMutexLocker locker(&mutex);
   updateReader();
 }
 
+void ElevationProvider::deleteReader()
+{
+  delete globeReader;
+  globeReader = nullptr;
+
+  QMutexLocker cacheLocker(&lineCacheMutex);
+  lineCache.clear();
+}
+
 void ElevationProvider::updateReader()
 {
+  // Open files without holding the lock - queries in other threads can continue with the old reader
+  GlobeMappedReader *newReader = nullptr;
+  QString errorMessage;
+  bool replaceReader = true;
   if(OptionData::instance().getFlags() & opts::CACHE_USE_OFFLINE_ELEVATION)
   {
     const QString& path = OptionData::instance().getOfflineElevationPath();
     if(!GlobeReader::isDirValid(path))
     {
-      NavApp::deleteSplashScreen();
-      atools::gui::Dialog::warning(NavApp::getQMainWidget(),
-                                   tr("GLOBE elevation data directory is not valid:<br/>\"%1\"").arg(path));
+      // Keep the current reader
+      replaceReader = false;
+      errorMessage = tr("GLOBE elevation data directory is not valid:<br/>\"%1\"").arg(path);
     }
     else
     {
-      delete globeReader;
-      globeReader = new GlobeReader(path);
+      qDebug() << Q_FUNC_INFO << "Opening GLOBE files";
+      newReader = new GlobeMappedReader(path);
+      if(!newReader->openFiles())
       {
-        qDebug() << Q_FUNC_INFO << "Opening GLOBE files";
-
-        if(!globeReader->openFiles())
-        {
-          NavApp::deleteSplashScreen();
-          atools::gui::Dialog::warning(NavApp::getQMainWidget(),
-                                       tr("Cannot open GLOBE data in directory<br/>\"%1\"").arg(path));
-          qDebug() << Q_FUNC_INFO << "Opening GLOBE done";
-        }
+        delete newReader;
+        newReader = nullptr;
+        errorMessage = tr("Cannot open GLOBE data in directory<br/>\"%1\"").arg(path);
       }
+      qDebug() << Q_FUNC_INFO << "Opening GLOBE done";
     }
   }
-  else
+
+  if(replaceReader)
+  {
+    // Wait for other methods to finish before exchanging the reader
+    QWriteLocker locker(&readerLock);
+    deleteReader();
+    globeReader = newReader;
+  }
+
+  // Show errors only after releasing the lock since the dialog runs an event loop
+  if(!errorMessage.isEmpty())
   {
-    delete globeReader;
-    globeReader = nullptr;
+    NavApp::deleteSplashScreen();
+    atools::gui::Dialog::warning(NavApp::getQMainWidget(), errorMessage);
   }
 
   emit updateAvailable();
@@ -18,20 +18,21 @@
 #ifndef LITTLENAVMAP_ELEVATIONPROVIDER_H
 #define LITTLENAVMAP_ELEVATIONPROVIDER_H
 
+#include "geo/linestring.h"
+
+#include <QAtomicInteger>
+#include <QCache>
 #include <QMutex>
 #include <QObject>
+#include <QReadWriteLock>
 
 namespace Marble {
 class ElevationModel;
 }
 
-namespace atools {
-namespace fs {
-namespace common {
-class GlobeReader;
-}
-}
+class GlobeMappedReader;
 
+namespace atools {
 namespace geo {
 class Pos;
 class LineString;
@@ -43,7 +44,8 @@ class Line;
  * Wraps the slow Marble online elevation provider and the fast offline GLOBE data provider.
  * Use GLOBE data if all paramters are set properly in settings.
  *
- * Class is thread safe.
+ * Class is thread safe. GLOBE data is read from memory mapped files by GlobeMappedReader which allows
+ * concurrent access from several threads. Results for lines are cached for GLOBE data.
  */
 class ElevationProvider :
   public QObject
@@ -61,6 +63,10 @@ public:
    * consecutive ones with same elevation. Elevation given in meter */
   void getElevations(atools::geo::LineString& elevations, const atools::geo::Line& line);
 
+  /* Get elevations along all segments of a line string in one call. Same as above for each segment
+   * but acquires the reader lock only once. Uses the same line cache for offline data. */
+  void getElevations(atools::geo::LineString& elevations, const atools::geo::LineString& linestring);
+
   /* true if the data is provided from the fast offline source */
   bool isGlobeOfflineProvider() const
   {
@@ -78,14 +84,36 @@ signals:
   void updateAvailable();
 
 private:
+  /* Line start and end coordinates as key for cached elevations */
+  typedef QPair<QPair<float, float>, QPair<float, float> > LineKey;
+
   void marbleUpdateAvailable();
+
+  /* Get elevations for one line from the cache or the GLOBE reader. Caller has to hold the read lock. */
+  void getGlobeElevations(atools::geo::LineString& elevations, const atools::geo::Line& line);
   void updateReader();
+  void deleteReader();
+
+  /* Add query time to statistics and print them to the log every few hundred calls */
+  void addLatency(qint64 nanoseconds);
 
   const Marble::ElevationModel *marbleModel = nullptr;
-  atools::fs::common::GlobeReader *globeReader = nullptr;
 
-  /* Need to synchronize here since it is called from profile widget thread */
-  mutable QMutex mutex;
+  /* Null if GLOBE data is not used */
+  GlobeMappedReader *globeReader = nullptr;
+
+  /* Read lock for queries and write lock for changing the reader */
+  mutable QReadWriteLock readerLock;
+
+  /* Query latency statistics for GLOBE data */
+  QAtomicInteger<qint64> numQueries, totalQueryNs, maxQueryNs;
+
+  /* Elevations for GLOBE lines. Cost is number of points. */
+  QCache<LineKey, atools::geo::LineString> lineCache;
+  QMutex lineCacheMutex;
+
+  /* Serializes Marble online elevation model calls */
+  QMutex marbleMutex;
 
 };
 
@@ -0,0 +1,265 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/globemappedreader.h"
+
+#include "atools.h"
+#include "fs/common/globereader.h"
+#include "geo/linestring.h"
+#include "geo/pos.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QtEndian>
+
+#include <cmath>
+
+/* Grid cells per degree */
+static const int CELLS_PER_DEGREE = 120;
+/* Columns in each file covering 90 degree */
+static const int FILE_COLUMNS = 90 * CELLS_PER_DEGREE;
+/* Total number of rows and columns of the whole grid */
+static const int GLOBAL_ROWS = 180 * CELLS_PER_DEGREE;
+static const int GLOBAL_COLUMNS = 360 * CELLS_PER_DEGREE;
+
+/* Rows of the four latitude bands from north to south: 90 to 50, 50 to 0, 0 to -50 and -50 to -90 */
+static const int BAND_ROWS[4] = {40 * CELLS_PER_DEGREE, 50 * CELLS_PER_DEGREE, 50 * CELLS_PER_DEGREE,
+                                 40 * CELLS_PER_DEGREE};
+static const int BAND_START_ROWS[4] = {0, 40 * CELLS_PER_DEGREE, 90 * CELLS_PER_DEGREE, 140 * CELLS_PER_DEGREE};
+
+/* Size of a decoded block in cells and number of blocks kept in all shards */
+static const int BLOCK_SIZE = 128;
+static const int NUM_CACHE_SHARDS = 16;
+static const int MAX_CACHED_BLOCKS = 1024;
+
+/* GLOBE value for ocean */
+static const qint16 GLOBE_OCEAN = -500;
+
+GlobeMappedReader::GlobeMappedReader(const QString& dataDirParam)
+  : dataDir(dataDirParam)
+{
+  for(int i = 0; i < NUM_CACHE_SHARDS; i++)
+  {
+    CacheShard *shard = new CacheShard;
+    shard->blocks.setMaxCost(MAX_CACHED_BLOCKS / NUM_CACHE_SHARDS);
+    shards.append(shard);
+  }
+}
+
+GlobeMappedReader::~GlobeMappedReader()
+{
+  qDebug() << Q_FUNC_INFO << "cache hits" << cacheHits.load() << "misses" << cacheMisses.load();
+
+  for(TileFile *tileFile : files)
+  {
+    if(tileFile->data != nullptr)
+      tileFile->file->unmap(const_cast<uchar *>(tileFile->data));
+    tileFile->file->close();
+    delete tileFile->file;
+  }
+  qDeleteAll(files);
+  qDeleteAll(shards);
+}
+
+bool GlobeMappedReader::openFiles()
+{
+  QDir dir(dataDir);
+  for(int i = 0; i < 16; i++)
+  {
+    // Files are named a10g to p10g - allow any suffix
+    QString letter(QChar('a' + i));
+    QStringList found = dir.entryList({letter + "10g*", letter.toUpper() + "10G*"}, QDir::Files);
+    if(found.isEmpty())
+    {
+      qWarning() << Q_FUNC_INFO << "GLOBE file not found for" << letter << "in" << dataDir;
+      return false;
+    }
+
+    TileFile *tileFile = new TileFile;
+    tileFile->rows = BAND_ROWS[i / 4];
+    tileFile->file = new QFile(dir.filePath(found.first()));
+    files.append(tileFile);
+
+    if(!tileFile->file->open(QIODevice::ReadOnly))
+    {
+      qWarning() << Q_FUNC_INFO << "Cannot open" << tileFile->file->fileName() << tileFile->file->errorString();
+      return false;
+    }
+
+    qint64 expectedSize = static_cast<qint64>(tileFile->rows) * FILE_COLUMNS * 2;
+    if(tileFile->file->size() < expectedSize)
+    {
+      qWarning() << Q_FUNC_INFO << "File too small" << tileFile->file->fileName() << tileFile->file->size();
+      return false;
+    }
+
+    tileFile->data = tileFile->file->map(0, expectedSize);
+    if(tileFile->data == nullptr)
+      // Address space might be exhausted on 32-bit systems - read blocks from file
+      qWarning() << Q_FUNC_INFO << "Cannot map" << tileFile->file->fileName() << "using file access";
+  }
+  return true;
+}
+
+GlobeMappedReader::BlockPtr GlobeMappedReader::loadBlock(int fileIndex, int blockRow, int blockCol) const
+{
+  TileFile *tileFile = files.at(fileIndex);
+
+  int row0 = blockRow * BLOCK_SIZE, col0 = blockCol * BLOCK_SIZE;
+  int numRows = std::min(BLOCK_SIZE, tileFile->rows - row0), numCols = std::min(BLOCK_SIZE, FILE_COLUMNS - col0);
+
+  QVector<qint16> *block = new QVector<qint16>(BLOCK_SIZE * BLOCK_SIZE, GLOBE_OCEAN);
+  QVector<uchar> rowBuffer;
+
+  for(int row = 0; row < numRows; row++)
+  {
+    qint64 offset = (static_cast<qint64>(row0 + row) * FILE_COLUMNS + col0) * 2;
+    const uchar *src = nullptr;
+
+    if(tileFile->data != nullptr)
+      src = tileFile->data + offset;
+    else
+    {
+      rowBuffer.resize(numCols * 2);
+      QMutexLocker locker(&tileFile->fileMutex);
+      if(tileFile->file->seek(offset) &&
+         tileFile->file->read(reinterpret_cast<char *>(rowBuffer.data()), numCols * 2) == numCols * 2)
+        src = rowBuffer.constData();
+    }
+
+    if(src != nullptr)
+    {
+      // Values are stored as 16 bit little endian
+      qint16 *dest = block->data() + row * BLOCK_SIZE;
+      for(int col = 0; col < numCols; col++)
+        dest[col] = qFromLittleEndian<qint16>(src + col * 2);
+    }
+  }
+  return BlockPtr(block);
+}
+
+GlobeMappedReader::BlockPtr GlobeMappedReader::getBlock(int fileIndex, int blockRow, int blockCol) const
+{
+  quint32 key = static_cast<quint32>(fileIndex << 24 | blockRow << 12 | blockCol);
+  CacheShard *shard = shards.at(static_cast<int>(qHash(key) % NUM_CACHE_SHARDS));
+
+  {
+    QMutexLocker locker(&shard->mutex);
+    BlockPtr *cached = shard->blocks.object(key);
+    if(cached != nullptr)
+    {
+      cacheHits.fetchAndAddRelaxed(1);
+      return *cached;
+    }
+  }
+
+  // Decode outside of lock - another thread might do the same which is harmless
+  cacheMisses.fetchAndAddRelaxed(1);
+  BlockPtr block = loadBlock(fileIndex, blockRow, blockCol);
+
+  QMutexLocker locker(&shard->mutex);
+  shard->blocks.insert(key, new BlockPtr(block));
+  return block;
+}
+
+qint16 GlobeMappedReader::getValue(int globalRow, int globalCol, BlockPtr& block, quint32& blockKey) const
+{
+  globalRow = std::max(0, std::min(globalRow, GLOBAL_ROWS - 1));
+  globalCol = std::max(0, std::min(globalCol, GLOBAL_COLUMNS - 1));
+
+  // Find latitude band and file
+  int band = 3;
+  while(band > 0 && globalRow < BAND_START_ROWS[band])
+    band--;
+
+  int fileIndex = band * 4 + globalCol / FILE_COLUMNS;
+  int row = globalRow - BAND_START_ROWS[band], col = globalCol % FILE_COLUMNS;
+  int blockRow = row / BLOCK_SIZE, blockCol = col / BLOCK_SIZE;
+
+  // Reuse block from last call if possible
+  quint32 key = static_cast<quint32>(fileIndex << 24 | blockRow << 12 | blockCol);
+  if(block.isNull() || key != blockKey)
+  {
+    block = getBlock(fileIndex, blockRow, blockCol);
+    blockKey = key;
+  }
+
+  return block->at((row % BLOCK_SIZE) * BLOCK_SIZE + col % BLOCK_SIZE);
+}
+
+float GlobeMappedReader::getElevationInternal(const atools::geo::Pos& pos, BlockPtr& block, quint32& blockKey) const
+{
+  if(!pos.isValid() || files.size() < 16)
+    return atools::fs::common::INVALID;
+
+  int globalRow = static_cast<int>(std::floor((90. - pos.getLatY()) * CELLS_PER_DEGREE));
+  int globalCol = static_cast<int>(std::floor((pos.getLonX() + 180.) * CELLS_PER_DEGREE));
+
+  qint16 value = getValue(globalRow, globalCol, block, blockKey);
+  return value == GLOBE_OCEAN ? atools::fs::common::OCEAN : static_cast<float>(value);
+}
+
+float GlobeMappedReader::getElevation(const atools::geo::Pos& pos) const
+{
+  BlockPtr block;
+  quint32 blockKey = 0;
+  return getElevationInternal(pos, block, blockKey);
+}
+
+void GlobeMappedReader::getElevations(atools::geo::LineString& elevations, const atools::geo::LineString& linestring,
+                                      float sampleDistanceMeter) const
+{
+  // Keep last block to avoid cache lookups for consecutive points
+  BlockPtr block;
+  quint32 blockKey = 0;
+  atools::geo::Pos lastDropped;
+
+  for(int i = 0; i < linestring.size() - 1; i++)
+  {
+    const atools::geo::Pos& pos1 = linestring.at(i), & pos2 = linestring.at(i + 1);
+    float distanceMeter = pos1.distanceMeterTo(pos2);
+    int numSamples = std::max(static_cast<int>(std::ceil(distanceMeter / sampleDistanceMeter)), 1);
+
+    // Include end point only for last segment
+    int last = i == linestring.size() - 2 ? numSamples : numSamples - 1;
+    for(int j = 0; j <= last; j++)
+    {
+      atools::geo::Pos pos = j == 0 ? pos1 : (j == numSamples ? pos2 :
+                                              pos1.interpolate(pos2, distanceMeter,
+                                                               static_cast<float>(j) / numSamples));
+      pos.setAltitude(getElevationInternal(pos, block, blockKey));
+
+      if(!elevations.isEmpty() && atools::almostEqual(elevations.last().getAltitude(), pos.getAltitude()))
+      {
+        // Drop points with same altitude
+        lastDropped = pos;
+        continue;
+      }
+      else if(lastDropped.isValid())
+      {
+        // Add last point of a stretch with same altitude
+        elevations.append(lastDropped);
+        lastDropped = atools::geo::Pos();
+      }
+      elevations.append(pos);
+    }
+  }
+
+  if(lastDropped.isValid())
+    elevations.append(lastDropped);
+}
@@ -0,0 +1,112 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_GLOBEMAPPEDREADER_H
+#define LNM_GLOBEMAPPEDREADER_H
+
+#include <QAtomicInteger>
+#include <QCache>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+class QFile;
+
+namespace atools {
+namespace geo {
+class Pos;
+class LineString;
+}
+}
+
+/*
+ * Reads GLOBE elevation data from the 16 tile files "a10g" to "p10g" using memory mapped files.
+ *
+ * Data is decoded in blocks of BLOCK_SIZE x BLOCK_SIZE cells which are kept in a LRU cache.
+ * The cache is split into shards with separate locks to allow concurrent access from several threads.
+ * Falls back to reading blocks through file access if a file cannot be mapped, e.g. on 32-bit systems.
+ *
+ * Values are returned in meter. Ocean and invalid values are returned like GlobeReader does using
+ * atools::fs::common::OCEAN and atools::fs::common::INVALID.
+ *
+ * Class is thread safe after openFiles() was called.
+ */
+class GlobeMappedReader
+{
+public:
+  GlobeMappedReader(const QString& dataDirParam);
+  ~GlobeMappedReader();
+
+  /* Open and map all files. Returns false if any file is missing. */
+  bool openFiles();
+
+  /* Elevation at nearest cell for position */
+  float getElevation(const atools::geo::Pos& pos) const;
+
+  /* Sample elevations along all segments of linestring every sampleDistanceMeter and append
+   * them to elevations. Consecutive points with same elevation are removed. */
+  void getElevations(atools::geo::LineString& elevations, const atools::geo::LineString& linestring,
+                     float sampleDistanceMeter = 500.f) const;
+
+  /* Number of block cache hits and misses for statistics */
+  quint64 getCacheHits() const
+  {
+    return cacheHits.load();
+  }
+
+  quint64 getCacheMisses() const
+  {
+    return cacheMisses.load();
+  }
+
+private:
+  typedef QSharedPointer<const QVector<qint16> > BlockPtr;
+
+  /* One of 16 GLOBE tile files */
+  struct TileFile
+  {
+    QFile *file = nullptr;
+    const uchar *data = nullptr; /* Mapped memory or null if reading through file */
+    int rows = 0; /* Number of rows in this file */
+    QMutex fileMutex; /* Guards file when reading without mapping */
+  };
+
+  /* Part of the block cache with a separate lock */
+  struct CacheShard
+  {
+    QMutex mutex;
+    QCache<quint32, BlockPtr> blocks;
+  };
+
+  /* Get value at global row and column in cells. Uses and updates block and blockKey to avoid
+   * cache lookups for consecutive calls on the same block. */
+  qint16 getValue(int globalRow, int globalCol, BlockPtr& block, quint32& blockKey) const;
+
+  /* Get decoded block from cache or load it */
+  BlockPtr getBlock(int fileIndex, int blockRow, int blockCol) const;
+  BlockPtr loadBlock(int fileIndex, int blockRow, int blockCol) const;
+
+  float getElevationInternal(const atools::geo::Pos& pos, BlockPtr& block, quint32& blockKey) const;
+
+  QString dataDir;
+  QVector<TileFile *> files;
+  QVector<CacheShard *> shards;
+
+  mutable QAtomicInteger<quint64> cacheHits, cacheMisses;
+};
+
+#endif // LNM_GLOBEMAPPEDREADER_H
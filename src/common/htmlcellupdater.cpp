@@ -0,0 +1,171 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "common/htmlcellupdater.h"
+
+#include "gui/widgetutil.h"
+
+#include <QRegularExpression>
+#include <QTextEdit>
+#include <QTextTable>
+#include <QDebug>
+
+HtmlCellUpdater::HtmlCellUpdater(QTextEdit *textEditParam)
+  : textEdit(textEditParam)
+{
+}
+
+void HtmlCellUpdater::reset()
+{
+  lastTemplate.clear();
+  lastCells.clear();
+  lastRevision = lastCharacterCount = -1;
+}
+
+bool HtmlCellUpdater::isDocumentUnchanged() const
+{
+  return textEdit->document()->revision() == lastRevision &&
+         textEdit->document()->characterCount() == lastCharacterCount;
+}
+
+void HtmlCellUpdater::saveDocumentState()
+{
+  lastRevision = textEdit->document()->revision();
+  lastCharacterCount = textEdit->document()->characterCount();
+}
+
+bool HtmlCellUpdater::splitHtml(const QString& html, QString& htmlTemplate, QStringList& cells)
+{
+  // Captures cell content - does not work with nested tables which are checked below
+  static const QRegularExpression CELL_REGEXP("(<t[dh]\\b[^>]*>)(.*?)(</t[dh]>)",
+                                              QRegularExpression::DotMatchesEverythingOption |
+                                              QRegularExpression::CaseInsensitiveOption);
+
+  htmlTemplate.clear();
+  cells.clear();
+
+  int last = 0;
+  QRegularExpressionMatchIterator it = CELL_REGEXP.globalMatch(html);
+  while(it.hasNext())
+  {
+    QRegularExpressionMatch match = it.next();
+    QString content = match.captured(2);
+
+    if(content.contains("<table", Qt::CaseInsensitive))
+      return false;
+
+    // Keep everything including the cell tags in the template and replace content with a placeholder
+    htmlTemplate.append(html.midRef(last, match.capturedEnd(1) - last));
+    htmlTemplate.append(QChar(0x1a));
+    cells.append(content);
+    last = match.capturedStart(3);
+  }
+  htmlTemplate.append(html.midRef(last));
+
+  return !cells.isEmpty();
+}
+
+void HtmlCellUpdater::collectCells(QVector<CellRef>& cellRefs) const
+{
+  QTextFrame *root = textEdit->document()->rootFrame();
+  for(QTextFrame::iterator it = root->begin(); !it.atEnd(); ++it)
+  {
+    QTextTable *table = qobject_cast<QTextTable *>(it.currentFrame());
+    if(table != nullptr)
+    {
+      for(int row = 0; row < table->rows(); row++)
+      {
+        for(int column = 0; column < table->columns(); column++)
+        {
+          // Skip positions covered by spanning cells
+          QTextTableCell cell = table->cellAt(row, column);
+          if(cell.row() == row && cell.column() == column)
+            cellRefs.append({table, row, column});
+        }
+      }
+    }
+  }
+}
+
+void HtmlCellUpdater::fullUpdate(const QString& html, bool scrollToTop, bool keepSelection)
+{
+  atools::gui::util::updateTextEdit(textEdit, html, scrollToTop, keepSelection);
+  numFullUpdates++;
+}
+
+void HtmlCellUpdater::updateTextEdit(const QString& html, bool scrollToTop, bool keepSelection)
+{
+  QString htmlTemplate;
+  QStringList cells;
+  bool split = splitHtml(html, htmlTemplate, cells);
+
+  if(!split || scrollToTop || htmlTemplate != lastTemplate || cells.size() != lastCells.size() ||
+     !isDocumentUnchanged())
+  {
+    // Structure changed or text edit was changed from outside ============================
+    fullUpdate(html, scrollToTop, keepSelection);
+
+    if(split)
+    {
+      lastTemplate = htmlTemplate;
+      lastCells = cells;
+      saveDocumentState();
+    }
+    else
+      reset();
+    return;
+  }
+
+  QVector<CellRef> cellRefs;
+  collectCells(cellRefs);
+  if(cellRefs.size() != cells.size())
+  {
+    // Document has more or less cells than found in the HTML - e.g. tables not at top level
+    fullUpdate(html, scrollToTop, keepSelection);
+    reset();
+    return;
+  }
+
+  // Replace changed cells only ==========================================
+  // Use a separate cursor to keep the selection of the text edit
+  QTextCursor cursor(textEdit->document());
+  cursor.beginEditBlock();
+  for(int i = 0; i < cells.size(); i++)
+  {
+    if(cells.at(i) != lastCells.at(i))
+    {
+      const CellRef& ref = cellRefs.at(i);
+      QTextTableCell cell = ref.table->cellAt(ref.row, ref.column);
+
+      // Select cell content and keep the character format of the cell for the new text
+      cursor.setPosition(cell.firstCursorPosition().position());
+      cursor.setPosition(cell.lastCursorPosition().position(), QTextCursor::KeepAnchor);
+      QTextCharFormat format = cell.firstCursorPosition().charFormat();
+      cursor.removeSelectedText();
+      cursor.setCharFormat(format);
+
+      if(!cells.at(i).isEmpty())
+        cursor.insertHtml(cells.at(i));
+      numCellUpdates++;
+    }
+  }
+  cursor.endEditBlock();
+
+  lastCells = cells;
+  saveDocumentState();
+}
@@ -0,0 +1,90 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LNM_HTMLCELLUPDATER_H
+#define LNM_HTMLCELLUPDATER_H
+
+#include <QStringList>
+
+class QTextEdit;
+class QTextTable;
+
+/*
+ * Updates a text edit with HTML and replaces only changed table cells if possible.
+ *
+ * The HTML is split into a template consisting of everything except the table cell contents and the list of cell
+ * contents. If the template is the same as for the last update only the cells with changed content are replaced
+ * in the document. This avoids parsing and layout of the whole document for the frequently updated aircraft texts.
+ *
+ * Falls back to a full update if the template changed, the document was changed from outside or the document
+ * structure does not match the cells, e.g. for nested tables.
+ */
+class HtmlCellUpdater
+{
+public:
+  HtmlCellUpdater(QTextEdit *textEditParam);
+
+  /* Same parameters as atools::gui::util::updateTextEdit() */
+  void updateTextEdit(const QString& html, bool scrollToTop, bool keepSelection);
+
+  /* Forget cached state - next update is a full one */
+  void reset();
+
+  /* Number of full and partial updates for debugging */
+  int getNumFullUpdates() const
+  {
+    return numFullUpdates;
+  }
+
+  int getNumCellUpdates() const
+  {
+    return numCellUpdates;
+  }
+
+private:
+  /* Table and position of a cell in the document */
+  struct CellRef
+  {
+    QTextTable *table;
+    int row, column;
+  };
+
+  /* Split HTML into template and cell contents. Returns false if cells cannot be identified. */
+  static bool splitHtml(const QString& html, QString& htmlTemplate, QStringList& cells);
+
+  /* Collect all unique cells of all tables in document order */
+  void collectCells(QVector<CellRef>& cellRefs) const;
+
+  void fullUpdate(const QString& html, bool scrollToTop, bool keepSelection);
+
+  /* true if document was not changed since last update */
+  bool isDocumentUnchanged() const;
+  void saveDocumentState();
+
+  QTextEdit *textEdit;
+
+  QString lastTemplate;
+  QStringList lastCells;
+
+  /* Document revision and size after the last update to detect changes from outside */
+  int lastRevision = -1, lastCharacterCount = -1;
+
+  int numFullUpdates = 0, numCellUpdates = 0;
+};
+
+#endif // LNM_HTMLCELLUPDATER_H
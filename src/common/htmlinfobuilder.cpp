@@ -54,6 +54,7 @@
 #include "userdata/userdataicons.h"
 #include "util/htmlbuilder.h"
 #include "weather/windreporter.h"
+#include "weather/weatherreporter.h"
 
 #include <QSize>
 #include <QFileInfo>
@@ -342,38 +343,39 @@ void HtmlInfoBuilder::airportText(const MapAirport& airport, const map::WeatherC
       // Simulator weather =====================================================
       QString sim = tr("%1 ").arg(NavApp::getCurrentSimulatorShortName());
       addMetarLine(html, tr("%1Station").arg(sim), airport, fsMetar.metarForStation,
-                   fsMetar.requestIdent, fsMetar.timestamp, true /* fs */, src == WEATHER_SOURCE_SIMULATOR);
+                   fsMetar.requestIdent, fsMetar.timestamp,
+                   true /* fs */, WEATHER_SOURCE_SIMULATOR, src == WEATHER_SOURCE_SIMULATOR);
       addMetarLine(html, tr("%1Nearest").arg(sim), airport,
                    fsMetar.metarForNearest, fsMetar.requestIdent, fsMetar.timestamp,
-                   true /* fs */, src == WEATHER_SOURCE_SIMULATOR);
+                   true /* fs */, WEATHER_SOURCE_SIMULATOR, src == WEATHER_SOURCE_SIMULATOR);
       addMetarLine(html, tr("%1Interpolated").arg(sim), airport,
                    fsMetar.metarForInterpolated, fsMetar.requestIdent, fsMetar.timestamp,
-                   true /* fs */, src == WEATHER_SOURCE_SIMULATOR);
+                   true /* fs */, WEATHER_SOURCE_SIMULATOR, src == WEATHER_SOURCE_SIMULATOR);
     }
 
     // Active Sky weather =====================================================
     addMetarLine(html, weatherContext.asType, airport, weatherContext.asMetar, QString(), QDateTime(),
-                 false /* fs */, src == WEATHER_SOURCE_ACTIVE_SKY);
+                 false /* fs */, WEATHER_SOURCE_ACTIVE_SKY, src == WEATHER_SOURCE_ACTIVE_SKY);
 
     // NOAA weather =====================================================
     addMetarLine(html, tr("NOAA Station"), airport, weatherContext.noaaMetar.metarForStation,
                  weatherContext.noaaMetar.requestIdent, weatherContext.noaaMetar.timestamp,
-                 false /* fs */, src == WEATHER_SOURCE_NOAA);
+                 false /* fs */, WEATHER_SOURCE_NOAA, src == WEATHER_SOURCE_NOAA);
     addMetarLine(html, tr("NOAA Nearest"), airport, weatherContext.noaaMetar.metarForNearest,
                  weatherContext.noaaMetar.requestIdent, weatherContext.noaaMetar.timestamp,
-                 false /* fs */, src == WEATHER_SOURCE_NOAA);
+                 false /* fs */, WEATHER_SOURCE_NOAA, src == WEATHER_SOURCE_NOAA);
 
     // VATSIM weather =====================================================
     addMetarLine(html, tr("VATSIM"), airport, weatherContext.vatsimMetar, QString(), QDateTime(),
-                 false /* fs */, src == WEATHER_SOURCE_VATSIM);
+                 false /* fs */, WEATHER_SOURCE_VATSIM, src == WEATHER_SOURCE_VATSIM);
 
     // IVAO weather =====================================================
     addMetarLine(html, tr("IVAO Station"), airport, weatherContext.ivaoMetar.metarForStation,
                  weatherContext.ivaoMetar.requestIdent, weatherContext.ivaoMetar.timestamp,
-                 false /* fs */, src == WEATHER_SOURCE_IVAO);
+                 false /* fs */, WEATHER_SOURCE_IVAO, src == WEATHER_SOURCE_IVAO);
     addMetarLine(html, tr("IVAO Nearest"), airport, weatherContext.ivaoMetar.metarForNearest,
                  weatherContext.ivaoMetar.requestIdent, weatherContext.ivaoMetar.timestamp,
-                 false /* fs */, src == WEATHER_SOURCE_IVAO);
+                 false /* fs */, WEATHER_SOURCE_IVAO, src == WEATHER_SOURCE_IVAO);
     html.tableEnd();
   }
 
@@ -1510,6 +1512,13 @@ void HtmlInfoBuilder::addRadionavFixType(HtmlBuilder& html, const SqlRecord& rec
 
 static const Flags WEATHER_TITLE_FLAGS = ahtml::BOLD | ahtml::BIG;
 
+/* Get parsed metar from cache of the weather reporter */
+static Metar parsedMetar(MapWeatherSource source, const QString& metar, const QString& station = QString(),
+                         const QDateTime& timestamp = QDateTime(), bool simFormat = false)
+{
+  return NavApp::getWeatherReporter()->getParsedMetar(source, metar, station, timestamp, simFormat);
+}
+
 void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapAirport& airport,
                                   HtmlBuilder& html) const
 {
@@ -1537,7 +1546,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
         if(!metar.metarForStation.isEmpty())
         {
-          Metar met(metar.metarForStation, metar.requestIdent, metar.timestamp, true);
+          Metar met = parsedMetar(WEATHER_SOURCE_SIMULATOR, metar.metarForStation, metar.requestIdent,
+                                  metar.timestamp, true);
 
           html.p(tr("%1Station Weather").arg(sim), WEATHER_TITLE_FLAGS);
           decodedMetar(html, airport, map::MapAirport(), met, false /* interpolated */, fsxP3d,
@@ -1546,7 +1556,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
         if(!metar.metarForNearest.isEmpty())
         {
-          Metar met(metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
+          Metar met = parsedMetar(WEATHER_SOURCE_SIMULATOR, metar.metarForNearest, metar.requestIdent,
+                                  metar.timestamp, true);
           QString reportIcao = met.getParsedMetar().isValid() ? met.getParsedMetar().getId() : met.getStation();
 
           html.p(tr("%2Nearest Weather - %1").arg(reportIcao).arg(sim), WEATHER_TITLE_FLAGS);
@@ -1568,7 +1579,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 
         if(!metar.metarForInterpolated.isEmpty())
         {
-          Metar met(metar.metarForInterpolated, metar.requestIdent, metar.timestamp, fsxP3d);
+          Metar met = parsedMetar(WEATHER_SOURCE_SIMULATOR, metar.metarForInterpolated, metar.requestIdent,
+                                  metar.timestamp, fsxP3d);
           html.p(tr("%2Interpolated Weather - %1").arg(met.getStation()).arg(sim), WEATHER_TITLE_FLAGS);
           decodedMetar(html, airport, map::MapAirport(), met, true /* interpolated */, fsxP3d, false /* map src */);
         }
@@ -1588,23 +1600,26 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
         else
           html.p(context.asType, WEATHER_TITLE_FLAGS);
 
-        decodedMetar(html, airport, map::MapAirport(), Metar(context.asMetar), false /* interpolated */,
+        decodedMetar(html, airport, map::MapAirport(), parsedMetar(WEATHER_SOURCE_ACTIVE_SKY, context.asMetar),
+                     false /* interpolated */,
                      false /* FSX/P3D */, src == WEATHER_SOURCE_ACTIVE_SKY && weatherShown);
       }
 
       // NOAA or nearest
-      decodedMetars(html, context.noaaMetar, airport, tr("NOAA"), src == WEATHER_SOURCE_NOAA && weatherShown);
+      decodedMetars(html, context.noaaMetar, airport, tr("NOAA"), WEATHER_SOURCE_NOAA,
+                    src == WEATHER_SOURCE_NOAA && weatherShown);
 
       // Vatsim metar ===========================
       if(!context.vatsimMetar.isEmpty())
       {
         html.p(tr("VATSIM Weather"), WEATHER_TITLE_FLAGS);
-        decodedMetar(html, airport, map::MapAirport(), Metar(context.vatsimMetar),
+        decodedMetar(html, airport, map::MapAirport(), parsedMetar(WEATHER_SOURCE_VATSIM, context.vatsimMetar),
                      false /* interpolated */, false /* FSX/P3D */, src == WEATHER_SOURCE_VATSIM && weatherShown);
       }
 
       // IVAO or nearest
-      decodedMetars(html, context.ivaoMetar, airport, tr("IVAO"), src == WEATHER_SOURCE_IVAO && weatherShown);
+      decodedMetars(html, context.ivaoMetar, airport, tr("IVAO"), WEATHER_SOURCE_IVAO,
+                    src == WEATHER_SOURCE_IVAO && weatherShown);
     } // if(flags & optsw::WEATHER_INFO_ALL)
     else
       html.p().b(tr("No weather display selected in options dialog."));
@@ -1612,7 +1627,8 @@ void HtmlInfoBuilder::weatherText(const map::WeatherContext& context, const MapA
 }
 
 void HtmlInfoBuilder::decodedMetars(HtmlBuilder& html, const atools::fs::weather::MetarResult& metar,
-                                    const map::MapAirport& airport, const QString& name, bool mapDisplay) const
+                                    const map::MapAirport& airport, const QString& name,
+                                    map::MapWeatherSource source, bool mapDisplay) const
 {
   if(metar.isValid())
   {
@@ -1620,12 +1636,13 @@ void HtmlInfoBuilder::decodedMetars(HtmlBuilder& html, const atools::fs::weather
     {
       html.p(tr("%1 Station Weather").arg(name), WEATHER_TITLE_FLAGS);
       decodedMetar(html, airport, map::MapAirport(),
-                   Metar(metar.metarForStation, metar.requestIdent, metar.timestamp, true), false, false, mapDisplay);
+                   parsedMetar(source, metar.metarForStation, metar.requestIdent, metar.timestamp, true),
+                   false, false, mapDisplay);
     }
 
     if(!metar.metarForNearest.isEmpty())
     {
-      Metar met(metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
+      Metar met = parsedMetar(source, metar.metarForNearest, metar.requestIdent, metar.timestamp, true);
       QString reportIcao = met.getParsedMetar().isValid() ? met.getParsedMetar().getId() : met.getStation();
 
       html.p(tr("%1 Nearest Weather - %2").arg(name).arg(reportIcao), WEATHER_TITLE_FLAGS);
@@ -3151,6 +3168,61 @@ void HtmlInfoBuilder::dateAndTime(const SimConnectUserAircraft *userAircraft, Ht
             userAircraft->getLocalTime().timeZoneAbbreviation());
 }
 
+void HtmlInfoBuilder::aircraftAirspaceText(HtmlBuilder& html, const Route& route, float distFromStartNm) const
+{
+  AirspaceController *airspaceController = NavApp::getAirspaceController();
+
+  QStringList inside;
+  for(const MapAirspace& airspace : airspaceController->getAirspacesAtAircraft())
+    inside.append(airspaceShortText(airspace));
+
+  // Find next entry and exit ahead of the aircraft if there is an active leg
+  const AirspaceCrossing *nextEntry = nullptr, *nextExit = nullptr;
+  if(!route.isEmpty() && route.getActiveLegIndexCorrected() != map::INVALID_INDEX_VALUE &&
+     distFromStartNm < map::INVALID_DISTANCE_VALUE)
+  {
+    for(const AirspaceCrossing& crossing : airspaceController->getRouteCrossings())
+    {
+      if(crossing.distanceNm > distFromStartNm)
+      {
+        if(crossing.entry && nextEntry == nullptr)
+          nextEntry = &crossing;
+        else if(!crossing.entry && nextExit == nullptr)
+          nextExit = &crossing;
+
+        if(nextEntry != nullptr && nextExit != nullptr)
+          break;
+      }
+    }
+  }
+
+  if(inside.isEmpty() && nextEntry == nullptr && nextExit == nullptr)
+    return;
+
+  head(html, tr("Airspaces"));
+  html.table();
+  if(!inside.isEmpty())
+    html.row2(tr("Inside:"), inside.join(tr(", ")));
+  if(nextEntry != nullptr)
+    html.row2(tr("Next Entry:"), tr("%1 in %2").
+              arg(airspaceShortText(nextEntry->airspace)).
+              arg(Unit::distNm(nextEntry->distanceNm - distFromStartNm)));
+  if(nextExit != nullptr)
+    html.row2(tr("Next Exit:"), tr("%1 in %2").
+              arg(airspaceShortText(nextExit->airspace)).
+              arg(Unit::distNm(nextExit->distanceNm - distFromStartNm)));
+  html.tableEnd();
+}
+
+QString HtmlInfoBuilder::airspaceShortText(const MapAirspace& airspace) const
+{
+  QString name = airspace.isOnline() ? airspace.name : formatter::capNavString(airspace.name);
+  if(name.isEmpty())
+    return map::airspaceTypeToString(airspace.type);
+  else
+    return tr("%1 (%2)").arg(name).arg(map::airspaceTypeToString(airspace.type));
+}
+
 void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircraft& aircraft,
                                            HtmlBuilder& html, const Route& route, bool moreLessSwitch, bool less)
 {
@@ -3515,6 +3587,10 @@ void HtmlInfoBuilder::aircraftProgressText(const atools::fs::sc::SimConnectAircr
     html.br();
   }
 
+  // Airspaces at aircraft position and along flight plan ==================================================
+  if(info && userAircaft != nullptr && !less)
+    aircraftAirspaceText(html, route, distFromStartNm);
+
   if(info && userAircaft != nullptr)
     head(html, tr("Aircraft"));
   html.table();
@@ -4076,11 +4152,12 @@ void HtmlInfoBuilder::rowForStrCap(HtmlBuilder& html, const SqlRecord *rec, cons
 
 void HtmlInfoBuilder::addMetarLine(atools::util::HtmlBuilder& html, const QString& header,
                                    const map::MapAirport& airport, const QString& metar, const QString& station,
-                                   const QDateTime& timestamp, bool fsMetar, bool mapDisplay) const
+                                   const QDateTime& timestamp, bool fsMetar, map::MapWeatherSource source,
+                                   bool mapDisplay) const
 {
   if(!metar.isEmpty())
   {
-    Metar m(metar, station, timestamp, fsMetar);
+    Metar m = parsedMetar(source, metar, station, timestamp, fsMetar);
     const atools::fs::weather::MetarParser& pm = m.getParsedMetar();
 
     if(!pm.isValid())
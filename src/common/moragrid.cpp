@@ -0,0 +1,128 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/moragrid.h"
+
+#include "fs/common/morareader.h"
+#include "sql/sqldatabase.h"
+#include "sql/sqlutil.h"
+#include "exception.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <limits>
+
+using atools::fs::common::MoraReader;
+
+/* Cells are addressed by top left corner */
+static const int MIN_LONX = -180, MAX_LONX = 179, MIN_LATY = -90, MAX_LATY = 90;
+static const int NUM_COLUMNS = MAX_LONX - MIN_LONX + 1;
+static const int NUM_ROWS = MAX_LATY - MIN_LATY + 1;
+
+MoraGrid::MoraGrid(atools::sql::SqlDatabase *sqlDb)
+  : db(sqlDb)
+{
+  postDatabaseLoad();
+}
+
+MoraGrid::~MoraGrid()
+{
+
+}
+
+int MoraGrid::getMoraFt(int lonx, int laty)
+{
+  if(!available)
+    return UNKNOWN;
+
+  if(!loaded)
+    load();
+
+  if(grid.isEmpty() || lonx < MIN_LONX || lonx > MAX_LONX || laty < MIN_LATY || laty > MAX_LATY)
+    return UNKNOWN;
+
+  return grid.at((laty - MIN_LATY) * NUM_COLUMNS + (lonx - MIN_LONX));
+}
+
+void MoraGrid::preDatabaseLoad()
+{
+  grid.clear();
+  grid.squeeze();
+  available = loaded = false;
+  generation++;
+}
+
+void MoraGrid::postDatabaseLoad()
+{
+  preDatabaseLoad();
+  available = db != nullptr && db->isOpen() && atools::sql::SqlUtil(db).hasTableAndRows("mora_grid");
+  qDebug() << Q_FUNC_INFO << "available" << available;
+}
+
+void MoraGrid::load()
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  loaded = true;
+  grid.clear();
+
+  try
+  {
+    // Reader is only needed for decoding and dropped after copying the values
+    MoraReader reader(db);
+    reader.readFromTable();
+
+    if(reader.isDataAvailable())
+    {
+      grid.resize(NUM_COLUMNS * NUM_ROWS);
+      for(int laty = MIN_LATY; laty <= MAX_LATY; laty++)
+      {
+        for(int lonx = MIN_LONX; lonx <= MAX_LONX; lonx++)
+          grid[(laty - MIN_LATY) * NUM_COLUMNS + (lonx - MIN_LONX)] = pack(reader.getMoraFt(lonx, laty));
+      }
+    }
+  }
+  catch(atools::Exception& e)
+  {
+    qWarning() << Q_FUNC_INFO << "Error reading MORA grid" << e.what();
+    grid.clear();
+  }
+  catch(...)
+  {
+    qWarning() << Q_FUNC_INFO << "Error reading MORA grid";
+    grid.clear();
+  }
+
+  if(grid.isEmpty())
+    available = false;
+
+  qDebug() << Q_FUNC_INFO << "Loaded" << grid.size() << "cells in" << timer.elapsed() << "ms";
+}
+
+qint16 MoraGrid::pack(int value)
+{
+  if(value == MoraReader::OCEAN)
+    return OCEAN;
+  else if(value == MoraReader::UNKNOWN)
+    return UNKNOWN;
+  else if(value == MoraReader::ERROR || value < 0 || value > std::numeric_limits<qint16>::max())
+    return INVALID;
+  else
+    return static_cast<qint16>(value);
+}
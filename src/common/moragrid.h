@@ -0,0 +1,79 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_MORAGRID_H
+#define LNM_MORAGRID_H
+
+#include <QVector>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+}
+}
+
+/*
+ * Minimum off route altitude grid with one value for each one degree cell.
+ *
+ * The grid is read from the navdata database on first access and kept as a packed array of 16 bit values
+ * which needs about 130 kB. Availability is checked without loading the grid.
+ */
+class MoraGrid
+{
+public:
+  /* Special values returned by getMoraFt() */
+  static const int OCEAN = -1;
+  static const int UNKNOWN = -2;
+  static const int INVALID = -3;
+
+  explicit MoraGrid(atools::sql::SqlDatabase *sqlDb);
+  ~MoraGrid();
+
+  /* Get MORA in 100 ft for the cell with the top left corner at lonx/laty or one of the special values above.
+   * Loads the grid on first call. */
+  int getMoraFt(int lonx, int laty);
+
+  /* true if the database contains a MORA grid. Does not load the grid. */
+  bool isDataAvailable() const
+  {
+    return available;
+  }
+
+  /* Incremented each time the grid is reset. Can be used to invalidate dependent caches. */
+  int getGeneration() const
+  {
+    return generation;
+  }
+
+  /* Release grid and disable access while database is changed */
+  void preDatabaseLoad();
+
+  /* Check availability in new database. Grid is loaded again on demand. */
+  void postDatabaseLoad();
+
+private:
+  void load();
+
+  static qint16 pack(int value);
+
+  atools::sql::SqlDatabase *db;
+  QVector<qint16> grid;
+  bool available = false, loaded = false;
+  int generation = 0;
+};
+
+#endif // LNM_MORAGRID_H
@@ -0,0 +1,167 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/startuptracer.h"
+
+#include "common/constants.h"
+#include "settings/settings.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+
+struct Phase
+{
+  QString name;
+  qint64 startMs, endMs;
+  bool background;
+};
+
+struct Mark
+{
+  QString name;
+  qint64 timeMs;
+};
+
+/* Shared state - guarded by mutex */
+QMutex mutex;
+QElapsedTimer timer;
+QVector<Phase> phases;
+QVector<Mark> marks;
+bool finished = false;
+
+}
+
+void StartupTracer::start()
+{
+  QMutexLocker locker(&mutex);
+  timer.start();
+  phases.clear();
+  marks.clear();
+  finished = false;
+}
+
+qint64 StartupTracer::elapsed()
+{
+  QMutexLocker locker(&mutex);
+  return timer.isValid() ? timer.elapsed() : 0;
+}
+
+void StartupTracer::trace(const QString& name, const std::function<void()>& func)
+{
+  qint64 startMs = elapsed();
+  func();
+  addPhase(name, startMs, elapsed(), QThread::currentThread() != qApp->thread());
+}
+
+QFuture<void> StartupTracer::traceConcurrent(const QString& name, const std::function<void()>& func)
+{
+  return QtConcurrent::run([ = ]() -> void {
+    qint64 startMs = elapsed();
+    func();
+    addPhase(name, startMs, elapsed(), true);
+  });
+}
+
+void StartupTracer::mark(const QString& name)
+{
+  QMutexLocker locker(&mutex);
+  if(finished || !timer.isValid())
+    return;
+
+  for(const Mark& m : marks)
+  {
+    if(m.name == name)
+      return;
+  }
+  marks.append({name, timer.elapsed()});
+}
+
+void StartupTracer::addPhase(const QString& name, qint64 startMs, qint64 endMs, bool background)
+{
+  QMutexLocker locker(&mutex);
+  if(!finished && timer.isValid())
+    phases.append({name, startMs, endMs, background});
+}
+
+bool StartupTracer::isFinished()
+{
+  QMutexLocker locker(&mutex);
+  return finished;
+}
+
+void StartupTracer::finish()
+{
+  {
+    QMutexLocker locker(&mutex);
+    if(finished || !timer.isValid())
+      return;
+    finished = true;
+
+    qInfo() << Q_FUNC_INFO << "Startup trace ==========================================";
+    for(const Phase& phase : phases)
+      qInfo().noquote().nospace() << (phase.background ? "  [background] " : "  [main] ") << phase.name
+                                  << ": start " << phase.startMs << " ms, duration "
+                                  << (phase.endMs - phase.startMs) << " ms";
+    for(const Mark& m : marks)
+      qInfo().noquote().nospace() << "  [mark] " << m.name << ": " << m.timeMs << " ms";
+    qInfo() << Q_FUNC_INFO << "Total" << timer.elapsed() << "ms";
+  }
+
+  QString filename = atools::settings::Settings::instance().
+                     getAndStoreValue(lnm::OPTIONS_STARTUP_TRACE_FILE, QString()).toString();
+  if(!filename.isEmpty())
+    writeJson(filename);
+}
+
+void StartupTracer::writeJson(const QString& filename)
+{
+  QJsonArray phaseArr, markArr;
+  {
+    QMutexLocker locker(&mutex);
+    for(const Phase& phase : phases)
+      phaseArr.append(QJsonObject({
+        {"name", phase.name},
+        {"startMs", phase.startMs},
+        {"durationMs", phase.endMs - phase.startMs},
+        {"thread", QString(phase.background ? "background" : "main")}
+      }));
+
+    for(const Mark& m : marks)
+      markArr.append(QJsonObject({{"name", m.name}, {"timeMs", m.timeMs}}));
+  }
+
+  QFile file(filename);
+  if(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    file.write(QJsonDocument(QJsonObject({{"phases", phaseArr}, {"marks", markArr}})).toJson());
+    file.close();
+    qInfo() << Q_FUNC_INFO << "Startup trace written to" << filename;
+  }
+  else
+    qWarning() << Q_FUNC_INFO << "Cannot open" << filename << file.errorString();
+}
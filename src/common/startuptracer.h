@@ -0,0 +1,61 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_STARTUPTRACER_H
+#define LNM_STARTUPTRACER_H
+
+#include <QFuture>
+#include <QString>
+
+#include <functional>
+
+/*
+ * Records wall time of startup phases and points in time like the first map frame.
+ *
+ * Phases can run in the main thread or concurrently in the global thread pool. A summary is written to the log once
+ * finish() is called and additionally to a JSON file if "Options/StartupTraceFile" is set in the configuration file.
+ * All methods are thread safe. Recording stops after finish().
+ */
+class StartupTracer
+{
+public:
+  /* Start the clock. Call as early as possible. */
+  static void start();
+
+  /* Milliseconds since start */
+  static qint64 elapsed();
+
+  /* Run function in the calling thread and record its wall time */
+  static void trace(const QString& name, const std::function<void()>& func);
+
+  /* Run function in the global thread pool and record its wall time */
+  static QFuture<void> traceConcurrent(const QString& name, const std::function<void()>& func);
+
+  /* Record a point in time. Only the first call for each name is recorded. */
+  static void mark(const QString& name);
+
+  /* Log summary and write JSON file if configured. Further calls are ignored. */
+  static void finish();
+
+  static bool isFinished();
+
+private:
+  static void addPhase(const QString& name, qint64 startMs, qint64 endMs, bool background);
+  static void writeJson(const QString& filename);
+};
+
+#endif // LNM_STARTUPTRACER_H
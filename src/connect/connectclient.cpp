@@ -17,6 +17,9 @@
 
 #include "connect/connectclient.h"
 
+#include "connect/simdatarecorder.h"
+#include "connect/simdatareplay.h"
+#include "connect/trafficgenerator.h"
 #include "navapp.h"
 #include "common/constants.h"
 #include "fs/sc/simconnectreply.h"
@@ -83,6 +86,33 @@ ConnectClient::ConnectClient(MainWindow *parent)
   flushQueuedRequestsTimer.setInterval(FLUSH_QUEUE_MS);
   connect(&flushQueuedRequestsTimer, &QTimer::timeout, this, &ConnectClient::flushQueuedRequests);
   flushQueuedRequestsTimer.start();
+
+  // Collects weather updates while a batch of requests is processed
+  weatherUpdateTimer.setSingleShot(true);
+  weatherUpdateTimer.setInterval(WEATHER_UPDATE_MS);
+  connect(&weatherUpdateTimer, &QTimer::timeout, this, &ConnectClient::weatherUpdated);
+
+  // Recording and replay for testing =============================================
+  QString recordFile = settings.valueStr(lnm::OPTIONS_CONNECTCLIENT_RECORD_FILE);
+  if(!recordFile.isEmpty())
+  {
+    recorder = new SimDataRecorder(recordFile);
+    if(!recorder->open())
+    {
+      delete recorder;
+      recorder = nullptr;
+    }
+  }
+
+  QString replayFile = settings.valueStr(lnm::OPTIONS_CONNECTCLIENT_REPLAY_FILE);
+  if(!replayFile.isEmpty())
+  {
+    // Factor for recorded timing - zero or negative is as fast as possible
+    replay = new SimDataReplay(replayFile, settings.valueFloat(lnm::OPTIONS_CONNECTCLIENT_REPLAY_SPEED, 1.f), this);
+    replayQuit = settings.valueBool(lnm::OPTIONS_CONNECTCLIENT_REPLAY_QUIT, false);
+    connect(replay, &SimDataReplay::postSimConnectData, this, &ConnectClient::postSimConnectData);
+    connect(replay, &SimDataReplay::finished, this, &ConnectClient::replayFinished);
+  }
 }
 
 ConnectClient::~ConnectClient()
@@ -91,9 +121,22 @@ ConnectClient::~ConnectClient()
 
   flushQueuedRequestsTimer.stop();
   reconnectNetworkTimer.stop();
+  weatherUpdateTimer.stop();
 
   disconnectClicked();
 
+  qDebug() << Q_FUNC_INFO << "delete trafficGenerator";
+  delete trafficGenerator;
+  trafficGenerator = nullptr;
+
+  qDebug() << Q_FUNC_INFO << "delete replay";
+  delete replay;
+  replay = nullptr;
+
+  qDebug() << Q_FUNC_INFO << "delete recorder";
+  delete recorder;
+  recorder = nullptr;
+
   qDebug() << Q_FUNC_INFO << "delete dataReader";
   delete dataReader;
 
@@ -109,14 +152,44 @@ ConnectClient::~ConnectClient()
 
 void ConnectClient::flushQueuedRequests()
 {
-  if(!queuedRequests.isEmpty())
+  if(!outstandingReplies.isEmpty() && outstandingRepliesTimer.hasExpired(WEATHER_REPLY_TIMEOUT_MS))
+  {
+    // No reply - give up on these and continue with the queue
+    qWarning() << Q_FUNC_INFO << "No weather reply for" << outstandingReplies;
+    outstandingReplies.clear();
+
+    if(queuedRequests.isEmpty() && queuedBatchRequests.isEmpty())
+    {
+      // Nothing more to do - update now with whatever was received
+      weatherUpdateTimer.stop();
+      emit weatherUpdated();
+    }
+  }
+
+  if(outstandingReplies.isEmpty())
   {
-    atools::fs::sc::WeatherRequest req = queuedRequests.takeLast();
-    queuedRequestIdents.remove(req.getStation());
-    requestWeather(req.getStation(), req.getPosition(), false /* station only */);
+    // Single requests first
+    QVector<atools::fs::sc::WeatherRequest>& queue = queuedRequests.isEmpty() ? queuedBatchRequests : queuedRequests;
+    if(!queue.isEmpty())
+    {
+      atools::fs::sc::WeatherRequest req = queue.takeFirst();
+      queuedRequestIdents.remove(req.getStation());
+      requestWeather(req);
+    }
   }
 }
 
+void ConnectClient::clearWeatherRequests()
+{
+  weatherUpdateTimer.stop();
+  metarIdentCache.clear();
+  outstandingReplies.clear();
+  queuedRequests.clear();
+  queuedBatchRequests.clear();
+  queuedRequestIdents.clear();
+  notAvailableStations.clear();
+}
+
 void ConnectClient::connectToServerDialog()
 {
   dialog->setConnected(isConnected());
@@ -141,6 +214,33 @@ void ConnectClient::connectToServerDialog()
 
 void ConnectClient::tryConnectOnStartup()
 {
+  // Start local traffic server before connecting since the client might use it
+  atools::settings::Settings& settings = atools::settings::Settings::instance();
+  int numTraffic = settings.valueInt(lnm::OPTIONS_TRAFFIC_GENERATOR_AIRCRAFT, 0);
+  if(numTraffic > 0 && trafficGenerator == nullptr)
+  {
+    // Runs in its own thread and has no parent
+    trafficGenerator = new TrafficGenerator();
+    if(!trafficGenerator->start(static_cast<quint16>(settings.valueInt(lnm::OPTIONS_TRAFFIC_GENERATOR_PORT, 51968)),
+                                numTraffic, settings.valueInt(lnm::OPTIONS_TRAFFIC_GENERATOR_UPDATE_MS, 500)))
+    {
+      delete trafficGenerator;
+      trafficGenerator = nullptr;
+    }
+  }
+
+  if(replay != nullptr)
+  {
+    // Replay replaces any connection
+    if(replay->start())
+    {
+      mainWindow->setConnectionStatusMessageText(tr("Replay"), tr("Replaying recorded simulator data."));
+      dialog->setConnected(isConnected());
+      emit connectedToSimulator();
+    }
+    return;
+  }
+
   if(dialog->isAutoConnect())
   {
     reconnectNetworkTimer.stop();
@@ -197,11 +297,7 @@ void ConnectClient::disconnectedFromSimulatorDirect()
     mainWindow->setConnectionStatusMessageText(tr("Disconnected"), tr("Disconnected from local flight simulator."));
   dialog->setConnected(isConnected());
 
-  metarIdentCache.clear();
-  outstandingReplies.clear();
-  queuedRequests.clear();
-  queuedRequestIdents.clear();
-  notAvailableStations.clear();
+  clearWeatherRequests();
 
   if(!NavApp::isShuttingDown())
   {
@@ -212,29 +308,79 @@ void ConnectClient::disconnectedFromSimulatorDirect()
   manualDisconnect = false;
 }
 
+void ConnectClient::replayFinished()
+{
+  qDebug() << Q_FUNC_INFO;
+
+  mainWindow->setConnectionStatusMessageText(tr("Disconnected"), tr("Replay of recorded simulator data finished."));
+  dialog->setConnected(isConnected());
+  clearWeatherRequests();
+
+  if(!NavApp::isShuttingDown())
+  {
+    emit disconnectedFromSimulator();
+    emit weatherUpdated();
+
+    if(replayQuit)
+      // Shutdown normally to allow profiling of complete runs
+      QTimer::singleShot(0, mainWindow, &QWidget::close);
+  }
+}
+
+bool ConnectClient::isReplaying() const
+{
+  return replay != nullptr && replay->isRunning();
+}
+
 /* Posts data received directly from simconnect or the socket and caches any metar reports */
 void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket)
 {
+  // Keep the stream as received before any modifications - do not record a replay
+  if(recorder != nullptr && !isReplaying())
+    recorder->record(dataPacket);
+
+  OnlinedataController *onlinedataController = NavApp::getOnlinedataController();
+
   // Modify AI aircraft and set shadow flag if a online network with the same callsign exists
-  for(atools::fs::sc::SimConnectAircraft& aircraft : dataPacket.getAiAircraft())
+  // Find shadows first using const access to avoid detaching and copying the aircraft list if there are none
+  const QVector<atools::fs::sc::SimConnectAircraft>& aiAircraftConst = dataPacket.getAiAircraftConst();
+  QVector<int> shadowIndexes;
+  for(int i = 0; i < aiAircraftConst.size(); i++)
   {
-    if(NavApp::getOnlinedataController()->isShadowAircraft(aircraft))
-      aircraft.setFlags(atools::fs::sc::SIM_ONLINE_SHADOW | aircraft.getFlags());
+    if(onlinedataController->isShadowAircraft(aiAircraftConst.at(i)))
+      shadowIndexes.append(i);
+  }
+
+  if(!shadowIndexes.isEmpty())
+  {
+    QVector<atools::fs::sc::SimConnectAircraft>& aiAircraft = dataPacket.getAiAircraft();
+    for(int i : shadowIndexes)
+      aiAircraft[i].setFlags(atools::fs::sc::SIM_ONLINE_SHADOW | aiAircraft.at(i).getFlags());
   }
 
   // Same as above for user aircraft
   atools::fs::sc::SimConnectUserAircraft& userAircraft = dataPacket.getUserAircraft();
-  if(NavApp::getOnlinedataController()->isShadowAircraft(userAircraft))
+  if(onlinedataController->isShadowAircraft(userAircraft))
     userAircraft.setFlags(atools::fs::sc::SIM_ONLINE_SHADOW | userAircraft.getFlags());
 
-  emit dataPacketReceived(dataPacket);
+  // Publish once - receivers get a reference and can keep the snapshot without copying
+  SimDataSnapshot snapshot(std::move(dataPacket));
+  emit dataPacketReceived(snapshot);
 
-  if(!dataPacket.getMetars().isEmpty())
+#ifdef DEBUG_INFORMATION
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "snapshots created" << SimDataSnapshot::getNumCreated()
+             << "alive" << SimDataSnapshot::getNumAlive();
+#endif
+
+  const atools::fs::sc::SimConnectData& data = snapshot.data();
+
+  if(!data.getMetars().isEmpty())
   {
     if(verbose)
-      qDebug() << "Metars number" << dataPacket.getMetars().size();
+      qDebug() << "Metars number" << data.getMetars().size();
 
-    for(atools::fs::weather::MetarResult metar : dataPacket.getMetars())
+    for(atools::fs::weather::MetarResult metar : data.getMetars())
     {
       QString ident = metar.requestIdent;
       if(verbose)
@@ -260,10 +406,22 @@ void ConnectClient::postSimConnectData(atools::fs::sc::SimConnectData dataPacket
 
       metar.simulator = true;
       metarIdentCache.insert(ident, metar);
+      outstandingReplies.remove(ident);
     }
 
-    if(!dataPacket.getMetars().isEmpty())
+    if(queuedRequests.isEmpty() && queuedBatchRequests.isEmpty() && outstandingReplies.isEmpty())
+    {
+      // All done - update now
+      weatherUpdateTimer.stop();
       emit weatherUpdated();
+    }
+    else
+    {
+      // Batch in progress - send next request and collect updates
+      if(!weatherUpdateTimer.isActive())
+        weatherUpdateTimer.start();
+      QTimer::singleShot(0, this, &ConnectClient::flushQueuedRequests);
+    }
   }
 }
 
@@ -321,6 +479,19 @@ void ConnectClient::fetchOptionsChanged(cd::ConnectSimType type)
   }
 }
 
+atools::fs::weather::MetarResult ConnectClient::getCachedWeather(const QString& station)
+{
+  atools::fs::weather::MetarResult retval;
+  if(isConnected())
+  {
+    // Get the old value without triggering the timeout dependent delete
+    atools::fs::weather::MetarResult *result = metarIdentCache.valueNoTimeout(station);
+    if(result != nullptr)
+      retval = *result;
+  }
+  return retval;
+}
+
 atools::fs::weather::MetarResult ConnectClient::requestWeather(const QString& station, const atools::geo::Pos& pos,
                                                                bool onlyStation)
 {
@@ -348,42 +519,80 @@ atools::fs::weather::MetarResult ConnectClient::requestWeather(const QString& st
     // Return old result if there is any
     retval = *result;
 
-  // Check if the airport is already in the queue
-  if(!queuedRequestIdents.contains(station))
+  if(isWeatherRequestNeeded(station, false /* onlyStation - checked above */))
   {
-    // Check if it is cached already or timed out
-    if(!metarIdentCache.containsNoTimeout(station) || metarIdentCache.isTimedOut(station))
-    {
-      if(verbose)
-        qDebug() << "ConnectClient::requestWeather timed out" << station;
+    if(verbose)
+      qDebug() << "ConnectClient::requestWeather timed out" << station;
 
-      if((socket != nullptr && socket->isOpen()) || (dataReader->isFsxHandler() && dataReader->isConnected()))
-      {
-        atools::fs::sc::WeatherRequest weatherRequest;
-        weatherRequest.setStation(station);
-        weatherRequest.setPosition(pos);
-
-        if(outstandingReplies.isEmpty())
-          // Nothing waiting for reply - request now from network or data reader from sim
-          requestWeather(weatherRequest);
-        else if(!outstandingReplies.contains(weatherRequest.getStation()))
-        {
-          // Not an outstanding reply for this airport - queue request
-          queuedRequests.append(weatherRequest);
-          queuedRequestIdents.insert(station);
-        }
+    // Single requests are usually for the information window - put in front of any batch
+    atools::fs::sc::WeatherRequest weatherRequest;
+    weatherRequest.setStation(station);
+    weatherRequest.setPosition(pos);
+    queuedRequests.prepend(weatherRequest);
+    queuedRequestIdents.insert(station);
+    flushQueuedRequests();
 
-        if(verbose)
-        {
-          qDebug() << "requestWeather === queuedRequestIdents" << queuedRequestIdents;
-          qDebug() << "requestWeather === outstandingReplies" << outstandingReplies;
-        }
-      }
+    if(verbose)
+    {
+      qDebug() << "requestWeather === queuedRequestIdents" << queuedRequestIdents;
+      qDebug() << "requestWeather === outstandingReplies" << outstandingReplies;
     }
   }
   return retval;
 }
 
+void ConnectClient::requestWeatherBatch(const QVector<atools::fs::sc::WeatherRequest>& requests)
+{
+  if(!isConnected())
+    return;
+
+  // Drop unsent requests of the last batch since the view has changed - keep single requests
+  for(const atools::fs::sc::WeatherRequest& request : queuedBatchRequests)
+    queuedRequestIdents.remove(request.getStation());
+  for(const atools::fs::sc::WeatherRequest& request : queuedRequests)
+    queuedRequestIdents.insert(request.getStation());
+  queuedBatchRequests.clear();
+
+  int num = 0;
+  for(const atools::fs::sc::WeatherRequest& request : requests)
+  {
+    if(num >= MAX_WEATHER_BATCH)
+      break;
+
+    if(isWeatherRequestNeeded(request.getStation(), true /* onlyStation */))
+    {
+      queuedBatchRequests.append(request);
+      queuedRequestIdents.insert(request.getStation());
+      num++;
+    }
+  }
+
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "queued" << num << "of" << requests.size()
+             << "single" << queuedRequests.size() << "batch" << queuedBatchRequests.size();
+
+  if(num > 0)
+    flushQueuedRequests();
+}
+
+bool ConnectClient::isWeatherRequestNeeded(const QString& station, bool onlyStation)
+{
+  if(onlyStation && notAvailableStations.contains(station))
+    // No nearest or interpolated and airport is in blacklist
+    return false;
+
+  if(queuedRequestIdents.contains(station) || outstandingReplies.contains(station))
+    // Already waiting
+    return false;
+
+  // Check if it is cached already or timed out
+  if(metarIdentCache.containsNoTimeout(station) && !metarIdentCache.isTimedOut(station))
+    return false;
+
+  // Only network or FSX/P3D allow weather requests
+  return (socket != nullptr && socket->isOpen()) || (dataReader->isFsxHandler() && dataReader->isConnected());
+}
+
 bool ConnectClient::isFetchAiShip() const
 {
   return dialog->isFetchAiShip(dialog->getCurrentSimType());
@@ -397,7 +606,12 @@ bool ConnectClient::isFetchAiAircraft() const
 void ConnectClient::requestWeather(const atools::fs::sc::WeatherRequest& weatherRequest)
 {
   if(dataReader->isFsxHandler() && dataReader->isConnected())
+  {
+    // Reply comes with one of the next data packets
     dataReader->setWeatherRequest(weatherRequest);
+    outstandingReplies.insert(weatherRequest.getStation());
+    outstandingRepliesTimer.start();
+  }
 
   if(socket != nullptr && socket->isOpen() && outstandingReplies.isEmpty())
   {
@@ -408,6 +622,7 @@ void ConnectClient::requestWeather(const atools::fs::sc::WeatherRequest& weather
     reply.setWeatherRequest(weatherRequest);
     writeReplyToSocket(reply);
     outstandingReplies.insert(weatherRequest.getStation());
+    outstandingRepliesTimer.start();
   }
 }
 
@@ -434,6 +649,22 @@ void ConnectClient::disconnectClicked()
 
   reconnectNetworkTimer.stop();
 
+  if(isReplaying())
+  {
+    // Replay replaces any connection - stop it without triggering the quit on finish
+    replay->stop();
+    clearWeatherRequests();
+
+    if(!NavApp::isShuttingDown())
+    {
+      mainWindow->setConnectionStatusMessageText(tr("Disconnected"), tr("Replay of recorded simulator data stopped."));
+      dialog->setConnected(isConnected());
+      emit disconnectedFromSimulator();
+      emit weatherUpdated();
+    }
+    return;
+  }
+
   if(dataReader->isConnected())
     // Tell disconnectedFromSimulatorDirect not to reconnect
     manualDisconnect = true;
@@ -485,6 +716,9 @@ void ConnectClient::connectInternal()
 
 bool ConnectClient::isConnected() const
 {
+  if(isReplaying())
+    return true;
+
   if(dataReader != nullptr)
     return (socket != nullptr && socket->isOpen()) || dataReader->isConnected();
   else
@@ -582,11 +816,7 @@ void ConnectClient::closeSocket(bool allowRestart)
   mainWindow->setConnectionStatusMessageText(msg, msgTooltip);
   dialog->setConnected(isConnected());
 
-  metarIdentCache.clear();
-  outstandingReplies.clear();
-  queuedRequests.clear();
-  queuedRequestIdents.clear();
-  notAvailableStations.clear();
+  clearWeatherRequests();
 
   if(socketConnected)
   {
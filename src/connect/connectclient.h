@@ -18,17 +18,21 @@
 #ifndef LITTLENAVMAP_CONNECTCLIENT_H
 #define LITTLENAVMAP_CONNECTCLIENT_H
 
-#include "fs/sc/simconnectdata.h"
+#include "connect/simdatasnapshot.h"
 #include "util/timedcache.h"
 #include "connectdialog.h"
 
 #include <QAbstractSocket>
 #include <QCache>
+#include <QElapsedTimer>
 #include <QTimer>
 
 class QTcpSocket;
 class ConnectDialog;
 class MainWindow;
+class SimDataRecorder;
+class SimDataReplay;
+class TrafficGenerator;
 
 namespace atools {
 namespace fs {
@@ -61,9 +65,13 @@ public:
   /* Opens the connect dialog and depending on result connects to the server/agent */
   void connectToServerDialog();
 
-  /* Connects directly if the connect on startup option is set */
+  /* Connects directly if the connect on startup option is set.
+   * Starts replay instead if a replay file is set in the configuration. */
   void tryConnectOnStartup();
 
+  /* true if data is fed from a recorded file */
+  bool isReplaying() const;
+
   /* true if connected to Little Navconnect or the simulator */
   bool isConnected() const;
 
@@ -83,13 +91,24 @@ public:
   atools::fs::weather::MetarResult requestWeather(const QString& station, const atools::geo::Pos& pos,
                                                   bool onlyStation);
 
+  /* Get weather from cache only without starting a request. Used for painting where requests are
+   * done by requestWeatherBatch(). */
+  atools::fs::weather::MetarResult getCachedWeather(const QString& station);
+
+  /* Queue weather requests for all given stations at once without blocking. Stations which are cached, queued,
+   * waiting for a reply or known to have no station report are skipped. Requests are sent one by one as
+   * replies arrive and weatherUpdated is sent once all are done. Order of requests is kept.
+   * Replaces the requests of the previous batch which were not sent yet. Single requests are kept.
+   * Only the first MAX_WEATHER_BATCH requests are queued. */
+  void requestWeatherBatch(const QVector<atools::fs::sc::WeatherRequest>& requests);
+
   bool isFetchAiShip() const;
   bool isFetchAiAircraft() const;
 
 signals:
   /* Emitted when new data was received from the server (Little Navconnect), SimConnect or X-Plane.
-   * can be aircraft position or weather update */
-  void dataPacketReceived(atools::fs::sc::SimConnectData simConnectData);
+   * can be aircraft position or weather update. The snapshot is shared by all receivers. */
+  void dataPacketReceived(const SimDataSnapshot& snapshot);
 
   /* Emitted when a new SimConnect data was received that contains weather data */
   void weatherUpdated();
@@ -110,6 +129,15 @@ private:
   const int DIRECT_RECONNECT_SEC = 5;
   const int FLUSH_QUEUE_MS = 50;
 
+  /* Drop outstanding weather reply and continue with queue if simulator or server does not answer */
+  const int WEATHER_REPLY_TIMEOUT_MS = 5000;
+
+  /* Send weatherUpdated not more often than this while a batch of requests is processed */
+  const int WEATHER_UPDATE_MS = 1000;
+
+  /* Maximum number of queued batch requests. Batch is sorted by importance so the rest is dropped. */
+  const int MAX_WEATHER_BATCH = 100;
+
   /* Any metar fetched from the Simulator will time out in 15 seconds */
   const int WEATHER_TIMEOUT_FS_SECS = 15;
   const int NOT_AVAILABLE_TIMEOUT_FS_SECS = 300;
@@ -123,11 +151,18 @@ private:
   void disconnectClicked();
   void postSimConnectData(atools::fs::sc::SimConnectData dataPacket);
   void postLogMessage(QString message, bool warning);
+  void replayFinished();
   void connectedToSimulatorDirect();
   void disconnectedFromSimulatorDirect();
   void autoConnectToggled(bool state);
   void requestWeather(const atools::fs::sc::WeatherRequest& weatherRequest);
+
+  /* Send next request in queue if nothing is waiting for a reply */
   void flushQueuedRequests();
+
+  /* true if station needs a new request */
+  bool isWeatherRequestNeeded(const QString& station, bool onlyStation);
+  void clearWeatherRequests();
   atools::fs::sc::ConnectHandler *handlerByDialogSettings();
   QString simShortName() const;
   QString simName() const;
@@ -148,17 +183,29 @@ private:
   atools::fs::sc::SimConnectData *simConnectData = nullptr;
 
   QTcpSocket *socket = nullptr;
+
+  /* Record raw data stream or feed recorded stream into postSimConnectData for testing.
+   * Enabled by "Options/ConnectClientRecordFile" and "Options/ConnectClientReplayFile" in the configuration. */
+  SimDataRecorder *recorder = nullptr;
+  SimDataReplay *replay = nullptr;
+  bool replayQuit = false;
+
+  /* Local server sending synthetic traffic for stress tests. Enabled by "Options/TrafficGeneratorAircraft". */
+  TrafficGenerator *trafficGenerator = nullptr;
   /* Used to trigger reconnects on socket base connections */
-  QTimer reconnectNetworkTimer, flushQueuedRequestsTimer;
+  QTimer reconnectNetworkTimer, flushQueuedRequestsTimer, weatherUpdateTimer;
   MainWindow *mainWindow;
   bool verbose = false;
   atools::util::TimedCache<QString, atools::fs::weather::MetarResult> metarIdentCache;
 
   /* Waiting for these replies for airport idents */
   QSet<QString> outstandingReplies;
+  QElapsedTimer outstandingRepliesTimer;
+
+  /* Requests in queue. Sent from first to last. Single requests are sent before the batch. */
+  QVector<atools::fs::sc::WeatherRequest> queuedRequests, queuedBatchRequests;
 
-  /* Requests in queue */
-  QVector<atools::fs::sc::WeatherRequest> queuedRequests;
+  /* Stations in both queues */
   QSet<QString> queuedRequestIdents;
 
   /* Cache holding all weather stations that do not allow a direct report but rather interpolated or nearest */
@@ -0,0 +1,87 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "connect/simdatarecorder.h"
+
+#include "fs/sc/simconnectdata.h"
+
+#include <QDataStream>
+#include <QDebug>
+
+SimDataRecorder::SimDataRecorder(const QString& filename)
+  : file(filename)
+{
+}
+
+SimDataRecorder::~SimDataRecorder()
+{
+  close();
+}
+
+bool SimDataRecorder::open()
+{
+  close();
+
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << file.errorString();
+    return false;
+  }
+
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_5_5);
+  out << FILE_MAGIC << FILE_VERSION;
+
+  numRecorded = 0;
+  timer.start();
+
+  qInfo() << Q_FUNC_INFO << "Recording simulator data to" << file.fileName();
+  return true;
+}
+
+void SimDataRecorder::close()
+{
+  if(file.isOpen())
+  {
+    qInfo() << Q_FUNC_INFO << "Recorded" << numRecorded << "packets in" << timer.elapsed() << "ms to"
+            << file.fileName();
+    file.close();
+  }
+}
+
+void SimDataRecorder::record(const atools::fs::sc::SimConnectData& data)
+{
+  if(!file.isOpen())
+    return;
+
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_5_5);
+  out << static_cast<qint64>(timer.elapsed());
+
+  // write() is not const - copy is cheap since aircraft lists are implicitly shared
+  atools::fs::sc::SimConnectData copy(data);
+  copy.write(&file);
+
+  if(file.error() != QFileDevice::NoError)
+  {
+    qWarning() << Q_FUNC_INFO << "Error writing" << file.fileName() << file.errorString() << "- stopping";
+    close();
+  }
+  else
+    numRecorded++;
+}
@@ -0,0 +1,71 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LNM_SIMDATARECORDER_H
+#define LNM_SIMDATARECORDER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+}
+}
+}
+
+/*
+ * Writes the simulator data stream into a file which can be fed back by SimDataReplay.
+ *
+ * File format is a header (magic number and version) followed by records consisting of the
+ * milliseconds since start of recording as qint64 and the binary data packet as sent by Little Navconnect.
+ */
+class SimDataRecorder
+{
+public:
+  SimDataRecorder(const QString& filename);
+  ~SimDataRecorder();
+
+  /* Truncates file and writes header. Returns false and logs a warning on error. */
+  bool open();
+  void close();
+
+  bool isOpen() const
+  {
+    return file.isOpen();
+  }
+
+  /* Append packet using the time elapsed since open() */
+  void record(const atools::fs::sc::SimConnectData& data);
+
+  int getNumRecorded() const
+  {
+    return numRecorded;
+  }
+
+  static const quint32 FILE_MAGIC = 0x524D4E4C;
+  static const quint16 FILE_VERSION = 1;
+
+private:
+  QFile file;
+  QElapsedTimer timer;
+  int numRecorded = 0;
+};
+
+#endif // LNM_SIMDATARECORDER_H
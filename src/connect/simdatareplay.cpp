@@ -0,0 +1,147 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "connect/simdatareplay.h"
+
+#include "connect/simdatarecorder.h"
+#include "fs/sc/simconnectdata.h"
+
+#include <QDataStream>
+#include <QDebug>
+
+SimDataReplay::SimDataReplay(const QString& filename, float speedFactor, QObject *parent)
+  : QObject(parent), file(filename), speed(speedFactor)
+{
+  timer.setSingleShot(true);
+  timer.setTimerType(Qt::PreciseTimer);
+  connect(&timer, &QTimer::timeout, this, &SimDataReplay::sendPacket);
+}
+
+SimDataReplay::~SimDataReplay()
+{
+  stop();
+}
+
+bool SimDataReplay::start()
+{
+  stop();
+
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << file.errorString();
+    return false;
+  }
+
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_5_5);
+  quint32 magic;
+  quint16 version;
+  in >> magic >> version;
+
+  if(magic != SimDataRecorder::FILE_MAGIC || version != SimDataRecorder::FILE_VERSION)
+  {
+    qWarning() << Q_FUNC_INFO << "Invalid file" << file.fileName() << "magic" << magic << "version" << version;
+    file.close();
+    return false;
+  }
+
+  qInfo() << Q_FUNC_INFO << "Replaying simulator data from" << file.fileName() << "speed" << speed;
+
+  numReplayed = 0;
+  elapsedTimer.start();
+
+  if(readPacket())
+  {
+    scheduleNext();
+    return true;
+  }
+  else
+  {
+    qWarning() << Q_FUNC_INFO << "No packets in" << file.fileName();
+    stop();
+    return false;
+  }
+}
+
+void SimDataReplay::stop()
+{
+  timer.stop();
+
+  delete next;
+  next = nullptr;
+
+  if(file.isOpen())
+  {
+    qInfo() << Q_FUNC_INFO << "Replayed" << numReplayed << "packets in" << elapsedTimer.elapsed() << "ms from"
+            << file.fileName();
+    file.close();
+  }
+}
+
+bool SimDataReplay::readPacket()
+{
+  delete next;
+  next = nullptr;
+
+  if(file.atEnd())
+    return false;
+
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_5_5);
+  in >> nextTimestampMs;
+
+  next = new atools::fs::sc::SimConnectData;
+  if(in.status() != QDataStream::Ok || !next->read(&file) || next->getStatus() != atools::fs::sc::OK)
+  {
+    qWarning() << Q_FUNC_INFO << "Error reading packet" << numReplayed << "from" << file.fileName()
+               << next->getStatusText();
+    delete next;
+    next = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void SimDataReplay::scheduleNext()
+{
+  if(speed > 0.f)
+  {
+    // Use elapsed time to avoid accumulating delays of the event loop
+    qint64 dueMs = static_cast<qint64>(nextTimestampMs / speed);
+    timer.start(static_cast<int>(qMax(dueMs - elapsedTimer.elapsed(), 0LL)));
+  }
+  else
+    timer.start(0);
+}
+
+void SimDataReplay::sendPacket()
+{
+  if(next == nullptr)
+    return;
+
+  emit postSimConnectData(*next);
+  numReplayed++;
+
+  if(readPacket())
+    scheduleNext();
+  else
+  {
+    stop();
+    emit finished();
+  }
+}
@@ -0,0 +1,91 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LNM_SIMDATAREPLAY_H
+#define LNM_SIMDATAREPLAY_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QTimer>
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectData;
+}
+}
+}
+
+/*
+ * Reads a file written by SimDataRecorder and sends the packets in the event loop.
+ *
+ * Packets are sent with the recorded timing divided by speed. A speed of zero sends
+ * packets as fast as possible while still allowing the event loop to process paint events.
+ */
+class SimDataReplay :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  SimDataReplay(const QString& filename, float speedFactor, QObject *parent);
+  virtual ~SimDataReplay() override;
+
+  /* Open file and start sending. Returns false and logs a warning on error. */
+  bool start();
+  void stop();
+
+  bool isRunning() const
+  {
+    return file.isOpen();
+  }
+
+  int getNumReplayed() const
+  {
+    return numReplayed;
+  }
+
+signals:
+  /* Recorded packet */
+  void postSimConnectData(atools::fs::sc::SimConnectData data);
+
+  /* End of file reached or error */
+  void finished();
+
+private:
+  /* Send current packet, read the next one and schedule the timer */
+  void sendPacket();
+
+  /* Read timestamp and packet into next. Returns false on end of file or error. */
+  bool readPacket();
+
+  void scheduleNext();
+
+  QFile file;
+  float speed;
+  QTimer timer;
+  QElapsedTimer elapsedTimer;
+
+  /* Read ahead to know when it is due */
+  atools::fs::sc::SimConnectData *next = nullptr;
+  qint64 nextTimestampMs = 0L;
+  int numReplayed = 0;
+};
+
+#endif // LNM_SIMDATAREPLAY_H
@@ -0,0 +1,65 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "connect/simdatasnapshot.h"
+
+#ifdef DEBUG_INFORMATION
+#include <QAtomicInt>
+
+static QAtomicInt numCreated, numAlive;
+
+static void deleteData(const atools::fs::sc::SimConnectData *data)
+{
+  numAlive.fetchAndAddRelaxed(-1);
+  delete data;
+}
+
+int SimDataSnapshot::getNumCreated()
+{
+  return numCreated.loadAcquire();
+}
+
+int SimDataSnapshot::getNumAlive()
+{
+  return numAlive.loadAcquire();
+}
+
+#endif
+
+/* Shared by all default constructed snapshots */
+static const QSharedPointer<const atools::fs::sc::SimConnectData>& emptyData()
+{
+  static const QSharedPointer<const atools::fs::sc::SimConnectData> EMPTY(new atools::fs::sc::SimConnectData);
+  return EMPTY;
+}
+
+SimDataSnapshot::SimDataSnapshot()
+  : ptr(emptyData())
+{
+}
+
+SimDataSnapshot::SimDataSnapshot(atools::fs::sc::SimConnectData data)
+{
+#ifdef DEBUG_INFORMATION
+  numCreated.fetchAndAddRelaxed(1);
+  numAlive.fetchAndAddRelaxed(1);
+  ptr = QSharedPointer<const atools::fs::sc::SimConnectData>(new atools::fs::sc::SimConnectData(std::move(data)),
+                                                             deleteData);
+#else
+  ptr = QSharedPointer<const atools::fs::sc::SimConnectData>(new atools::fs::sc::SimConnectData(std::move(data)));
+#endif
+}
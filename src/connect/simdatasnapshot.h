@@ -0,0 +1,69 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_SIMDATASNAPSHOT_H
+#define LNM_SIMDATASNAPSHOT_H
+
+#include "fs/sc/simconnectdata.h"
+
+#include <QSharedPointer>
+
+/*
+ * Immutable and reference counted simulator data.
+ *
+ * One snapshot is created for each received packet and passed by reference to all receivers.
+ * Receivers keep the snapshot instead of copying the data and its aircraft lists.
+ * A default constructed snapshot shares a single empty data object.
+ */
+class SimDataSnapshot
+{
+public:
+  /* Empty data */
+  SimDataSnapshot();
+
+  /* Takes over the data */
+  explicit SimDataSnapshot(atools::fs::sc::SimConnectData data);
+
+  const atools::fs::sc::SimConnectData& data() const
+  {
+    return *ptr;
+  }
+
+  const atools::fs::sc::SimConnectData& operator*() const
+  {
+    return *ptr;
+  }
+
+  const atools::fs::sc::SimConnectData *operator->() const
+  {
+    return ptr.data();
+  }
+
+#ifdef DEBUG_INFORMATION
+  /* Number of data objects created in total and still referenced */
+  static int getNumCreated();
+  static int getNumAlive();
+
+#endif
+
+private:
+  QSharedPointer<const atools::fs::sc::SimConnectData> ptr;
+};
+
+Q_DECLARE_METATYPE(SimDataSnapshot);
+
+#endif // LNM_SIMDATASNAPSHOT_H
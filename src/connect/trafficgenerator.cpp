@@ -0,0 +1,403 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "connect/trafficgenerator.h"
+
+#include "navapp.h"
+#include "fs/sc/simconnectdata.h"
+#include "fs/sc/simconnectreply.h"
+#include "fs/sc/weatherrequest.h"
+#include "fs/weather/weathertypes.h"
+#include "fs/online/onlinedatamanager.h"
+#include "geo/calculations.h"
+#include "sql/sqldatabase.h"
+#include "sql/sqlquery.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <random>
+
+using atools::fs::sc::SimConnectData;
+using atools::fs::sc::SimConnectAircraft;
+using atools::fs::sc::SimConnectReply;
+using atools::geo::Pos;
+
+TrafficGenerator::TrafficGenerator()
+  : QObject(nullptr), sendTimer(this)
+{
+  workerThread.setObjectName("TrafficGenerator");
+
+  sendTimer.setTimerType(Qt::PreciseTimer);
+  connect(&sendTimer, &QTimer::timeout, this, &TrafficGenerator::sendPacket);
+}
+
+TrafficGenerator::~TrafficGenerator()
+{
+  stop();
+}
+
+bool TrafficGenerator::start(quint16 port, int numAircraft, int updateRateMs)
+{
+  stop();
+
+  initVehicles(std::min(numAircraft, MAX_AIRCRAFT));
+  if(vehicles.isEmpty())
+  {
+    qWarning() << Q_FUNC_INFO << "No airports found in simulator database";
+    return false;
+  }
+
+  // Empty online client record used to build AI aircraft - database is bound to this thread
+  clientRecord = NavApp::getDatabaseOnline()->record("client");
+
+  // Move this and the timer child to the worker thread and open the server there
+  moveToThread(&workerThread);
+  workerThread.start();
+
+  bool ok = false;
+  QMetaObject::invokeMethod(this, [ =, &ok]() -> void {
+    ok = startServer(port, updateRateMs);
+  }, Qt::BlockingQueuedConnection);
+
+  if(!ok)
+    stop();
+  return ok;
+}
+
+void TrafficGenerator::stop()
+{
+  if(workerThread.isRunning())
+  {
+    // Close all in the worker thread which also moves this back to the caller thread
+    QMetaObject::invokeMethod(this, &TrafficGenerator::stopServer, Qt::BlockingQueuedConnection);
+    workerThread.quit();
+    workerThread.wait();
+  }
+}
+
+bool TrafficGenerator::startServer(quint16 port, int updateRateMs)
+{
+  server = new QTcpServer(this);
+  if(!server->listen(QHostAddress::LocalHost, port))
+  {
+    qWarning() << Q_FUNC_INFO << "Cannot listen on port" << port << server->errorString();
+    delete server;
+    server = nullptr;
+    return false;
+  }
+  connect(server, &QTcpServer::newConnection, this, &TrafficGenerator::newConnection);
+
+  sendTimer.setInterval(updateRateMs);
+  clock.start();
+
+  qInfo() << Q_FUNC_INFO << "Listening on port" << port << "with" << vehicles.size() - 1 << "AI aircraft"
+          << "update rate" << updateRateMs << "ms";
+  return true;
+}
+
+void TrafficGenerator::stopServer()
+{
+  sendTimer.stop();
+
+  if(socket != nullptr)
+  {
+    // Not called from a socket signal - delete directly since the event loop is going down
+    socket->disconnect(this);
+    socket->abort();
+    delete socket;
+    socket = nullptr;
+  }
+
+  if(server != nullptr)
+  {
+    server->close();
+    delete server;
+    server = nullptr;
+  }
+
+  delete reply;
+  reply = nullptr;
+
+  sentPackets.clear();
+
+  // Back to the main thread to allow restart and deletion there
+  moveToThread(QCoreApplication::instance()->thread());
+}
+
+void TrafficGenerator::initVehicles(int numAircraft)
+{
+  vehicles.clear();
+
+  // Busiest airports first - about twenty aircraft for each airport
+  int numAirports = std::max(1, std::min(500, numAircraft / 20));
+  atools::sql::SqlQuery query(NavApp::getDatabaseSim());
+  query.prepare("select lonx, laty, altitude from airport "
+                "order by num_runway_hard desc, longest_runway_length desc limit :num");
+  query.bindValue(":num", numAirports);
+  query.exec();
+
+  QVector<Pos> airports;
+  while(query.next())
+    airports.append(Pos(query.valueFloat("lonx"), query.valueFloat("laty"), query.valueFloat("altitude")));
+
+  if(airports.isEmpty())
+    return;
+
+  // Fixed seed to get the same traffic for each run
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> random(0.f, 1.f);
+
+  // User aircraft plus AI aircraft
+  vehicles.reserve(numAircraft + 1);
+  for(int i = 0; i < numAircraft + 1; i++)
+  {
+    Vehicle vehicle;
+    vehicle.center = airports.at(i % airports.size());
+    vehicle.angleDeg = random(generator) * 360.f;
+    vehicle.clockwise = random(generator) > 0.5f;
+
+    // User aircraft is always airborne
+    vehicle.ground = i > 0 && random(generator) < 0.2f;
+    if(vehicle.ground)
+    {
+      // Taxiing on the airport
+      vehicle.radiusNm = 0.2f + random(generator) * 0.8f;
+      vehicle.speedKts = 10.f + random(generator) * 15.f;
+      vehicle.altitudeFt = vehicle.center.getAltitude();
+    }
+    else
+    {
+      // Approach, departure and overflights - higher and faster with distance to airport
+      vehicle.radiusNm = 3.f + random(generator) * 40.f;
+      vehicle.speedKts = 140.f + vehicle.radiusNm * 7.f;
+      vehicle.altitudeFt = std::min(vehicle.center.getAltitude() + 1500.f + vehicle.radiusNm * 800.f, 39000.f);
+    }
+
+    move(vehicle, 0.f);
+    vehicle.lastPos = vehicle.pos;
+    vehicles.append(vehicle);
+  }
+}
+
+void TrafficGenerator::move(Vehicle& vehicle, float seconds)
+{
+  // Angle covered in the given time along the circle
+  float distNm = vehicle.speedKts * seconds / 3600.f;
+  float angle = distNm / (2.f * static_cast<float>(M_PI) * vehicle.radiusNm) * 360.f;
+  vehicle.angleDeg = atools::geo::normalizeCourse(vehicle.angleDeg + (vehicle.clockwise ? angle : -angle));
+
+  vehicle.lastPos = vehicle.pos;
+  vehicle.pos = vehicle.center.endpoint(atools::geo::nmToMeter(vehicle.radiusNm), vehicle.angleDeg).normalize();
+  vehicle.pos.setAltitude(vehicle.altitudeFt);
+}
+
+void TrafficGenerator::newConnection()
+{
+  QTcpSocket *newSocket = server->nextPendingConnection();
+  if(socket != nullptr)
+  {
+    // Only one client
+    qWarning() << Q_FUNC_INFO << "Already connected - rejecting" << newSocket->peerAddress();
+    newSocket->abort();
+    newSocket->deleteLater();
+    return;
+  }
+
+  socket = newSocket;
+  connect(socket, &QTcpSocket::readyRead, this, &TrafficGenerator::readReply);
+  connect(socket, &QTcpSocket::disconnected, this, &TrafficGenerator::clientDisconnected);
+
+  qInfo() << Q_FUNC_INFO << "Client connected from" << socket->peerAddress() << socket->peerPort();
+
+  packetId = 0;
+  numSent = numReplies = numSkipped = 0;
+  bytesSent = sumRoundTripMs = maxRoundTripMs = sumBuildMs = 0L;
+  sentPackets.clear();
+  statisticsTimer.start();
+  lastMove.start();
+  sendTimer.start();
+}
+
+void TrafficGenerator::clientDisconnected()
+{
+  qInfo() << Q_FUNC_INFO;
+
+  sendTimer.stop();
+  logStatistics();
+
+  delete reply;
+  reply = nullptr;
+
+  socket->deleteLater();
+  socket = nullptr;
+}
+
+void TrafficGenerator::readReply()
+{
+  while(socket != nullptr && socket->bytesAvailable())
+  {
+    if(reply == nullptr)
+      // Need to keep the data in background since this method can be called multiple times until the data is filled
+      reply = new atools::fs::sc::SimConnectReply;
+
+    bool read = reply->read(socket);
+    if(reply->getStatus() != atools::fs::sc::OK)
+    {
+      qWarning() << Q_FUNC_INFO << "Error reading reply" << reply->getStatusText();
+      socket->abort();
+      return;
+    }
+
+    if(!read)
+      return;
+
+    if(reply->getCommand() & atools::fs::sc::CMD_WEATHER_REQUEST)
+    {
+      sendWeatherReply(*reply);
+      if(socket == nullptr)
+        // Disconnected on write error which also deleted the reply
+        return;
+    }
+
+    // Replies carry the id of the acknowledged packet
+    if(sentPackets.contains(reply->getPacketId()))
+    {
+      qint64 roundTripMs = clock.elapsed() - sentPackets.take(reply->getPacketId());
+      sumRoundTripMs += roundTripMs;
+      maxRoundTripMs = std::max(maxRoundTripMs, roundTripMs);
+      numReplies++;
+    }
+
+    delete reply;
+    reply = nullptr;
+  }
+}
+
+void TrafficGenerator::sendPacket()
+{
+  if(socket == nullptr)
+    return;
+
+  if(statisticsTimer.hasExpired(STATISTICS_INTERVAL_MS))
+    logStatistics();
+
+  float seconds = lastMove.restart() / 1000.f;
+
+  if(socket->bytesToWrite() > MAX_BYTES_TO_WRITE)
+  {
+    // Client does not keep up - move but do not send
+    for(Vehicle& vehicle : vehicles)
+      move(vehicle, seconds);
+    numSkipped++;
+    return;
+  }
+
+  qint64 buildStart = clock.elapsed();
+
+  // First one is the user aircraft
+  Vehicle& user = vehicles.first();
+  move(user, seconds);
+  SimConnectData data = SimConnectData::buildDebugForPosition(user.pos, user.lastPos, user.ground, 0.f,
+                                                              user.speedKts, 1000.f, 10000.f, 0.f);
+
+  QVector<SimConnectAircraft>& aiAircraft = data.getAiAircraft();
+  aiAircraft.reserve(vehicles.size() - 1);
+  for(int i = 1; i < vehicles.size(); i++)
+  {
+    Vehicle& vehicle = vehicles[i];
+    move(vehicle, seconds);
+
+    // Fill an online client record which is the only way to set identity and position of an aircraft
+    clientRecord.setValue("client_id", OBJECT_ID_OFFSET + i);
+    clientRecord.setValue("callsign", QString("TG%1").arg(i, 5, 10, QChar('0')));
+    clientRecord.setValue("name", QString("Traffic Generator Aircraft %1").arg(i));
+    clientRecord.setValue("lonx", vehicle.pos.getLonX());
+    clientRecord.setValue("laty", vehicle.pos.getLatY());
+    clientRecord.setValue("altitude", vehicle.pos.getAltitude());
+    clientRecord.setValue("groundspeed", vehicle.speedKts);
+    clientRecord.setValue("heading", atools::geo::normalizeCourse(vehicle.lastPos.angleDegTo(vehicle.pos)));
+    clientRecord.setValue("on_ground", vehicle.ground ? 1 : 0);
+
+    SimConnectAircraft aircraft;
+    atools::fs::online::OnlinedataManager::fillFromClient(aircraft, clientRecord);
+
+    // Unique object id and registration and no user flag - clear online flag to get AI aircraft
+    aircraft.setFlags(aircraft.getFlags() & ~atools::fs::sc::SIM_ONLINE);
+    aiAircraft.append(aircraft);
+  }
+
+  data.setPacketId(++packetId);
+  sumBuildMs += clock.elapsed() - buildStart;
+
+  bytesSent += data.write(socket);
+  if(data.getStatus() != atools::fs::sc::OK)
+  {
+    qWarning() << Q_FUNC_INFO << "Error writing packet" << data.getStatusText();
+    socket->abort();
+    return;
+  }
+
+  // Drop old unanswered packets to avoid growing without limit
+  if(sentPackets.size() > MAX_UNANSWERED)
+    sentPackets.clear();
+  sentPackets.insert(packetId, clock.elapsed());
+  numSent++;
+}
+
+void TrafficGenerator::sendWeatherReply(const atools::fs::sc::SimConnectReply& weatherReply)
+{
+  const atools::fs::sc::WeatherRequest& request = weatherReply.getWeatherRequest();
+
+  // Empty report tells the client that the station is not available
+  atools::fs::weather::MetarResult metar;
+  metar.requestIdent = request.getStation();
+  metar.requestPos = request.getPosition();
+  metar.timestamp = QDateTime::currentDateTimeUtc();
+
+  // Packet id zero does not require a reply
+  SimConnectData data;
+  data.setPacketId(0);
+  data.setMetars({metar});
+
+  bytesSent += data.write(socket);
+  if(data.getStatus() != atools::fs::sc::OK)
+  {
+    qWarning() << Q_FUNC_INFO << "Error writing weather reply" << data.getStatusText();
+    socket->abort();
+  }
+}
+
+void TrafficGenerator::logStatistics()
+{
+  qint64 elapsed = std::max(statisticsTimer.restart(), 1LL);
+
+  qInfo().noquote().nospace()
+    << "TrafficGenerator: " << numSent << " packets in " << elapsed << " ms, "
+    << (numSent > 0 ? bytesSent / numSent : 0L) << " bytes/packet, "
+    << (numSent > 0 ? sumBuildMs / numSent : 0L) << " ms build/packet, "
+    << numReplies << " replies, round trip avg "
+    << (numReplies > 0 ? sumRoundTripMs / numReplies : 0L) << " ms max " << maxRoundTripMs << " ms, "
+    << numSkipped << " skipped, " << sentPackets.size() << " waiting for reply";
+
+  numSent = numReplies = numSkipped = 0;
+  bytesSent = sumRoundTripMs = maxRoundTripMs = sumBuildMs = 0L;
+}
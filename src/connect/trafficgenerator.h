@@ -0,0 +1,142 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LNM_TRAFFICGENERATOR_H
+#define LNM_TRAFFICGENERATOR_H
+
+#include "geo/pos.h"
+#include "sql/sqlrecord.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+class QTcpServer;
+class QTcpSocket;
+
+namespace atools {
+namespace fs {
+namespace sc {
+class SimConnectReply;
+}
+}
+}
+
+/*
+ * Load generator acting as a local Little Navconnect server for stress tests.
+ *
+ * Listens on localhost and sends data packets containing a user aircraft and a configurable number of
+ * AI aircraft moving around the largest airports of the loaded simulator database.
+ * Replies from the client are used to measure packet round trip time which is logged periodically.
+ * Weather requests are answered with empty reports like Little Navconnect does if no weather is available.
+ *
+ * Server and packet generation run in an own thread to avoid disturbing the measurements in the client.
+ *
+ * Enabled by setting "Options/TrafficGeneratorAircraft" to a number greater than zero in the configuration.
+ * Connect to "localhost" and "Options/TrafficGeneratorPort" in the connect dialog to receive the traffic.
+ */
+class TrafficGenerator :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  /* No parent allowed since object is moved to the worker thread */
+  TrafficGenerator();
+  virtual ~TrafficGenerator() override;
+
+  /* Select airports, place aircraft, start the worker thread and listen.
+   * Has to be called from the main thread since it accesses the database.
+   * Returns false and logs a warning on error. */
+  bool start(quint16 port, int numAircraft, int updateRateMs);
+
+  /* Close connections and stop the worker thread. Call from main thread. */
+  void stop();
+
+  /* Maximum number of AI aircraft */
+  static const int MAX_AIRCRAFT = 10000;
+
+private:
+  /* Aircraft circling around an airport or taxiing on the airport */
+  struct Vehicle
+  {
+    atools::geo::Pos center, pos, lastPos;
+    float radiusNm, angleDeg, speedKts, altitudeFt;
+    bool ground, clockwise;
+  };
+
+  /* Offset for AI object ids to avoid clashes with the user aircraft */
+  const int OBJECT_ID_OFFSET = 100000;
+
+  /* Log statistics every ten seconds */
+  const int STATISTICS_INTERVAL_MS = 10000;
+
+  /* Skip packets if the client does not keep up and this number of bytes is still waiting */
+  const qint64 MAX_BYTES_TO_WRITE = 16L * 1024L * 1024L;
+
+  /* Forget all packets waiting for a reply if this is exceeded */
+  const int MAX_UNANSWERED = 1000;
+
+  void initVehicles(int numAircraft);
+
+  /* Called in worker thread */
+  bool startServer(quint16 port, int updateRateMs);
+  void stopServer();
+
+  void newConnection();
+  void readReply();
+  void clientDisconnected();
+
+  /* Move all aircraft and send a packet */
+  void sendPacket();
+  void move(Vehicle& vehicle, float seconds);
+
+  /* Answer weather request with an empty report to avoid the client waiting for a timeout */
+  void sendWeatherReply(const atools::fs::sc::SimConnectReply& weatherReply);
+  void logStatistics();
+
+  QTcpServer *server = nullptr;
+  QTcpSocket *socket = nullptr;
+  QTimer sendTimer;
+  QThread workerThread;
+
+  /* Have to keep it since it is read multiple times */
+  atools::fs::sc::SimConnectReply *reply = nullptr;
+
+  /* Online client record used to build AI aircraft with an own identity */
+  atools::sql::SqlRecord clientRecord;
+
+  /* First one is user aircraft */
+  QVector<Vehicle> vehicles;
+
+  int packetId = 0;
+  QElapsedTimer clock, lastMove;
+
+  /* Packet id to send time in ms for round trip time measurement */
+  QHash<int, qint64> sentPackets;
+
+  /* Statistics since last log */
+  QElapsedTimer statisticsTimer;
+  int numSent = 0, numReplies = 0, numSkipped = 0;
+  qint64 bytesSent = 0L, sumRoundTripMs = 0L, maxRoundTripMs = 0L, sumBuildMs = 0L;
+};
+
+#endif // LNM_TRAFFICGENERATOR_H
@@ -24,7 +24,7 @@
 #include "common/mapcolors.h"
 #include "gui/stylehandler.h"
 #include "util/htmlbuilder.h"
-#include "fs/common/morareader.h"
+#include "common/moragrid.h"
 #include "gui/application.h"
 #include "route/routealtitude.h"
 #include "weather/weatherreporter.h"
@@ -954,6 +954,10 @@ void MainWindow::connectAllSlots()
   connect(profileWidget, &ProfileWidget::showPos, mapWidget, &MapPaintWidget::showPos);
 
   connect(routeController, &RouteController::routeChanged, profileWidget, &ProfileWidget::routeChanged);
+  connect(routeController, &RouteController::routeChanged,
+          NavApp::getAirspaceController(), &AirspaceController::routeChanged);
+  connect(routeController, &RouteController::routeAltitudeChanged,
+          NavApp::getAirspaceController(), &AirspaceController::routeChanged);
   connect(routeController, &RouteController::routeAltitudeChanged, profileWidget, &ProfileWidget::routeAltitudeChanged);
   connect(routeController, &RouteController::routeChanged, this, &MainWindow::updateActionStates);
   connect(routeController, &RouteController::routeInsert, this, &MainWindow::routeInsert);
@@ -1075,7 +1079,7 @@ void MainWindow::connectAllSlots()
 
   // Update search
   connect(onlinedataController, &OnlinedataController::onlineClientAndAtcUpdated,
-          clientSearch, &OnlineClientSearch::refreshData);
+          clientSearch, &OnlineClientSearch::onlineClientsUpdated);
   connect(onlinedataController, &OnlinedataController::onlineClientAndAtcUpdated,
           centerSearch, &OnlineCenterSearch::refreshData);
   connect(onlinedataController, &OnlinedataController::onlineServersUpdated,
@@ -1088,6 +1092,8 @@ void MainWindow::connectAllSlots()
           mapWidget, &MapPaintWidget::onlineClientAndAtcUpdated);
   connect(onlinedataController, &OnlinedataController::onlineNetworkChanged,
           mapWidget, &MapPaintWidget::onlineNetworkChanged);
+  connect(onlinedataController, &OnlinedataController::onlineClientPositionsUpdated,
+          mapWidget, &MapPaintWidget::onlineClientPositionsUpdated);
 
   // Update info
   connect(onlinedataController, &OnlinedataController::onlineClientAndAtcUpdated,
@@ -1435,6 +1441,9 @@ void MainWindow::connectAllSlots()
 
   // Deliver first to route controller to update active leg and distances
   connect(connectClient, &ConnectClient::dataPacketReceived, routeController, &RouteController::simDataChanged);
+  // Update airspaces at aircraft before the information windows
+  connect(connectClient, &ConnectClient::dataPacketReceived,
+          NavApp::getAirspaceController(), &AirspaceController::simDataChanged);
 
   connect(connectClient, &ConnectClient::dataPacketReceived, mapWidget, &MapWidget::simDataChanged);
   connect(connectClient, &ConnectClient::dataPacketReceived, profileWidget, &ProfileWidget::simDataChanged);
@@ -1498,6 +1507,13 @@ void MainWindow::connectAllSlots()
   connect(NavApp::getWebController(), &WebController::webserverStatusChanged,
           this, &MainWindow::webserverStatusChanged);
 
+  // Online centers and userpoints are part of web map tiles - use new tiles after changes
+  WebController *webController = NavApp::getWebController();
+  connect(NavApp::getOnlinedataController(), &OnlinedataController::onlineClientAndAtcUpdated,
+          webController, &WebController::mapDynamicDataChanged);
+  connect(NavApp::getUserdataController(), &UserdataController::userdataChanged,
+          webController, &WebController::mapDynamicDataChanged);
+
   // Shortcut menu
   connect(ui->actionShortcutMap, &QAction::triggered,
           this, &MainWindow::actionShortcutMapTriggered);
@@ -1709,6 +1725,7 @@ void MainWindow::changeMapTheme()
   int index = mapThemeComboBox->currentIndex();
   qDebug() << "Changing theme to" << theme << "index" << index;
   mapWidget->setTheme(theme, index);
+  NavApp::getWebController()->mapSettingsChanged();
 
   for(QAction *action : actionGroupMapTheme->actions())
     action->setChecked(action->data() == index);
@@ -3005,6 +3022,7 @@ void MainWindow::updateAirspaceTypes(map::MapAirspaceFilter types)
 {
   mapWidget->setShowMapAirspaces(types);
   mapWidget->updateMapObjectsShown();
+  NavApp::getWebController()->mapSettingsChanged();
   // setStatusMessage(tr("Map settings changed."));
 }
 
@@ -3021,6 +3039,7 @@ void MainWindow::resetMapObjectsShown()
   NavApp::getMapMarkHandler()->resetSettingsToDefault();
 
   mapWidget->updateMapObjectsShown();
+  NavApp::getWebController()->mapSettingsChanged();
 
   mapWidget->update();
   profileWidget->update();
@@ -3037,6 +3056,7 @@ void MainWindow::updateMapObjectsShown()
   mapWidget->updateMapObjectsShown();
   profileWidget->update();
   updateActionStates();
+  NavApp::getWebController()->mapSettingsChanged();
   // setStatusMessage(tr("Map settings changed."));
 }
 
@@ -3242,6 +3262,9 @@ void MainWindow::mainWindowShown()
   if(ui->actionRouteDownloadTracks->isChecked())
     NavApp::getTrackController()->startDownload();
 
+  // Load flight plan calculation networks in background
+  routeController->preloadRouteNetworks();
+
   // Start webserver
   if(ui->actionRunWebserver->isChecked())
     NavApp::getWebController()->startServer();
@@ -3326,7 +3349,7 @@ void MainWindow::updateActionStates()
   ui->actionClearKml->setEnabled(!mapWidget->getKmlFiles().isEmpty());
 
   // Enable MORA button depending on available data
-  ui->actionMapShowMinimumAltitude->setEnabled(NavApp::getMoraReader()->isDataAvailable());
+  ui->actionMapShowMinimumAltitude->setEnabled(NavApp::getMoraGrid()->isDataAvailable());
 
   bool hasFlightplan = !NavApp::getRouteConst().isFlightplanEmpty();
   ui->actionRouteAppend->setEnabled(hasFlightplan);
@@ -3959,6 +3982,9 @@ void MainWindow::postDatabaseLoad(atools::fs::FsPaths::SimulatorType type)
   updateActionStates();
 
   NavApp::getAirspaceController()->updateButtonsAndActions();
+
+  // Cached web map tiles show old database content
+  NavApp::getWebController()->mapSettingsChanged();
 }
 
 /* Update the current weather context for the information window. Returns true if any
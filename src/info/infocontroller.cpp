@@ -29,6 +29,7 @@
 #include "gui/tools.h"
 #include "gui/mainwindow.h"
 #include "gui/widgetutil.h"
+#include "common/htmlcellupdater.h"
 #include "gui/widgetstate.h"
 #include "gui/dialog.h"
 #include "query/mapquery.h"
@@ -66,6 +67,10 @@ InfoController::InfoController(MainWindow *parent)
   // Get base font size for widgets
   Ui::MainWindow *ui = NavApp::getMainUi();
 
+  aircraftUpdater = new HtmlCellUpdater(ui->textBrowserAircraftInfo);
+  aircraftProgressUpdater = new HtmlCellUpdater(ui->textBrowserAircraftProgressInfo);
+  aircraftAiUpdater = new HtmlCellUpdater(ui->textBrowserAircraftAiInfo);
+
   tabHandlerInfo = new atools::gui::TabWidgetHandler(ui->tabWidgetInformation,
                                                      QIcon(":/littlenavmap/resources/icons/tabbutton.svg"),
                                                      tr("Open or close tabs"));
@@ -127,9 +132,19 @@ InfoController::InfoController(MainWindow *parent)
 
 InfoController::~InfoController()
 {
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "aircraft full/cell updates" << aircraftUpdater->getNumFullUpdates()
+           << aircraftUpdater->getNumCellUpdates()
+           << "progress" << aircraftProgressUpdater->getNumFullUpdates() << aircraftProgressUpdater->getNumCellUpdates()
+           << "AI" << aircraftAiUpdater->getNumFullUpdates() << aircraftAiUpdater->getNumCellUpdates();
+#endif
+
   delete tabHandlerInfo;
   delete tabHandlerAircraft;
   delete infoBuilder;
+  delete aircraftUpdater;
+  delete aircraftProgressUpdater;
+  delete aircraftAiUpdater;
 }
 
 void InfoController::visibilityChangedAircraft(bool visible)
@@ -447,10 +462,9 @@ void InfoController::updateProgress()
   {
     // ok - scrollbars not pressed
     html.clear();
-    infoBuilder->aircraftProgressText(lastSimData.getUserAircraftConst(), html, NavApp::getRouteConst(),
+    infoBuilder->aircraftProgressText(lastSimData->getUserAircraftConst(), html, NavApp::getRouteConst(),
                                       true /* show more/less switch */, lessAircraftProgress);
-    atools::gui::util::updateTextEdit(ui->textBrowserAircraftProgressInfo, html.getHtml(),
-                                      false /* scroll to top*/, true /* keep selection */);
+    aircraftProgressUpdater->updateTextEdit(html.getHtml(), false /* scroll to top*/, true /* keep selection */);
   }
 }
 
@@ -1076,23 +1090,28 @@ void InfoController::updateUserAircraftText()
   if(NavApp::isConnected())
 #endif
   {
-    if(lastSimData.getUserAircraftConst().getPosition().isValid())
+    if(lastSimData->getUserAircraftConst().getPosition().isValid())
     {
       if(atools::gui::util::canTextEditUpdate(ui->textBrowserAircraftInfo))
       {
         // ok - scrollbars not pressed
         HtmlBuilder html(true /* has background color */);
-        infoBuilder->aircraftText(lastSimData.getUserAircraftConst(), html);
-        infoBuilder->aircraftTextWeightAndFuel(lastSimData.getUserAircraftConst(), html);
-        atools::gui::util::updateTextEdit(ui->textBrowserAircraftInfo, html.getHtml(),
-                                          false /* scroll to top*/, true /* keep selection */);
+        infoBuilder->aircraftText(lastSimData->getUserAircraftConst(), html);
+        infoBuilder->aircraftTextWeightAndFuel(lastSimData->getUserAircraftConst(), html);
+        aircraftUpdater->updateTextEdit(html.getHtml(), false /* scroll to top*/, true /* keep selection */);
       }
     }
     else
+    {
       ui->textBrowserAircraftInfo->setPlainText(tr("Connected. Waiting for update."));
+      aircraftUpdater->reset();
+    }
   }
   else
+  {
     ui->textBrowserAircraftInfo->clear();
+    aircraftUpdater->reset();
+  }
 }
 
 void InfoController::updateAircraftProgressText()
@@ -1104,23 +1123,28 @@ void InfoController::updateAircraftProgressText()
   if(NavApp::isConnected())
 #endif
   {
-    if(lastSimData.getUserAircraftConst().getPosition().isValid())
+    if(lastSimData->getUserAircraftConst().getPosition().isValid())
     {
       if(atools::gui::util::canTextEditUpdate(ui->textBrowserAircraftProgressInfo))
       {
         // ok - scrollbars not pressed
         HtmlBuilder html(true /* has background color */);
-        infoBuilder->aircraftProgressText(lastSimData.getUserAircraftConst(), html, NavApp::getRouteConst(),
+        infoBuilder->aircraftProgressText(lastSimData->getUserAircraftConst(), html, NavApp::getRouteConst(),
                                           true /* show more/less switch */, lessAircraftProgress);
-        atools::gui::util::updateTextEdit(ui->textBrowserAircraftProgressInfo, html.getHtml(),
-                                          false /* scroll to top*/, true /* keep selection */);
+        aircraftProgressUpdater->updateTextEdit(html.getHtml(), false /* scroll to top*/, true /* keep selection */);
       }
     }
     else
+    {
       ui->textBrowserAircraftProgressInfo->setPlainText(tr("Connected. Waiting for update."));
+      aircraftProgressUpdater->reset();
+    }
   }
   else
+  {
     ui->textBrowserAircraftProgressInfo->clear();
+    aircraftProgressUpdater->reset();
+  }
 }
 
 void InfoController::updateAiAircraftText()
@@ -1132,7 +1156,7 @@ void InfoController::updateAiAircraftText()
   if(NavApp::isConnected())
 #endif
   {
-    if(lastSimData.getUserAircraftConst().getPosition().isValid())
+    if(lastSimData->getUserAircraftConst().getPosition().isValid())
     {
       if(atools::gui::util::canTextEditUpdate(ui->textBrowserAircraftAiInfo))
       {
@@ -1144,18 +1168,17 @@ void InfoController::updateAiAircraftText()
           int num = 1;
           for(const SimConnectAircraft& aircraft : currentSearchResult.aiAircraft)
           {
-            infoBuilder->aircraftText(aircraft, html, num, lastSimData.getAiAircraftConst().size());
+            infoBuilder->aircraftText(aircraft, html, num, lastSimData->getAiAircraftConst().size());
             infoBuilder->aircraftProgressText(aircraft, html, Route(),
                                               false /* show more/less switch */, false /* true if less info mode */);
             num++;
           }
 
-          atools::gui::util::updateTextEdit(ui->textBrowserAircraftAiInfo, html.getHtml(),
-                                            false /* scroll to top*/, true /* keep selection */);
+          aircraftAiUpdater->updateTextEdit(html.getHtml(), false /* scroll to top*/, true /* keep selection */);
         }
         else
         {
-          int numAi = lastSimData.getAiAircraftConst().size();
+          int numAi = lastSimData->getAiAircraftConst().size();
           QString text;
 
           if(!(NavApp::getShownMapFeatures() & map::AIRCRAFT_AI))
@@ -1164,20 +1187,26 @@ void InfoController::updateAiAircraftText()
           text += tr("No AI or multiplayer aircraft selected.<br/>"
                      "Found %1 AI or multiplayer aircraft.").
                   arg(numAi > 0 ? QLocale().toString(numAi) : tr("no"));
-          atools::gui::util::updateTextEdit(ui->textBrowserAircraftAiInfo, text,
-                                            false /* scroll to top*/, true /* keep selection */);
+          aircraftAiUpdater->updateTextEdit(text, false /* scroll to top*/, true /* keep selection */);
         }
       }
     }
     else
+    {
       ui->textBrowserAircraftAiInfo->setPlainText(tr("Connected. Waiting for update."));
+      aircraftAiUpdater->reset();
+    }
   }
   else
+  {
     ui->textBrowserAircraftAiInfo->clear();
+    aircraftAiUpdater->reset();
+  }
 }
 
-void InfoController::simDataChanged(atools::fs::sc::SimConnectData data)
+void InfoController::simDataChanged(const SimDataSnapshot& snapshot)
 {
+  const atools::fs::sc::SimConnectData& data = *snapshot;
   if(databaseLoadStatus)
     return;
 
@@ -1189,7 +1218,7 @@ void InfoController::simDataChanged(atools::fs::sc::SimConnectData data)
     // Last update was more than 500 ms ago
     updateAiAirports(data);
 
-    lastSimData = data;
+    lastSimData = snapshot;
     if(data.getUserAircraftConst().isValid() && ui->dockWidgetAircraft->isVisible())
     {
       if(tabHandlerAircraft->getCurrentTabId() == ic::AIRCRAFT_USER)
@@ -1260,7 +1289,7 @@ void InfoController::connectedToSimulator()
 void InfoController::disconnectedFromSimulator()
 {
   qDebug() << Q_FUNC_INFO;
-  lastSimData = atools::fs::sc::SimConnectData();
+  lastSimData = SimDataSnapshot();
   lastSimUpdate = 0;
   updateAircraftInfo();
 }
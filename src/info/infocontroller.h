@@ -18,7 +18,7 @@
 #ifndef LITTLENAVMAP_INFOCONTROLLER_H
 #define LITTLENAVMAP_INFOCONTROLLER_H
 
-#include "fs/sc/simconnectdata.h"
+#include "connect/simdatasnapshot.h"
 #include "common/maptypes.h"
 #include "common/tabindexes.h"
 
@@ -32,6 +32,7 @@ class InfoQuery;
 class HtmlInfoBuilder;
 class QTextEdit;
 class AirspaceController;
+class HtmlCellUpdater;
 
 namespace atools {
 namespace gui {
@@ -88,7 +89,7 @@ public:
   void tracksChanged();
 
   /* Update aircraft and aircraft progress tab */
-  void simDataChanged(atools::fs::sc::SimConnectData data);
+  void simDataChanged(const SimDataSnapshot& snapshot);
   void connectedToSimulator();
   void disconnectedFromSimulator();
 
@@ -141,7 +142,7 @@ private:
   void visibilityChangedInfo(bool visible);
 
   bool databaseLoadStatus = false;
-  atools::fs::sc::SimConnectData lastSimData;
+  SimDataSnapshot lastSimData;
   qint64 lastSimUpdate = 0;
   qint64 lastSimBearingUpdate = 0;
 
@@ -158,6 +159,9 @@ private:
   bool lessAircraftProgress = false;
 
   atools::gui::TabWidgetHandler *tabHandlerInfo = nullptr, *tabHandlerAircraft = nullptr;
+
+  /* Replace only changed values in the frequently updated aircraft tabs */
+  HtmlCellUpdater *aircraftUpdater = nullptr, *aircraftProgressUpdater = nullptr, *aircraftAiUpdater = nullptr;
 };
 
 #endif // LITTLENAVMAP_INFOCONTROLLER_H
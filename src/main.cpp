@@ -33,13 +33,14 @@
 #include "db/databasemanager.h"
 #include "common/settingsmigrate.h"
 #include "common/aircrafttrack.h"
-#include "fs/sc/simconnectdata.h"
+#include "connect/simdatasnapshot.h"
 #include "fs/sc/simconnectreply.h"
 #include "common/maptypes.h"
 #include "common/proctypes.h"
 #include "common/unit.h"
 #include "fs/weather/metarparser.h"
 #include "userdata/userdataicons.h"
+#include "common/startuptracer.h"
 
 #include <QCommandLineParser>
 #include <QDebug>
@@ -99,6 +100,7 @@ int main(int argc, char *argv[])
 
   // Needed to send SimConnectData through queued connections
   qRegisterMetaType<atools::fs::sc::SimConnectData>();
+  qRegisterMetaType<SimDataSnapshot>();
   qRegisterMetaType<atools::fs::sc::SimConnectReply>();
   qRegisterMetaType<atools::fs::sc::WeatherRequest>();
 
@@ -158,6 +160,9 @@ int main(int argc, char *argv[])
   int retval = 0;
   NavApp app(argc, argv);
 
+  // Measure startup phases until the first map frame is painted
+  StartupTracer::start();
+
 #ifndef DEBUG_DISABLE_SPLASH
   // Start splash screen
   NavApp::initSplashScreen();
@@ -389,7 +394,9 @@ int main(int argc, char *argv[])
       // Show database dialog if something was removed
       mainWindow.setDatabaseErased(databasesErased);
 
+      StartupTracer::mark("Main window created");
       mainWindow.show();
+      StartupTracer::mark("Main window shown");
 
       // Hide splash once main window is shown
       NavApp::finishSplashScreen();
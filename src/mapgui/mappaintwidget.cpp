@@ -27,6 +27,7 @@
 #include "common/unit.h"
 #include "common/aircrafttrack.h"
 #include "mapgui/aprongeometrycache.h"
+#include "common/startuptracer.h"
 
 #include <QPainter>
 #include <QJsonDocument>
@@ -760,7 +761,7 @@ void MapPaintWidget::disconnectedFromSimulator()
 {
   qDebug() << Q_FUNC_INFO;
   // Clear all data on disconnect
-  screenIndex->updateSimData(atools::fs::sc::SimConnectData());
+  screenIndex->updateSimData(SimDataSnapshot());
   updateMapVisibleUi();
   jumpBackToAircraftCancel();
   update();
@@ -1076,6 +1077,13 @@ void MapPaintWidget::paintEvent(QPaintEvent *paintEvent)
 
   MarbleWidget::paintEvent(paintEvent);
 
+  if(visibleWidget && !StartupTracer::isFinished())
+  {
+    // Log startup phases once the map is visible
+    StartupTracer::mark("First map frame");
+    StartupTracer::finish();
+  }
+
   if(changed)
   {
     // Major change - update index and visible objects
@@ -1106,6 +1114,12 @@ void MapPaintWidget::onlineClientAndAtcUpdated()
   update();
 }
 
+void MapPaintWidget::onlineClientPositionsUpdated()
+{
+  if(paintLayer->getShownMapObjects() & map::AIRCRAFT_ONLINE)
+    update();
+}
+
 void MapPaintWidget::onlineNetworkChanged()
 {
   screenIndex->resetAirspaceOnlineScreenGeometry();
@@ -202,6 +202,9 @@ public:
   /* Whole online network has changed */
   void onlineNetworkChanged();
 
+  /* Online aircraft were moved by dead reckoning - redraw if shown */
+  void onlineClientPositionsUpdated();
+
   /* Redraw map to reflect weather changes */
   void weatherUpdated();
 
@@ -0,0 +1,110 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/mapscreengrid.h"
+
+#include <marble/ViewportParams.h>
+
+#include <algorithm>
+
+MapScreenGrid::MapScreenGrid()
+{
+  std::fill(std::begin(generations), std::end(generations), 0);
+  std::fill(std::begin(typeValid), std::end(typeValid), false);
+}
+
+void MapScreenGrid::reset(const Marble::ViewportParams *viewport)
+{
+  clear();
+
+  centerLonX = viewport->centerLongitude();
+  centerLatY = viewport->centerLatitude();
+  radius = viewport->radius();
+  width = viewport->width();
+  height = viewport->height();
+  projection = viewport->projection();
+
+  cellsX = (width + 2 * MARGIN) / CELL_SIZE + 1;
+  cellsY = (height + 2 * MARGIN) / CELL_SIZE + 1;
+}
+
+void MapScreenGrid::clear()
+{
+  valid = false;
+  std::fill(std::begin(typeValid), std::end(typeValid), false);
+  entries.clear();
+  keys.clear();
+  cellStart.clear();
+  cellsX = cellsY = 0;
+}
+
+void MapScreenGrid::add(Type type, int x, int y, int index, int id)
+{
+  if(x < -MARGIN || x > width + MARGIN || y < -MARGIN || y > height + MARGIN)
+    return;
+
+  keys.append({cellIndex(type, x, y), entries.size()});
+  entries.append({index, id, x, y});
+}
+
+void MapScreenGrid::finish()
+{
+  int numCells = NUM_TYPES * cellsX * cellsY;
+
+  // Count entries per cell
+  cellStart.fill(0, numCells + 1);
+  for(const Key& key : keys)
+    cellStart[key.cell + 1]++;
+
+  // Prefix sum gives start index for each cell
+  for(int i = 0; i < numCells; i++)
+    cellStart[i + 1] += cellStart.at(i);
+
+  // Distribute entries into cell order
+  QVector<int> insertPos(cellStart);
+  QVector<Entry> sorted(entries.size());
+  for(const Key& key : keys)
+    sorted[insertPos[key.cell]++] = entries.at(key.entry);
+
+  entries.swap(sorted);
+  keys.clear();
+  valid = true;
+}
+
+bool MapScreenGrid::isValid(const Marble::ViewportParams *viewport, Type type, quint32 generation,
+                            int screenDistance) const
+{
+  return valid && typeValid[type] && generations[type] == generation && screenDistance <= MARGIN &&
+         centerLonX == viewport->centerLongitude() && centerLatY == viewport->centerLatitude() &&
+         radius == viewport->radius() && width == viewport->width() && height == viewport->height() &&
+         projection == viewport->projection();
+}
+
+int MapScreenGrid::cellX(int x) const
+{
+  return std::min(std::max((x + MARGIN) / CELL_SIZE, 0), cellsX - 1);
+}
+
+int MapScreenGrid::cellY(int y) const
+{
+  return std::min(std::max((y + MARGIN) / CELL_SIZE, 0), cellsY - 1);
+}
+
+int MapScreenGrid::cellIndex(Type type, int x, int y) const
+{
+  return (type * cellsY + cellY(y)) * cellsX + cellX(x);
+}
@@ -0,0 +1,162 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_MAPSCREENGRID_H
+#define LNM_MAPSCREENGRID_H
+
+#include <QVector>
+
+#include <cstdlib>
+
+#include <marble/MarbleGlobal.h>
+
+namespace Marble {
+class ViewportParams;
+}
+
+/*
+ * Screen space bucket grid for map objects which allows to find objects near a screen position
+ * in O(k) time instead of scanning and projecting all cached objects on every mouse movement.
+ *
+ * Filled once per render by MapQuery::updateScreenGrid() and used by MapQuery::getNearestScreenObjects().
+ * Entries refer to objects by index into the MapQuery caches. A generation number is stored for each type
+ * which allows the caller to detect if the cache was changed after building the grid.
+ *
+ * Data is kept in a flat vector sorted by type and cell (compressed sparse row) to avoid
+ * allocating a container for each cell.
+ */
+class MapScreenGrid
+{
+public:
+  /* Object types indexed in the grid */
+  enum Type
+  {
+    AIRPORT,
+    AIRPORT_TOWER,
+    VOR,
+    NDB,
+    USERPOINT,
+    MARKER,
+    ILS,
+    PARKING,
+    HELIPAD,
+    NUM_TYPES
+  };
+
+  /* A grid entry with screen coordinates and index into the related list. id is the airport id for
+   * parking and helipads and otherwise unused. */
+  struct Entry
+  {
+    int index, id, x, y;
+  };
+
+  MapScreenGrid();
+
+  /* Remove all entries and prepare grid for viewport dimensions. Invalid until finish() is called. */
+  void reset(const Marble::ViewportParams *viewport);
+
+  /* Add an entry. Objects too far outside of the viewport are ignored. */
+  void add(Type type, int x, int y, int index, int id = -1);
+
+  /* Sort entries into cells and make grid valid */
+  void finish();
+
+  /* Clear all and make grid invalid */
+  void clear();
+
+  /* Generation of the source list at the time of building. Marks the type as present in the grid. */
+  void setGeneration(Type type, quint32 generation)
+  {
+    generations[type] = generation;
+    typeValid[type] = true;
+  }
+
+  /* true if grid was built for the given viewport and source list generation. Otherwise caller
+   * has to fall back to a linear search. */
+  bool isValid(const Marble::ViewportParams *viewport, Type type, quint32 generation, int screenDistance) const;
+
+  /* Call func(const Entry&) for all entries having a manhattan distance lower than screenDistance */
+  template<typename FUNC>
+  void forEachNearest(Type type, int xs, int ys, int screenDistance, FUNC func) const;
+
+  /* Number of entries in grid */
+  int size() const
+  {
+    return entries.size();
+  }
+
+private:
+  struct Key
+  {
+    int cell, entry;
+  };
+
+  int cellIndex(Type type, int x, int y) const;
+  int cellX(int x) const;
+  int cellY(int y) const;
+
+  /* Cell size in pixel */
+  static const int CELL_SIZE = 32;
+
+  /* Objects outside of the viewport plus this margin are ignored */
+  static const int MARGIN = 64;
+
+  /* Sorted by type and cell after finish() */
+  QVector<Entry> entries;
+
+  /* Cell and entry index collected by add() */
+  QVector<Key> keys;
+
+  /* Start index into entries for each type and cell. Size is NUM_TYPES * number of cells + 1 */
+  QVector<int> cellStart;
+
+  int cellsX = 0, cellsY = 0;
+  bool valid = false;
+
+  /* Viewport at time of building */
+  qreal centerLonX = 0., centerLatY = 0.;
+  int radius = 0, width = 0, height = 0;
+  Marble::Projection projection = Marble::Spherical;
+
+  quint32 generations[NUM_TYPES];
+  bool typeValid[NUM_TYPES];
+};
+
+// ---------------------------------------------------------------------------------
+
+template<typename FUNC>
+void MapScreenGrid::forEachNearest(Type type, int xs, int ys, int screenDistance, FUNC func) const
+{
+  int left = cellX(xs - screenDistance), right = cellX(xs + screenDistance);
+  int top = cellY(ys - screenDistance), bottom = cellY(ys + screenDistance);
+
+  for(int cy = top; cy <= bottom; cy++)
+  {
+    for(int cx = left; cx <= right; cx++)
+    {
+      int cell = (type * cellsY + cy) * cellsX + cx;
+      for(int i = cellStart.at(cell); i < cellStart.at(cell + 1); i++)
+      {
+        const Entry& entry = entries.at(i);
+        if(std::abs(entry.x - xs) + std::abs(entry.y - ys) < screenDistance)
+          func(entry);
+      }
+    }
+  }
+}
+
+#endif // LNM_MAPSCREENGRID_H
@@ -126,7 +126,9 @@ void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceI
         QPolygon polygon;
         int x, y;
 
-        const atools::geo::LineString *lines = controller->getAirspaceGeometry(airspace->combinedId());
+        // Use simplified geometry for zoom level
+        const atools::geo::LineString *lines = controller->getAirspaceGeometry(airspace->combinedId(),
+                                                                               mapPaintWidget->viewport());
         if(lines != nullptr)
         {
           for(const Pos& pos : *lines)
@@ -523,7 +525,7 @@ void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, map::MapSear
   result.userAircraft = atools::fs::sc::SimConnectUserAircraft();
   if(shown & map::AIRCRAFT && NavApp::isConnectedAndAircraft())
   {
-    const atools::fs::sc::SimConnectUserAircraft& user = simData.getUserAircraftConst();
+    const atools::fs::sc::SimConnectUserAircraft& user = simData->getUserAircraftConst();
     int x, y;
     if(conv.wToS(user.getPosition(), x, y))
     {
@@ -541,7 +543,7 @@ void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, map::MapSear
   {
     if(shown & map::AIRCRAFT_AI_SHIP && mapLayer->isAiShipLarge())
     {
-      for(const atools::fs::sc::SimConnectAircraft& obj : simData.getAiAircraftConst())
+      for(const atools::fs::sc::SimConnectAircraft& obj : simData->getAiAircraftConst())
       {
         if(obj.getCategory() == atools::fs::sc::BOAT &&
            (obj.getModelRadiusCorrected() * 2 > layer::LARGE_SHIP_SIZE || mapLayer->isAiShipSmall()))
@@ -614,7 +616,7 @@ void MapScreenIndex::getAllNearest(int xs, int ys, int maxDistance, map::MapSear
   mapQuery->getNearestScreenObjects(conv, mapLayer, mapLayerEffective->isAirportDiagram(),
                                     shown & (map::AIRPORT_ALL | map::VOR | map::NDB | map::WAYPOINT | map::MARKER |
                                              map::AIRWAYJ | map::TRACK | map::AIRWAYV | map::USERPOINT | map::LOGBOOK),
-                                    xs, ys, maxDistance, result);
+                                    xs, ys, maxDistance, result, paintLayer->getScreenGrid());
 
   // Update all incomplete objects, especially from search
   for(map::MapAirport& obj : result.airports)
@@ -18,7 +18,7 @@
 #ifndef LITTLENAVMAP_MAPSCREENINDEX_H
 #define LITTLENAVMAP_MAPSCREENINDEX_H
 
-#include "fs/sc/simconnectdata.h"
+#include "connect/simdatasnapshot.h"
 
 #include "route/route.h"
 
@@ -174,30 +174,30 @@ public:
 
   const atools::fs::sc::SimConnectUserAircraft& getUserAircraft() const
   {
-    return simData.getUserAircraftConst();
+    return simData->getUserAircraftConst();
   }
 
   const atools::fs::sc::SimConnectUserAircraft& getLastUserAircraft() const
   {
-    return lastSimData.getUserAircraftConst();
+    return lastSimData->getUserAircraftConst();
   }
 
   const QVector<atools::fs::sc::SimConnectAircraft>& getAiAircraft() const
   {
-    return simData.getAiAircraftConst();
+    return simData->getAiAircraftConst();
   }
 
-  void updateSimData(const atools::fs::sc::SimConnectData& data)
+  void updateSimData(const SimDataSnapshot& data)
   {
     simData = data;
   }
 
   bool isUserAircraftValid() const
   {
-    return simData.getUserAircraftConst().getPosition().isValid();
+    return simData->getUserAircraftConst().getPosition().isValid();
   }
 
-  void updateLastSimData(const atools::fs::sc::SimConnectData& data)
+  void updateLastSimData(const SimDataSnapshot& data)
   {
     lastSimData = data;
   }
@@ -267,7 +267,7 @@ private:
   template<typename TYPE>
   int getNearestIndex(int xs, int ys, int maxDistance, const QList<TYPE>& typeList) const;
 
-  atools::fs::sc::SimConnectData simData, lastSimData;
+  SimDataSnapshot simData, lastSimData;
   MapPaintWidget *mapPaintWidget;
   MapQuery *mapQuery;
   AirwayTrackQuery *airwayQuery;
@@ -47,7 +47,7 @@
 #include "gui/actionstatesaver.h"
 #include "common/jumpback.h"
 #include "route/routealtitude.h"
-#include "fs/sc/simconnectdata.h"
+#include "connect/simdatasnapshot.h"
 #include "connect/connectclient.h"
 #include "common/unit.h"
 #include "common/aircrafttrack.h"
@@ -2690,8 +2690,9 @@ void MapWidget::simDataCalcTakeoffLanding(const atools::fs::sc::SimConnectUserAi
   }
 }
 
-void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+void MapWidget::simDataChanged(const SimDataSnapshot& snapshot)
 {
+  const atools::fs::sc::SimConnectData& simulatorData = *snapshot;
   const atools::fs::sc::SimConnectUserAircraft& aircraft = simulatorData.getUserAircraftConst();
   if(databaseLoadStatus || !aircraft.isValid())
     return;
@@ -2700,7 +2701,7 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
     // Update sun shade on globe with simulator time
     setSunShadingDateTime(aircraft.getZuluTime());
 
-  getScreenIndex()->updateSimData(simulatorData);
+  getScreenIndex()->updateSimData(snapshot);
   const atools::fs::sc::SimConnectUserAircraft& last = getScreenIndexConst()->getLastUserAircraft();
 
   simDataCalcTakeoffLanding(aircraft, last);
@@ -2802,7 +2803,7 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
                                            aircraft.getPosition().getAltitude(), deltas.altitudeDelta); // Altitude has changed
 
       if(dataHasChanged)
-        getScreenIndex()->updateLastSimData(simulatorData);
+        getScreenIndex()->updateLastSimData(snapshot);
 
       // Option to udpate always
       bool updateAlways = od.getFlags() & opts::SIM_UPDATE_MAP_CONSTANTLY;
@@ -2933,7 +2934,7 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
     // No aircraft but track - update track only
     if(!last.isValid() || diff.manhattanLength() > 4)
     {
-      getScreenIndex()->updateLastSimData(simulatorData);
+      getScreenIndex()->updateLastSimData(snapshot);
 
       if(!contextMenuActive)
         update();
@@ -3926,7 +3927,7 @@ void MapWidget::debugMovingPlane(QMouseEvent *event)
                                                                   totalFuel, 10.f);
       data.setPacketId(packetId++);
 
-      emit NavApp::getConnectClient()->dataPacketReceived(data);
+      emit NavApp::getConnectClient()->dataPacketReceived(SimDataSnapshot(data));
       lastPos = pos;
       lastPoint = event->pos();
     }
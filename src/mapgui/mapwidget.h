@@ -29,6 +29,7 @@ class QContextMenuEvent;
 class JumpBack;
 class MainWindow;
 class MapVisible;
+class SimDataSnapshot;
 
 namespace atools {
 namespace sql {
@@ -121,7 +122,7 @@ public:
   virtual void cancelDragAll() override;
 
   /* New data from simconnect has arrived. Update aircraft position and track. */
-  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+  void simDataChanged(const SimDataSnapshot& snapshot);
 
   /* Update sun shading from UI elements */
   void updateSunShadingOption();
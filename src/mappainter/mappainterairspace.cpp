@@ -89,23 +89,17 @@ void MapPainterAirspace::render(PaintContext *context)
 
         // qDebug() << airspace.getId() << airspace.name;
 
-        Marble::GeoDataLinearRing linearRing;
-        linearRing.setTessellate(true);
-
         painter->setPen(mapcolors::penForAirspace(*airspace));
 
         if(!context->drawFast)
           painter->setBrush(mapcolors::colorForAirspaceFill(*airspace));
 
-        const LineString *lines = controller->getAirspaceGeometry(airspace->combinedId());
-
-        if(lines != nullptr)
-        {
-          for(const Pos& pos : *lines)
-            linearRing.append(Marble::GeoDataCoordinates(pos.getLonX(), pos.getLatY(), 0, DEG));
+        // Get prepared ring simplified for the current zoom level
+        const Marble::GeoDataLinearRing *linearRing = controller->getAirspaceRing(airspace->combinedId(),
+                                                                                 context->viewport);
 
-          painter->drawPolygon(linearRing);
-        }
+        if(linearRing != nullptr)
+          painter->drawPolygon(*linearRing);
       }
     }
   }
@@ -25,12 +25,13 @@
 #include "util/paintercontextsaver.h"
 #include "navapp.h"
 #include "atools.h"
-#include "fs/common/morareader.h"
+#include "common/moragrid.h"
 
 #include <QElapsedTimer>
 
 #include <marble/GeoDataLineString.h>
 #include <marble/GeoPainter.h>
+#include <marble/ViewportParams.h>
 
 using namespace Marble;
 using namespace atools::geo;
@@ -47,147 +48,196 @@ MapPainterAltitude::~MapPainterAltitude()
 
 void MapPainterAltitude::render(PaintContext *context)
 {
-  using atools::fs::common::MoraReader;
-
   if(!context->objectDisplayTypes.testFlag(map::MINIMUM_ALTITUDE))
     return;
 
-  if(context->mapLayer->isMinimumAltitude())
+  if(context->mapLayer->isMinimumAltitude() && NavApp::getMoraGrid()->isDataAvailable())
   {
-    MoraReader *moraReader = NavApp::getMoraReader();
-    if(moraReader->isDataAvailable())
+    if(context->drawFast)
+      // Viewport changes with each frame while scrolling - paint directly
+      drawMora(context, context->painter);
+    else
     {
-      atools::util::PainterContextSaver paintContextSaver(context->painter);
-
-      QColor gridCol = mapcolors::minimumAltitudeGridPen.color();
-      gridCol.setAlphaF(1. - context->transparencyMora);
-      QPen pen = mapcolors::minimumAltitudeGridPen;
-      pen.setColor(gridCol);
-      context->painter->setPen(pen);
-
-      // Get covered one degree coordinate rectangles
-      const GeoDataLatLonBox& curBox = context->viewport->viewLatLonAltBox();
-      int west = static_cast<int>(curBox.west(DEG));
-      int east = static_cast<int>(curBox.east(DEG));
-      int north = static_cast<int>(curBox.north(DEG));
-      int south = static_cast<int>(curBox.south(DEG));
-
-      // Split at anit-meridian if needed
-      QVector<std::pair<int, int> > ranges;
-      if(west <= east)
-        ranges.append(std::make_pair(west - 1, east));
-      else
+      PixmapKey key = pixmapKey(context);
+      if(pixmap.isNull() || key != lastKey)
       {
-        ranges.append(std::make_pair(west - 1, 179));
-        ranges.append(std::make_pair(-180, east));
+        // Paint grid into transparent pixmap covering the whole viewport
+        pixmap = QPixmap(atools::roundToInt(key.width * key.pixelRatio),
+                         atools::roundToInt(key.height * key.pixelRatio));
+        pixmap.setDevicePixelRatio(key.pixelRatio);
+        pixmap.fill(Qt::transparent);
+
+        Marble::GeoPainter pixmapPainter(&pixmap, context->viewport);
+        pixmapPainter.setRenderHints(context->painter->renderHints());
+        pixmapPainter.setFont(context->painter->font());
+        drawMora(context, &pixmapPainter);
+        pixmapPainter.end();
+
+        lastKey = key;
       }
+      context->painter->drawPixmap(0, 0, pixmap);
+    }
+  }
+}
 
-      // Altitude values
-      QVector<int> altitudes;
-      // Minimum rectangle width on screen in pixel
-      float minWidth = std::numeric_limits<float>::max();
-      // Center points for rectangles for text placement
-      QVector<GeoDataCoordinates> centers;
+MapPainterAltitude::PixmapKey MapPainterAltitude::pixmapKey(PaintContext *context) const
+{
+  const Marble::ViewportParams *viewport = context->viewport;
+  return {
+    viewport->width(), viewport->height(), viewport->radius(), static_cast<int>(viewport->projection()),
+    NavApp::getMoraGrid()->getGeneration(),
+    viewport->centerLongitude(), viewport->centerLatitude(), context->painter->device()->devicePixelRatioF(),
+    context->transparencyMora, context->textSizeMora,
+    mapcolors::minimumAltitudeGridPen.color().rgba(), mapcolors::minimumAltitudeNumberColor.rgba(),
+    mapcolors::minimumAltitudeGridPen.widthF(),
+    context->painter->testRenderHint(QPainter::Antialiasing)
+  };
+}
+
+bool MapPainterAltitude::PixmapKey::operator==(const PixmapKey& other) const
+{
+  return width == other.width && height == other.height && radius == other.radius &&
+         projection == other.projection && generation == other.generation &&
+         atools::almostEqual(centerLon, other.centerLon) && atools::almostEqual(centerLat, other.centerLat) &&
+         atools::almostEqual(pixelRatio, other.pixelRatio) &&
+         atools::almostEqual(transparency, other.transparency) && atools::almostEqual(textSize, other.textSize) &&
+         gridColor == other.gridColor && textColor == other.textColor &&
+         atools::almostEqual(gridPenWidth, other.gridPenWidth) && antialiasing == other.antialiasing;
+}
 
-      // Draw rectangles and collect other values for text placement ================================
-      Marble::GeoDataLineString line(Marble::Tessellate | Marble::RespectLatitudeCircle);
-      for(int laty = south; laty <= north + 1; laty++)
+void MapPainterAltitude::drawMora(PaintContext *context, Marble::GeoPainter *painter)
+{
+  MoraGrid *moraGrid = NavApp::getMoraGrid();
+
+  atools::util::PainterContextSaver paintContextSaver(painter);
+
+  QColor gridCol = mapcolors::minimumAltitudeGridPen.color();
+  gridCol.setAlphaF(1. - context->transparencyMora);
+  QPen pen = mapcolors::minimumAltitudeGridPen;
+  pen.setColor(gridCol);
+  painter->setPen(pen);
+
+  // Get covered one degree coordinate rectangles
+  const GeoDataLatLonBox& curBox = context->viewport->viewLatLonAltBox();
+  int west = static_cast<int>(curBox.west(DEG));
+  int east = static_cast<int>(curBox.east(DEG));
+  int north = static_cast<int>(curBox.north(DEG));
+  int south = static_cast<int>(curBox.south(DEG));
+
+  // Split at anit-meridian if needed
+  QVector<std::pair<int, int> > ranges;
+  if(west <= east)
+    ranges.append(std::make_pair(west - 1, east));
+  else
+  {
+    ranges.append(std::make_pair(west - 1, 179));
+    ranges.append(std::make_pair(-180, east));
+  }
+
+  // Altitude values
+  QVector<int> altitudes;
+  // Minimum rectangle width on screen in pixel
+  float minWidth = std::numeric_limits<float>::max();
+  // Center points for rectangles for text placement
+  QVector<GeoDataCoordinates> centers;
+
+  // Draw rectangles and collect other values for text placement ================================
+  Marble::GeoDataLineString line(Marble::Tessellate | Marble::RespectLatitudeCircle);
+  for(int laty = south; laty <= north + 1; laty++)
+  {
+    // Iterate over anti-meridian split
+    for(const std::pair<int, int>& range : ranges)
+    {
+      for(int lonx = range.first; lonx <= range.second; lonx++)
       {
-        // Iterate over anti-meridian split
-        for(const std::pair<int, int>& range : ranges)
+        // Special values like ocean or unknown are negative
+        int moraFt100 = moraGrid->getMoraFt(lonx, laty);
+        if(moraFt100 > 10)
         {
-          for(int lonx = range.first; lonx <= range.second; lonx++)
+          // Build rectangle
+          line.clear();
+          line.append(GeoDataCoordinates(lonx, laty, 0, DEG));
+          line.append(GeoDataCoordinates(lonx + 1, laty, 0, DEG));
+          line.append(GeoDataCoordinates(lonx + 1, laty - 1, 0, DEG));
+          line.append(GeoDataCoordinates(lonx, laty - 1, 0, DEG));
+          line.append(GeoDataCoordinates(lonx, laty, 0, DEG));
+          painter->drawPolyline(line);
+
+          if(!context->drawFast)
           {
-            int moraFt100 = moraReader->getMoraFt(lonx, laty);
-            if(moraFt100 > 10 && moraFt100 != MoraReader::OCEAN && moraFt100 != MoraReader::UNKNOWN &&
-               moraFt100 != MoraReader::ERROR)
-            {
-              // Build rectangle
-              line.clear();
-              line.append(GeoDataCoordinates(lonx, laty, 0, DEG));
-              line.append(GeoDataCoordinates(lonx + 1, laty, 0, DEG));
-              line.append(GeoDataCoordinates(lonx + 1, laty - 1, 0, DEG));
-              line.append(GeoDataCoordinates(lonx, laty - 1, 0, DEG));
-              line.append(GeoDataCoordinates(lonx, laty, 0, DEG));
-              context->painter->drawPolyline(line);
-
-              if(!context->drawFast)
-              {
-                // Calculate rectangle screen width
-                bool visibleDummy;
-                QPointF leftPt = wToSF(GeoDataCoordinates(lonx, laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
-                QPointF rightPt =
-                  wToSF(GeoDataCoordinates(lonx + 1., laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
-
-                minWidth = std::min(static_cast<float>(QLineF(leftPt, rightPt).length()), minWidth);
-
-                centers.append(GeoDataCoordinates(lonx + .5, laty - .5, 0, DEG));
-                altitudes.append(moraFt100);
-              }
-            }
-          } // for(int lonx = range.first; lonx <= range.second; lonx++)
-        } // for(const std::pair<int, int>& range : ranges)
-      } // for(int laty = south; laty <= north + 1; laty++)
-
-      // Draw texts =================================================================
-      if(!context->drawFast && minWidth > 20.f)
-      {
-        // Adjust minmum and maximum font height based on rectangle width
-        minWidth = std::max(minWidth * 0.6f, 25.f);
-        minWidth = std::min(minWidth * 0.6f, 150.f);
+            // Calculate rectangle screen width
+            bool visibleDummy;
+            QPointF leftPt = wToSF(GeoDataCoordinates(lonx, laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
+            QPointF rightPt =
+              wToSF(GeoDataCoordinates(lonx + 1., laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
+
+            minWidth = std::min(static_cast<float>(QLineF(leftPt, rightPt).length()), minWidth);
+
+            centers.append(GeoDataCoordinates(lonx + .5, laty - .5, 0, DEG));
+            altitudes.append(moraFt100);
+          }
+        }
+      } // for(int lonx = range.first; lonx <= range.second; lonx++)
+    } // for(const std::pair<int, int>& range : ranges)
+  } // for(int laty = south; laty <= north + 1; laty++)
+
+  // Draw texts =================================================================
+  if(!context->drawFast && minWidth > 20.f)
+  {
+    // Adjust minmum and maximum font height based on rectangle width
+    minWidth = std::max(minWidth * 0.6f, 25.f);
+    minWidth = std::min(minWidth * 0.6f, 150.f);
 
-        QColor textCol = mapcolors::minimumAltitudeNumberColor;
-        textCol.setAlphaF(1. - context->transparencyMora);
-        context->painter->setPen(textCol);
+    QColor textCol = mapcolors::minimumAltitudeNumberColor;
+    textCol.setAlphaF(1. - context->transparencyMora);
+    painter->setPen(textCol);
 
-        float fontSize = minWidth * context->textSizeMora;
-        QFont font = context->painter->font();
-        font.setItalic(true);
-        font.setPixelSize(atools::roundToInt(fontSize));
-        context->painter->setFont(font);
+    float fontSize = minWidth * context->textSizeMora;
+    QFont font = painter->font();
+    font.setItalic(true);
+    font.setPixelSize(atools::roundToInt(fontSize));
+    painter->setFont(font);
 
-        QFontMetricsF fontmetrics = context->painter->fontMetrics();
+    QFontMetricsF fontmetrics = painter->fontMetrics();
 
-        if(fontmetrics.height() > 4)
+    if(fontmetrics.height() > 4)
+    {
+      // Draw big thousands numbers ===============================
+      bool visible, hidden;
+      QVector<QPointF> baseline;
+      for(int i = 0; i < centers.size(); i++)
+      {
+        QPointF pt = wToSF(centers.at(i), DEFAULT_WTOS_SIZE, &visible, &hidden);
+
+        if(!hidden)
         {
-          // Draw big thousands numbers ===============================
-          bool visible, hidden;
-          QVector<QPointF> baseline;
-          for(int i = 0; i < centers.size(); i++)
-          {
-            QPointF pt = wToSF(centers.at(i), DEFAULT_WTOS_SIZE, &visible, &hidden);
-
-            if(!hidden)
-            {
-              QString numTxt = QString::number(altitudes.at(i) / 10);
-              qreal w = fontmetrics.width(numTxt);
-              pt += QPointF(-w * 0.7, fontmetrics.height() / 2. - fontmetrics.descent());
-
-              context->painter->drawText(pt, numTxt);
-              baseline.append(QPointF(pt.x() + w, pt.y()));
-            }
-            else
-              baseline.append(QPointF());
-          }
+          QString numTxt = QString::number(altitudes.at(i) / 10);
+          qreal w = fontmetrics.width(numTxt);
+          pt += QPointF(-w * 0.7, fontmetrics.height() / 2. - fontmetrics.descent());
+
+          painter->drawText(pt, numTxt);
+          baseline.append(QPointF(pt.x() + w, pt.y()));
+        }
+        else
+          baseline.append(QPointF());
+      }
 
-          // Draw smaller hundreds numbers ==============================
-          font.setPixelSize(atools::roundToInt(fontSize * .6f));
-          context->painter->setFont(font);
-          fontmetrics = context->painter->fontMetrics();
+      // Draw smaller hundreds numbers ==============================
+      font.setPixelSize(atools::roundToInt(fontSize * .6f));
+      painter->setFont(font);
+      fontmetrics = painter->fontMetrics();
 
-          for(int i = 0; i < centers.size(); i++)
-          {
-            QPointF pt = baseline.at(i);
-            if(!pt.isNull())
-            {
-              int alt = altitudes.at(i);
-              QString smallNumTxt = QString::number(alt - (alt / 10 * 10));
-              pt.setY(pt.y() + fontmetrics.ascent() / 3.f);
-              context->painter->drawText(pt, smallNumTxt);
-            }
-          }
-        } // if(fontmetrics.height() > ...)
-      } // if(!context->drawFast)
-    } // if(moraReader->isDataAvailable())
-  } // if(context->mapLayer->isMinimumAltitude())
+      for(int i = 0; i < centers.size(); i++)
+      {
+        QPointF pt = baseline.at(i);
+        if(!pt.isNull())
+        {
+          int alt = altitudes.at(i);
+          QString smallNumTxt = QString::number(alt - (alt / 10 * 10));
+          pt.setY(pt.y() + fontmetrics.ascent() / 3.f);
+          painter->drawText(pt, smallNumTxt);
+        }
+      }
+    } // if(fontmetrics.height() > ...)
+  } // if(!context->drawFast)
 }
@@ -20,10 +20,15 @@
 
 #include "mappainter/mappainter.h"
 
+#include <QPixmap>
+
 class SymbolPainter;
 
 /*
- * Draws MORA (minimum off route altitude) data and grid on the map
+ * Draws MORA (minimum off route altitude) data and grid on the map.
+ *
+ * The grid is painted into a pixmap which is reused until viewport, colors or grid change.
+ * Updates caused by aircraft movement only copy the pixmap.
  */
 class MapPainterAltitude :
   public MapPainter
@@ -34,6 +39,32 @@ public:
 
   virtual void render(PaintContext *context) override;
 
+private:
+  /* All values the painted grid depends on */
+  struct PixmapKey
+  {
+    int width, height, radius, projection, generation;
+    qreal centerLon, centerLat, pixelRatio;
+    float transparency, textSize;
+    QRgb gridColor, textColor;
+    qreal gridPenWidth;
+    bool antialiasing;
+
+    bool operator==(const PixmapKey& other) const;
+
+    bool operator!=(const PixmapKey& other) const
+    {
+      return !(*this == other);
+    }
+
+  };
+
+  /* Draw grid lines and numbers using the given painter */
+  void drawMora(PaintContext *context, Marble::GeoPainter *painter);
+  PixmapKey pixmapKey(PaintContext *context) const;
+
+  QPixmap pixmap;
+  PixmapKey lastKey;
 };
 
 #endif // LITTLENAVMAP_MAPPAINTERALTITUDE_H
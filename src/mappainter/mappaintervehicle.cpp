@@ -32,6 +32,8 @@
 
 #include <marble/GeoPainter.h>
 
+#include <limits>
+
 using namespace Marble;
 using namespace atools::geo;
 using namespace map;
@@ -167,11 +169,18 @@ void MapPainterVehicle::paintTrack(const PaintContext *context)
     int x2 = -1, y2 = -1;
     bool hidden1, hidden2;
     QRect vpRect(painter->viewport());
-    wToS(aircraftTrack.first().pos, x1, y1, DEFAULT_WTOS_SIZE, &hidden1);
 
-    for(int i = 1; i < aircraftTrack.size(); i++)
+    // Use simplified track where deviation is not visible - about one pixel
+    float pixelPerNm = scale->getPixelForNm(1.f);
+    float toleranceNm = pixelPerNm > 0.f ? 1.f / pixelPerNm : std::numeric_limits<float>::max();
+    QVector<int> indexes;
+    aircraftTrack.getSimplifiedIndexes(toleranceNm, indexes);
+
+    wToS(aircraftTrack.getPos(indexes.first()), x1, y1, DEFAULT_WTOS_SIZE, &hidden1);
+
+    for(int i = 1; i < indexes.size(); i++)
     {
-      const Pos& trackPos = aircraftTrack.at(i).pos;
+      const Pos trackPos = aircraftTrack.getPos(indexes.at(i));
       wToS(trackPos, x2, y2, DEFAULT_WTOS_SIZE, &hidden2);
 
       QRect rect(QPoint(x1, y1), QPoint(x2, y2));
@@ -25,6 +25,8 @@
 #include "navapp.h"
 #include "fs/weather/metar.h"
 #include "weather/weatherreporter.h"
+#include "connect/connectclient.h"
+#include "fs/sc/weatherrequest.h"
 
 #include <marble/GeoPainter.h>
 #include <marble/ViewportParams.h>
@@ -73,8 +75,10 @@ void MapPainterWeather::render(PaintContext *context)
   }
 
   // ================================
-  // Limit weather display to the 10 most important/biggest airports if connected via network or SimConnect
-  if(NavApp::isConnectedNetwork() || NavApp::isSimConnect())
+  // Request weather for all visible airports at once if connected via network or SimConnect
+  // Biggest airports are requested first
+  if(context->weatherSource == map::WEATHER_SOURCE_SIMULATOR &&
+     (NavApp::isConnectedNetwork() || NavApp::isSimConnect()))
   {
     visibleAirportWeather.erase(std::remove_if(visibleAirportWeather.begin(), visibleAirportWeather.end(),
                                                [](const PaintAirportType& ap) -> bool
@@ -86,7 +90,16 @@ void MapPainterWeather::render(PaintContext *context)
               [](const PaintAirportType& ap1, const PaintAirportType& ap2) {
       return ap1.airport->longestRunwayLength > ap2.airport->longestRunwayLength;
     });
-    visibleAirportWeather = visibleAirportWeather.mid(0, 10);
+
+    QVector<atools::fs::sc::WeatherRequest> requests;
+    for(const PaintAirportType& airportWeather: visibleAirportWeather)
+    {
+      atools::fs::sc::WeatherRequest request;
+      request.setStation(airportWeather.airport->ident);
+      request.setPosition(airportWeather.airport->position);
+      requests.append(request);
+    }
+    NavApp::getConnectClient()->requestWeatherBatch(requests);
   }
 
   // Sort by airport display order
@@ -95,9 +108,10 @@ void MapPainterWeather::render(PaintContext *context)
   WeatherReporter *reporter = NavApp::getWeatherReporter();
   for(const PaintAirportType& airportWeather: visibleAirportWeather)
   {
+    // Simulator weather is requested by the batch above - use cache only to avoid single requests
     atools::fs::weather::Metar metar =
-      reporter->getAirportWeather(airportWeather.airport->ident,
-                                  airportWeather.airport->position, context->weatherSource);
+      reporter->getAirportWeather(airportWeather.airport->ident, airportWeather.airport->position,
+                                  context->weatherSource, false /* requestSimulator */);
 
     if(metar.isValid())
     {
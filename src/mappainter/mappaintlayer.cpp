@@ -36,6 +36,8 @@
 #include "mappainter/mappainteraltitude.h"
 #include "mappainter/mappaintertop.h"
 #include "mapgui/mapscale.h"
+#include "mapgui/mapscreengrid.h"
+#include "query/mapquery.h"
 #include "userdata/userdatacontroller.h"
 #include "route/route.h"
 #include "geo/calculations.h"
@@ -55,6 +57,7 @@ MapPaintLayer::MapPaintLayer(MapPaintWidget *widget, MapQuery *mapQueries)
   initMapLayerSettings();
 
   mapScale = new MapScale();
+  screenGrid = new MapScreenGrid();
 
   // Create all painters
   mapPainterNav = new MapPainterNav(mapWidget, mapScale);
@@ -94,6 +97,7 @@ MapPaintLayer::~MapPaintLayer()
 
   delete layers;
   delete mapScale;
+  delete screenGrid;
 }
 
 void MapPaintLayer::copySettings(const MapPaintLayer& other)
@@ -111,6 +115,7 @@ void MapPaintLayer::copySettings(const MapPaintLayer& other)
 void MapPaintLayer::preDatabaseLoad()
 {
   databaseLoadStatus = true;
+  screenGrid->clear();
 }
 
 void MapPaintLayer::postDatabaseLoad()
@@ -658,6 +663,11 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
 
       mapPainterTop->render(&context);
 
+      if(mapWidget->isVisibleWidget())
+        // Index all objects loaded by the painters for fast hover and click lookup
+        mapQuery->updateScreenGrid(*screenGrid, CoordinateConverter(viewport),
+                                   mapLayerEffective->isAirportDiagram());
+
       if(context.isOverflow())
         overflow = PaintContext::MAX_OBJECT_COUNT;
       else
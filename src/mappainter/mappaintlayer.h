@@ -49,6 +49,7 @@ class MapPainterAltitude;
 class MapPainterWeather;
 class MapPainterWind;
 class MapPaintWidget;
+class MapScreenGrid;
 
 /*
  * Implements the Marble layer interface that paints upon the Marble map. Contains all painter instances
@@ -128,6 +129,12 @@ public:
     weatherSource = value;
   }
 
+  /* Screen grid of cached map objects built after each render. Used to find objects near the cursor. */
+  const MapScreenGrid *getScreenGrid() const
+  {
+    return screenGrid;
+  }
+
   map::MapSunShading getSunShading() const
   {
     return sunShading;
@@ -183,6 +190,7 @@ private:
   MapQuery *mapQuery = nullptr;
 
   MapScale *mapScale = nullptr;
+  MapScreenGrid *screenGrid = nullptr;
   MapLayerSettings *layers = nullptr;
   MapPaintWidget *mapWidget = nullptr;
   const MapLayer *mapLayer = nullptr, *mapLayerEffective = nullptr;
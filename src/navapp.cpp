@@ -30,7 +30,7 @@
 #include "route/routecontroller.h"
 #include "common/elevationprovider.h"
 #include "fs/common/magdecreader.h"
-#include "fs/common/morareader.h"
+#include "common/moragrid.h"
 #include "common/updatehandler.h"
 #include "userdata/userdatacontroller.h"
 #include "logbook/logdatacontroller.h"
@@ -48,6 +48,8 @@
 #include "mapgui/mapmarkhandler.h"
 #include "routestring/routestringwriter.h"
 #include "track/trackcontroller.h"
+#include "common/startuptracer.h"
+#include "sql/sqldatabase.h"
 
 #include "query/waypointquery.h"
 #include "ui_mainwindow.h"
@@ -72,7 +74,7 @@ atools::fs::db::DatabaseMeta *NavApp::databaseMetaNav = nullptr;
 QSplashScreen *NavApp::splashScreen = nullptr;
 
 atools::fs::common::MagDecReader *NavApp::magDecReader = nullptr;
-atools::fs::common::MoraReader *NavApp::moraReader = nullptr;
+MoraGrid *NavApp::moraGrid = nullptr;
 UpdateHandler *NavApp::updateHandler = nullptr;
 UserdataController *NavApp::userdataController = nullptr;
 MapMarkHandler *NavApp::mapMarkHandler = nullptr;
@@ -86,6 +88,9 @@ StyleHandler *NavApp::styleHandler = nullptr;
 
 WebController *NavApp::webController = nullptr;
 
+/* Connection name for reading magnetic declination in background on startup */
+static const QLatin1String DATABASE_NAME_MAGDEC_INIT("LNMDBMAGDECINIT");
+
 bool NavApp::shuttingDown = false;
 bool NavApp::loadingDatabase = false;
 
@@ -118,70 +123,179 @@ void NavApp::init(MainWindow *mainWindowParam)
   qDebug() << Q_FUNC_INFO;
 
   NavApp::mainWindow = mainWindowParam;
-  databaseManager = new DatabaseManager(mainWindow);
-  databaseManager->openAllDatabases(); // Only readonly databases
-
-  userdataController = new UserdataController(databaseManager->getUserdataManager(), mainWindow);
-  logdataController = new LogdataController(databaseManager->getLogdataManager(), mainWindow);
-  mapMarkHandler = new MapMarkHandler(mainWindow);
-
-  databaseMetaSim = new atools::fs::db::DatabaseMeta(getDatabaseSim());
-  databaseMetaNav = new atools::fs::db::DatabaseMeta(getDatabaseNav());
-
-  magDecReader = new atools::fs::common::MagDecReader();
-  readMagDecFromDatabase();
-
-  moraReader = new atools::fs::common::MoraReader(databaseManager->getDatabaseMora());
-  moraReader->readFromTable();
-
-  vehicleIcons = new VehicleIcons();
-
-  // Need to set this later to avoid circular database dependency
-  userdataController->setMagDecReader(magDecReader);
 
-  // Create a CSV backup - not needed since the database is backed up now
-  // userdataController->backup();
-  // Clear temporary userpoints
-  userdataController->clearTemporary();
+  // Run phases in main thread and show progress on splash screen
+  const int numPhases = 10;
+  int phaseNum = 0;
+  auto initPhase = [&phaseNum](const QString& name, const std::function<void()>& func) -> void {
+    setSplashMessage(tr("%1 (%2 of %3) ...").arg(name).arg(++phaseNum).arg(numPhases));
+    StartupTracer::trace(name, func);
+  };
 
-  onlinedataController = new OnlinedataController(databaseManager->getOnlinedataManager(), mainWindow);
-  onlinedataController->initQueries();
+  initPhase(tr("Opening databases"), [ = ]() -> void {
+    databaseManager = new DatabaseManager(mainWindow);
+    databaseManager->openAllDatabases(); // Only readonly databases
 
-  trackController = new TrackController(databaseManager->getTrackManager(), mainWindow);
+    databaseMetaSim = new atools::fs::db::DatabaseMeta(getDatabaseSim());
+    databaseMetaNav = new atools::fs::db::DatabaseMeta(getDatabaseNav());
+  });
 
-  aircraftPerfController = new AircraftPerfController(mainWindow);
-
-  mapQuery = new MapQuery(databaseManager->getDatabaseSim(), databaseManager->getDatabaseNav(),
-                          databaseManager->getDatabaseUser());
-  mapQuery->initQueries();
+  // Read magnetic declination in background using a separate database connection ==========
+  // Independent of the queries and controllers below
+  magDecReader = new atools::fs::common::MagDecReader();
 
-  airspaceController = new AirspaceController(mainWindow,
-                                              databaseManager->getDatabaseSimAirspace(),
-                                              databaseManager->getDatabaseNavAirspace(),
-                                              databaseManager->getDatabaseUserAirspace(),
-                                              databaseManager->getDatabaseOnline());
+  // MORA grid is loaded on demand when first painted
+  moraGrid = new MoraGrid(databaseManager->getDatabaseMora());
 
-  airportQuerySim = new AirportQuery(databaseManager->getDatabaseSim(), false /* nav */);
-  airportQuerySim->initQueries();
+  std::exception_ptr magDecException;
+  QString simDbFile = hasDataInDatabase() ? getDatabaseSim()->databaseName() : QString();
 
-  airportQueryNav = new AirportQuery(databaseManager->getDatabaseNav(), true /* nav */);
-  airportQueryNav->initQueries();
+  QFuture<void> magDecFuture = StartupTracer::traceConcurrent(tr("Magnetic declination"), [&]() -> void {
+    if(simDbFile.isEmpty())
+    {
+      qWarning() << Q_FUNC_INFO << "Empty database falling back to WMM";
+      magDecReader->readFromWmm();
+    }
+    else
+      magDecException = readDatabaseThread(DATABASE_NAME_MAGDEC_INIT, simDbFile,
+                                           [](atools::sql::SqlDatabase& db) -> void {
+        magDecReader->readFromTable(db);
+      });
+  });
+
+  try
+  {
+    initPhase(tr("Loading userpoints and logbook"), [ = ]() -> void {
+      userdataController = new UserdataController(databaseManager->getUserdataManager(), mainWindow);
+      logdataController = new LogdataController(databaseManager->getLogdataManager(), mainWindow);
+      mapMarkHandler = new MapMarkHandler(mainWindow);
+
+      vehicleIcons = new VehicleIcons();
+
+      // Need to set this later to avoid circular database dependency - reader is filled in background
+      userdataController->setMagDecReader(magDecReader);
+
+      // Create a CSV backup - not needed since the database is backed up now
+      // userdataController->backup();
+      // Clear temporary userpoints
+      userdataController->clearTemporary();
+    });
+
+    initPhase(tr("Preparing online network"), [ = ]() -> void {
+      onlinedataController = new OnlinedataController(databaseManager->getOnlinedataManager(), mainWindow);
+      onlinedataController->initQueries();
+    });
+
+    initPhase(tr("Preparing tracks"), [ = ]() -> void {
+      trackController = new TrackController(databaseManager->getTrackManager(), mainWindow);
+    });
+
+    initPhase(tr("Loading aircraft performance"), [ = ]() -> void {
+      aircraftPerfController = new AircraftPerfController(mainWindow);
+    });
+
+    initPhase(tr("Preparing map queries"), [ = ]() -> void {
+      mapQuery = new MapQuery(databaseManager->getDatabaseSim(), databaseManager->getDatabaseNav(),
+                              databaseManager->getDatabaseUser());
+      mapQuery->initQueries();
+    });
+
+    initPhase(tr("Preparing airspaces"), [ = ]() -> void {
+      airspaceController = new AirspaceController(mainWindow,
+                                                  databaseManager->getDatabaseSimAirspace(),
+                                                  databaseManager->getDatabaseNavAirspace(),
+                                                  databaseManager->getDatabaseUserAirspace(),
+                                                  databaseManager->getDatabaseOnline());
+    });
+
+    initPhase(tr("Preparing airport and procedure queries"), [ = ]() -> void {
+      airportQuerySim = new AirportQuery(databaseManager->getDatabaseSim(), false /* nav */);
+      airportQuerySim->initQueries();
+
+      airportQueryNav = new AirportQuery(databaseManager->getDatabaseNav(), true /* nav */);
+      airportQueryNav->initQueries();
+
+      infoQuery = new InfoQuery(databaseManager->getDatabaseSim(),
+                                databaseManager->getDatabaseNav(),
+                                databaseManager->getDatabaseTrack());
+      infoQuery->initQueries();
+
+      procedureQuery = new ProcedureQuery(databaseManager->getDatabaseNav());
+      procedureQuery->initQueries();
+    });
+
+    initPhase(tr("Creating network handlers"), [ = ]() -> void {
+      connectClient = new ConnectClient(mainWindow);
+
+      updateHandler = new UpdateHandler(mainWindow);
+
+      styleHandler = new StyleHandler(mainWindow);
+
+      webController = new WebController(mainWindow);
+    });
+  }
+  catch(...)
+  {
+    // Do not leave background reader running with references to this stack frame
+    magDecFuture.waitForFinished();
+    throw;
+  }
 
-  infoQuery = new InfoQuery(databaseManager->getDatabaseSim(),
-                            databaseManager->getDatabaseNav(),
-                            databaseManager->getDatabaseTrack());
-  infoQuery->initQueries();
+  // Wait for background reader before anything can use declination =============================
+  initPhase(tr("Loading magnetic declination"), [&]() -> void {
+    magDecFuture.waitForFinished();
+  });
 
-  procedureQuery = new ProcedureQuery(databaseManager->getDatabaseNav());
-  procedureQuery->initQueries();
+  if(magDecException)
+  {
+    try
+    {
+      std::rethrow_exception(magDecException);
+    }
+    catch(atools::Exception& e)
+    {
+      deleteSplashScreen();
+      // Show dialog if something went wrong but do not exit
+      atools::gui::ErrorHandler(mainWindow).handleException(e, tr("While reading magnetic declination from database:"));
+    }
+    catch(...)
+    {
+      deleteSplashScreen();
+      atools::gui::ErrorHandler(mainWindow).
+      handleUnknownException(tr("While reading magnetic declination from database:"));
+    }
+  }
 
-  connectClient = new ConnectClient(mainWindow);
+  qDebug() << Q_FUNC_INFO << "Mag decl ref date" << magDecReader->getReferenceDate()
+           << magDecReader->getWmmVersion();
+}
 
-  updateHandler = new UpdateHandler(mainWindow);
+std::exception_ptr NavApp::readDatabaseThread(const QString& connectionName, const QString& filename,
+                                              const std::function<void(atools::sql::SqlDatabase& db)>& func)
+{
+  std::exception_ptr exception;
+  try
+  {
+    atools::sql::SqlDatabase::addDatabase("QSQLITE", connectionName);
 
-  styleHandler = new StyleHandler(mainWindow);
+    {
+      // Separate connection for this thread since connections cannot be shared
+      atools::sql::SqlDatabase db(connectionName);
+      db.setDatabaseName(filename);
+      db.setReadonly();
+      db.open({"PRAGMA busy_timeout=2000"});
+      func(db);
+      db.close();
+    }
+  }
+  catch(...)
+  {
+    // Pass to main thread for error handling
+    exception = std::current_exception();
+  }
 
-  webController = new WebController(mainWindow);
+  atools::sql::SqlDatabase::removeDatabase(connectionName);
+  return exception;
 }
 
 void NavApp::initElevationProvider()
@@ -277,9 +391,9 @@ void NavApp::deInit()
   delete magDecReader;
   magDecReader = nullptr;
 
-  qDebug() << Q_FUNC_INFO << "delete moraReader";
-  delete moraReader;
-  moraReader = nullptr;
+  qDebug() << Q_FUNC_INFO << "delete moraGrid";
+  delete moraGrid;
+  moraGrid = nullptr;
 
   qDebug() << Q_FUNC_INFO << "delete vehicleIcons";
   delete vehicleIcons;
@@ -312,6 +426,7 @@ void NavApp::preDatabaseLoad()
   procedureQuery->deInitQueries();
   airspaceController->preDatabaseLoad();
   trackController->preDatabaseLoad();
+  moraGrid->preDatabaseLoad();
 
   delete databaseMetaSim;
   databaseMetaSim = nullptr;
@@ -360,7 +475,7 @@ void NavApp::postDatabaseLoad()
 
   readMagDecFromDatabase();
 
-  moraReader->readFromTable(*getDatabaseMora());
+  moraGrid->postDatabaseLoad();
 
   airportQuerySim->initQueries();
   airportQueryNav->initQueries();
@@ -733,9 +848,9 @@ StyleHandler *NavApp::getStyleHandler()
   return styleHandler;
 }
 
-atools::fs::common::MoraReader *NavApp::getMoraReader()
+MoraGrid *NavApp::getMoraGrid()
 {
-  return moraReader;
+  return moraGrid;
 }
 
 atools::sql::SqlDatabase *NavApp::getDatabaseUser()
@@ -972,11 +1087,19 @@ void NavApp::initSplashScreen()
 
   processEvents();
 
-  splashScreen->showMessage(QObject::tr("Version %5 (revision %6)").
-                            arg(Application::applicationVersion()).arg(GIT_REVISION),
-                            Qt::AlignRight | Qt::AlignBottom, Qt::white);
+  setSplashMessage(QString());
+}
 
-  processEvents(QEventLoop::ExcludeUserInputEvents);
+void NavApp::setSplashMessage(const QString& message)
+{
+  if(splashScreen != nullptr && splashScreen->isVisible())
+  {
+    QString version = QObject::tr("Version %5 (revision %6)").arg(Application::applicationVersion()).arg(GIT_REVISION);
+    splashScreen->showMessage(message.isEmpty() ? version : message + "\n" + version,
+                              Qt::AlignRight | Qt::AlignBottom, Qt::white);
+
+    processEvents(QEventLoop::ExcludeUserInputEvents);
+  }
 }
 
 void NavApp::finishSplashScreen()
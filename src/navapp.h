@@ -23,6 +23,9 @@
 #include "common/mapflags.h"
 #include "fs/fspaths.h"
 
+#include <exception>
+#include <functional>
+
 class AircraftPerfController;
 class AircraftTrack;
 class AirportQuery;
@@ -42,6 +45,7 @@ class MainWindow;
 class MapPaintWidget;
 class MapQuery;
 class MapWidget;
+class MoraGrid;
 class OnlinedataController;
 class OptionsDialog;
 class ProcedureQuery;
@@ -93,7 +97,6 @@ class LogdataManager;
 
 namespace common {
 class MagDecReader;
-class MoraReader;
 }
 
 namespace db {
@@ -272,6 +275,9 @@ public:
   static void initSplashScreen();
   static void finishSplashScreen();
 
+  /* Show progress message above version on splash screen */
+  static void setSplashMessage(const QString& message);
+
   /* Remove splash when showing error messages, etc. to avoid overlay */
   static void deleteSplashScreen();
 
@@ -300,7 +306,7 @@ public:
 
   static atools::fs::common::MagDecReader *getMagDecReader();
 
-  static atools::fs::common::MoraReader *getMoraReader();
+  static MoraGrid *getMoraGrid();
 
   static VehicleIcons *getVehicleIcons();
 
@@ -332,6 +338,11 @@ private:
   static void initApplication();
   static void readMagDecFromDatabase();
 
+  /* Opens a separate read only connection in the calling thread and passes it to func.
+   * Returns exception thrown while reading or null. */
+  static std::exception_ptr readDatabaseThread(const QString& connectionName, const QString& filename,
+                                               const std::function<void(atools::sql::SqlDatabase& db)>& func);
+
   /* Database query helpers and caches */
   static AirportQuery *airportQuerySim, *airportQueryNav;
   static MapQuery *mapQuery;
@@ -345,7 +356,7 @@ private:
   static atools::fs::common::MagDecReader *magDecReader;
 
   /* minimum off route altitude from nav database */
-  static atools::fs::common::MoraReader *moraReader;
+  static MoraGrid *moraGrid;
   static UserdataController *userdataController;
   static MapMarkHandler *mapMarkHandler;
   static LogdataController *logdataController;
@@ -37,11 +37,15 @@
 #include <QMessageBox>
 #include <QTextCodec>
 #include <QApplication>
+#include <QtConcurrent/QtConcurrentRun>
 
 // #define DEBUG_ONLINE_DOWNLOAD 1
 
 static const int MIN_SERVER_DOWNLOAD_INTERVAL_MIN = 15;
 
+/* Update rate for online aircraft moved by dead reckoning */
+static const int MOTION_UPDATE_MS = 1000;
+
 // Remove if duplicates with same registration if they are this close (500 kts for 3 min)
 #ifdef DEBUG_INFORMATION
 static const int MIN_DISTANCE_DUPLICATE_M = atools::geo::nmToMeter(900);
@@ -86,6 +90,13 @@ OnlinedataController::OnlinedataController(atools::fs::online::OnlinedataManager
   // Recurring downloads
   connect(&downloadTimer, &QTimer::timeout, this, &OnlinedataController::startDownloadInternal);
 
+  // Redraw extrapolated aircraft positions
+  motionTimer.setInterval(MOTION_UPDATE_MS);
+  connect(&motionTimer, &QTimer::timeout, this, &OnlinedataController::onlineClientPositionsUpdated);
+
+  // Notification from thread that whazzup.txt is decoded
+  connect(&whazzupWatcher, &QFutureWatcher<QString>::finished, this, &OnlinedataController::whazzupDecoded);
+
   using namespace std::placeholders;
   manager->setGeometryCallback(std::bind(&OnlinedataController::geometryCallback, this, _1, _2));
 
@@ -98,6 +109,10 @@ OnlinedataController::~OnlinedataController()
 {
   manager->setGeometryCallback(atools::fs::online::GeoCallbackType(nullptr));
 
+  motionTimer.stop();
+  whazzupWatcher.disconnect(this);
+  whazzupWatcher.waitForFinished();
+
   deInitQueries();
 
   delete downloader;
@@ -249,10 +264,44 @@ void OnlinedataController::downloadFinished(const QByteArray& data, QString url)
     }
   }
   else if(currentState == DOWNLOADING_WHAZZUP)
+    // Unzip and decode in background - continues in whazzupDecoded()
+    decodeWhazzup(data);
+  else if(currentState == DOWNLOADING_WHAZZUP_SERVERS)
   {
-    QByteArray whazzupData;
+    manager->readServersFromWhazzup(codec->toUnicode(data),
+                                    convertFormat(OptionData::instance().getOnlineFormat()),
+                                    manager->getLastUpdateTimeFromWhazzup());
+    lastServerDownload = QDateTime::currentDateTime();
+
+    // Done after downloading server.txt - start timer for next session
+    startDownloadTimer();
+    currentState = NONE;
+    lastUpdateTime = QDateTime::currentDateTime();
 
-    if(whazzupGzipped)
+    aircraftCache.clear();
+    simulatorAiRegistrations.clear();
+
+    // Message for search tabs, map widget and info
+    emit onlineClientAndAtcUpdated(false /* load all */, true /* keep selection */);
+    emit onlineServersUpdated(true /* load all */, true /* keep selection */);
+    statusBarMessage();
+  }
+}
+
+void OnlinedataController::decodeWhazzup(const QByteArray& data)
+{
+  if(whazzupWatcher.isRunning())
+    qWarning() << Q_FUNC_INFO << "Decoding still running";
+
+  decodeGeneration = downloadGeneration;
+  bool gzipped = whazzupGzipped;
+  QTextCodec *textCodec = codec;
+
+  // Run unzipping and text conversion in a thread since both can take a while for big files
+  whazzupWatcher.setFuture(QtConcurrent::run([ = ]() -> QString
+  {
+    QByteArray whazzupData;
+    if(gzipped)
     {
       if(!atools::zip::gzipDecompress(data, whazzupData))
         qWarning() << Q_FUNC_INFO << "Error unzipping data";
@@ -260,68 +309,68 @@ void OnlinedataController::downloadFinished(const QByteArray& data, QString url)
     else
       whazzupData = data;
 
-    if(manager->readFromWhazzup(codec->toUnicode(whazzupData),
-                                convertFormat(OptionData::instance().getOnlineFormat()),
-                                manager->getLastUpdateTimeFromWhazzup()))
-    {
-      // Get all callsigns and positions from online list to allow deduplication
-      manager->getClientCallsignAndPosMap(clientCallsignAndPosMap);
-
-      QString whazzupVoiceUrlFromStatus = manager->getWhazzupVoiceUrlFromStatus();
-      if(!whazzupVoiceUrlFromStatus.isEmpty() &&
-         lastServerDownload < QDateTime::currentDateTime().addSecs(-MIN_SERVER_DOWNLOAD_INTERVAL_MIN * 60))
-      {
-        // Next in chain is server file
-        currentState = DOWNLOADING_WHAZZUP_SERVERS;
-        downloader->setUrl(whazzupVoiceUrlFromStatus);
+    return textCodec->toUnicode(whazzupData);
+  }));
+}
 
-        // Call later in the event loop to avoid recursion
-        QTimer::singleShot(0, downloader, &HttpDownloader::startDownload);
-      }
-      else
-      {
-        // Done after downloading whazzup.txt - start timer for next session
-        startDownloadTimer();
-        currentState = NONE;
-        lastUpdateTime = QDateTime::currentDateTime();
+void OnlinedataController::whazzupDecoded()
+{
+  if(currentState != DOWNLOADING_WHAZZUP || decodeGeneration != downloadGeneration)
+  {
+    // Processes were stopped or options changed in the meantime
+    qDebug() << Q_FUNC_INFO << "Dropping decoded whazzup.txt";
+    return;
+  }
 
-        aircraftCache.clear();
-        simulatorAiRegistrations.clear();
+  // Database is bound to this thread - write here
+  if(manager->readFromWhazzup(whazzupWatcher.result(),
+                              convertFormat(OptionData::instance().getOnlineFormat()),
+                              manager->getLastUpdateTimeFromWhazzup()))
+  {
+    // Get all callsigns and positions from online list to allow deduplication
+    manager->getClientCallsignAndPosMap(clientCallsignAndPosMap);
+
+    // Seed dead reckoning with new positions
+    motionModel.update(getDatabase(), manager->getLastUpdateTimeFromWhazzup());
+    if(motionModel.isEmpty())
+      motionTimer.stop();
+    else if(!motionTimer.isActive())
+      motionTimer.start();
+
+    QString whazzupVoiceUrlFromStatus = manager->getWhazzupVoiceUrlFromStatus();
+    if(!whazzupVoiceUrlFromStatus.isEmpty() &&
+       lastServerDownload < QDateTime::currentDateTime().addSecs(-MIN_SERVER_DOWNLOAD_INTERVAL_MIN * 60))
+    {
+      // Next in chain is server file
+      currentState = DOWNLOADING_WHAZZUP_SERVERS;
+      downloader->setUrl(whazzupVoiceUrlFromStatus);
 
-        // Message for search tabs, map widget and info
-        emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
-        statusBarMessage();
-      }
+      // Call later in the event loop to avoid recursion
+      QTimer::singleShot(0, downloader, &HttpDownloader::startDownload);
     }
     else
     {
-      qInfo() << Q_FUNC_INFO << "whazzup.txt is not recent";
-
-      // Done after old update - try again later
+      // Done after downloading whazzup.txt - start timer for next session
       startDownloadTimer();
       currentState = NONE;
       lastUpdateTime = QDateTime::currentDateTime();
+
+      aircraftCache.clear();
+      simulatorAiRegistrations.clear();
+
+      // Message for search tabs, map widget and info
+      emit onlineClientAndAtcUpdated(false /* load all */, true /* keep selection */);
+      statusBarMessage();
     }
   }
-  else if(currentState == DOWNLOADING_WHAZZUP_SERVERS)
+  else
   {
-    manager->readServersFromWhazzup(codec->toUnicode(data),
-                                    convertFormat(OptionData::instance().getOnlineFormat()),
-                                    manager->getLastUpdateTimeFromWhazzup());
-    lastServerDownload = QDateTime::currentDateTime();
+    qInfo() << Q_FUNC_INFO << "whazzup.txt is not recent";
 
-    // Done after downloading server.txt - start timer for next session
+    // Done after old update - try again later
     startDownloadTimer();
     currentState = NONE;
     lastUpdateTime = QDateTime::currentDateTime();
-
-    aircraftCache.clear();
-    simulatorAiRegistrations.clear();
-
-    // Message for search tabs, map widget and info
-    emit onlineClientAndAtcUpdated(true /* load all */, true /* keep selection */);
-    emit onlineServersUpdated(true /* load all */, true /* keep selection */);
-    statusBarMessage();
   }
 }
 
@@ -349,6 +398,9 @@ void OnlinedataController::stopAllProcesses()
   downloader->cancelDownload();
   downloadTimer.stop();
   currentState = NONE;
+
+  // Drop result of a still running decoding thread
+  downloadGeneration++;
   simulatorAiRegistrations.clear();
   clientCallsignAndPosMap.clear();
 }
@@ -394,6 +446,8 @@ void OnlinedataController::optionsChanged()
   aircraftCache.clear();
   simulatorAiRegistrations.clear();
   clientCallsignAndPosMap.clear();
+  motionModel.clear();
+  motionTimer.stop();
 
   updateAtcSizes();
 
@@ -528,6 +582,14 @@ const QList<atools::fs::sc::SimConnectAircraft> *OnlinedataController::getAircra
     simulatorAiRegistrations = curRegistrations;
   }
   aircraftCache.validate(queryMaxRows);
+
+  // Move aircraft to extrapolated positions - all are calculated in one batch
+  if(!motionModel.isEmpty())
+  {
+    motionModel.extrapolate(QDateTime::currentMSecsSinceEpoch());
+    for(atools::fs::sc::SimConnectAircraft& aircraft : aircraftCache.list)
+      aircraft.setPosition(motionModel.getPosition(aircraft.getAirplaneRegistration(), aircraft.getPosition()));
+  }
   return &aircraftCache.list;
 }
 
@@ -19,11 +19,13 @@
 #define LNM_ONLINECONTROLLER_H
 
 #include <QDateTime>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QTimer>
 
 #include "query/querytypes.h"
 #include "fs/online/onlinetypes.h"
+#include "online/onlinemotionmodel.h"
 
 class MapLayer;
 
@@ -143,6 +145,9 @@ signals:
   /* Sent when network changes via options dialog */
   void onlineNetworkChanged();
 
+  /* Sent periodically while online aircraft are moved by dead reckoning between downloads */
+  void onlineClientPositionsUpdated();
+
 private:
   /* HTTP download signal slots */
   void downloadFinished(const QByteArray& data, QString url);
@@ -150,6 +155,11 @@ private:
   void statusBarMessage();
 
   void startDownloadInternal();
+
+  /* Unzip and decode whazzup.txt in background thread. Calls whazzupDecoded when done. */
+  void decodeWhazzup(const QByteArray& data);
+  void whazzupDecoded();
+
   void startDownloadTimer();
   void stopAllProcesses();
   void updateAtcSizes();
@@ -192,6 +202,16 @@ private:
 
   QHash<QString, atools::geo::Pos> clientCallsignAndPosMap;
 
+  /* Extrapolates aircraft positions between downloads */
+  OnlineMotionModel motionModel;
+  QTimer motionTimer;
+
+  /* Decoded whazzup.txt text from background thread */
+  QFutureWatcher<QString> whazzupWatcher;
+
+  /* Incremented when downloads are stopped. Decoded data is dropped if the generation does not match. */
+  int downloadGeneration = 0, decodeGeneration = -1;
+
   query::SimpleRectCache<atools::fs::sc::SimConnectAircraft> aircraftCache;
   atools::sql::SqlQuery *aircraftByRectQuery = nullptr;
 };
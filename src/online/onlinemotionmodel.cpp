@@ -0,0 +1,177 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "online/onlinemotionmodel.h"
+
+#include "geo/pos.h"
+#include "sql/sqlquery.h"
+
+#include <QDateTime>
+#include <QDebug>
+
+#include <cmath>
+
+/* Do not extrapolate further than this if no new whazzup arrives, e.g. on download errors */
+static const float MAX_EXTRAPOLATE_SEC = 600.f;
+
+/* Time to blend from old extrapolated to new reported position */
+static const float BLEND_MS = 5000.f;
+
+/* Drop blending if difference is bigger, e.g. after reconnects at a different position */
+static const float MAX_CORRECTION_DEG = 0.5f;
+
+/* Do not extrapolate aircraft on ground or slower than this */
+static const float MIN_SPEED_KTS = 30.f;
+
+static const float METER_PER_DEG_LAT = 1852.f * 60.f;
+static const float KTS_TO_METER_PER_SEC = 1852.f / 3600.f;
+static const float DEG_TO_RAD = static_cast<float>(M_PI / 180.);
+
+/* Bring longitude difference or value back into -180 to 180 */
+inline static float normalizeLonX(float lonX)
+{
+  if(lonX > 180.f)
+    return lonX - 360.f;
+  else if(lonX < -180.f)
+    return lonX + 360.f;
+  else
+    return lonX;
+}
+
+OnlineMotionModel::OnlineMotionModel()
+{
+
+}
+
+void OnlineMotionModel::update(atools::sql::SqlDatabase *db, const QDateTime& timestamp)
+{
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  // Get current extrapolated positions to blend from
+  extrapolate(now);
+  QHash<QString, int> lastIndex(index);
+  QVector<float> lastLonX(curLonX), lastLatY(curLatY);
+
+  clear();
+  seedTimeMs = timestamp.isValid() ? timestamp.toMSecsSinceEpoch() : now;
+  updateTimeMs = now;
+
+  // Extrapolation time for blending
+  float seedSec = std::min(std::max(static_cast<float>(now - seedTimeMs) / 1000.f, 0.f), MAX_EXTRAPOLATE_SEC);
+
+  atools::sql::SqlQuery query(db);
+  query.exec("select callsign, lonx, laty, groundspeed, heading, on_ground from client "
+             "where lonx is not null and laty is not null");
+  while(query.next())
+  {
+    QString callsign = query.valueStr(0);
+    if(callsign.isEmpty() || index.contains(callsign))
+      continue;
+
+    float lonx = query.valueFloat(1), laty = query.valueFloat(2);
+    float speed = query.valueFloat(3), heading = query.valueFloat(4) * DEG_TO_RAD;
+
+    float lonxPerSec = 0.f, latyPerSec = 0.f;
+    float cosLat = std::cos(laty * DEG_TO_RAD);
+    if(!query.valueBool(5) && speed > MIN_SPEED_KTS && cosLat > 0.01f)
+    {
+      // Flat earth is good enough for the distance flown between two downloads
+      float meterPerSec = speed * KTS_TO_METER_PER_SEC;
+      latyPerSec = meterPerSec * std::cos(heading) / METER_PER_DEG_LAT;
+      lonxPerSec = meterPerSec * std::sin(heading) / (METER_PER_DEG_LAT * cosLat);
+    }
+
+    // Blend from last extrapolated position if client was already known
+    float corrLonx = 0.f, corrLaty = 0.f;
+    int lastIdx = lastIndex.value(callsign, -1);
+    if(lastIdx != -1)
+    {
+      corrLonx = normalizeLonX(lastLonX.at(lastIdx) - (lonx + lonxPerSec * seedSec));
+      corrLaty = lastLatY.at(lastIdx) - (laty + latyPerSec * seedSec);
+
+      if(std::abs(corrLonx) > MAX_CORRECTION_DEG || std::abs(corrLaty) > MAX_CORRECTION_DEG)
+        corrLonx = corrLaty = 0.f;
+    }
+
+    index.insert(callsign, lonX.size());
+    lonX.append(lonx);
+    latY.append(laty);
+    lonXPerSec.append(lonxPerSec);
+    latYPerSec.append(latyPerSec);
+    corrLonX.append(corrLonx);
+    corrLatY.append(corrLaty);
+  }
+
+  curLonX.resize(lonX.size());
+  curLatY.resize(latY.size());
+  extrapolate(now);
+
+  qDebug() << Q_FUNC_INFO << "clients" << index.size() << "seed age sec" << seedSec;
+}
+
+void OnlineMotionModel::clear()
+{
+  index.clear();
+  lonX.clear();
+  latY.clear();
+  lonXPerSec.clear();
+  latYPerSec.clear();
+  corrLonX.clear();
+  corrLatY.clear();
+  curLonX.clear();
+  curLatY.clear();
+  lastExtrapolateTimeMs = -1L;
+}
+
+void OnlineMotionModel::extrapolate(qint64 timeMs)
+{
+  if(timeMs == lastExtrapolateTimeMs)
+    return;
+
+  lastExtrapolateTimeMs = timeMs;
+
+  float sec = std::min(std::max(static_cast<float>(timeMs - seedTimeMs) / 1000.f, 0.f), MAX_EXTRAPOLATE_SEC);
+  float blend = 1.f - std::min(std::max(static_cast<float>(timeMs - updateTimeMs) / BLEND_MS, 0.f), 1.f);
+
+  // Batch over all clients using plain arrays
+  int size = lonX.size();
+  const float *lonx = lonX.constData(), *laty = latY.constData();
+  const float *lonxPerSec = lonXPerSec.constData(), *latyPerSec = latYPerSec.constData();
+  const float *corrLonx = corrLonX.constData(), *corrLaty = corrLatY.constData();
+  float *curLonx = curLonX.data(), *curLaty = curLatY.data();
+
+  for(int i = 0; i < size; i++)
+  {
+    curLonx[i] = lonx[i] + lonxPerSec[i] * sec + corrLonx[i] * blend;
+    curLaty[i] = laty[i] + latyPerSec[i] * sec + corrLaty[i] * blend;
+  }
+
+  for(int i = 0; i < size; i++)
+  {
+    curLonx[i] = normalizeLonX(curLonx[i]);
+    curLaty[i] = std::min(std::max(curLaty[i], -90.f), 90.f);
+  }
+}
+
+atools::geo::Pos OnlineMotionModel::getPosition(const QString& callsign, const atools::geo::Pos& pos) const
+{
+  int idx = index.value(callsign, -1);
+  if(idx == -1 || idx >= curLonX.size())
+    return pos;
+
+  return atools::geo::Pos(curLonX.at(idx), curLatY.at(idx), pos.getAltitude());
+}
@@ -0,0 +1,80 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_ONLINEMOTIONMODEL_H
+#define LNM_ONLINEMOTIONMODEL_H
+
+#include <QHash>
+#include <QVector>
+
+namespace atools {
+namespace geo {
+class Pos;
+}
+namespace sql {
+class SqlDatabase;
+}
+}
+
+class QDateTime;
+
+/*
+ * Dead reckoning for online network aircraft between two whazzup downloads.
+ *
+ * Keeps a copy of callsign, position, groundspeed and heading of all clients as structure of arrays.
+ * Positions are extrapolated in one batch for all clients and blended from the last extrapolated to the newly
+ * reported position when a new whazzup file arrives to avoid jumps.
+ */
+class OnlineMotionModel
+{
+public:
+  OnlineMotionModel();
+
+  /* Load all clients from table client. Positions in the table are valid for the given time in UTC.
+   * Uses current time if timestamp is not valid. */
+  void update(atools::sql::SqlDatabase *db, const QDateTime& timestamp);
+
+  void clear();
+
+  /* Calculate positions for all clients for the given time in milliseconds since epoch.
+   * Does nothing if positions are already calculated for this time. */
+  void extrapolate(qint64 timeMs);
+
+  /* Get extrapolated position for callsign. Returns pos unchanged if client is not known.
+   * Altitude is taken from pos. */
+  atools::geo::Pos getPosition(const QString& callsign, const atools::geo::Pos& pos) const;
+
+  bool isEmpty() const
+  {
+    return index.isEmpty();
+  }
+
+private:
+  /* Callsign to array index */
+  QHash<QString, int> index;
+
+  /* Reported position, velocity in degree per second and correction offset to blend in at seed time */
+  QVector<float> lonX, latY, lonXPerSec, latYPerSec, corrLonX, corrLatY;
+
+  /* Result of last extrapolate() call */
+  QVector<float> curLonX, curLatY;
+
+  /* Time when reported positions were valid and local time when update() was called */
+  qint64 seedTimeMs = 0L, updateTimeMs = 0L, lastExtrapolateTimeMs = -1L;
+};
+
+#endif // LNM_ONLINEMOTIONMODEL_H
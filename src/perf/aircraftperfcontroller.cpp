@@ -44,7 +44,7 @@
 #include "route/routealtitude.h"
 #include "gui/widgetstate.h"
 #include "fs/perf/aircraftperfhandler.h"
-#include "fs/sc/simconnectdata.h"
+#include "connect/simdatasnapshot.h"
 #include "gui/tabwidgethandler.h"
 
 #include <QDebug>
@@ -1124,8 +1124,9 @@ void AircraftPerfController::optionsChanged()
   updateReportCurrent();
 }
 
-void AircraftPerfController::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+void AircraftPerfController::simDataChanged(const SimDataSnapshot& snapshot)
 {
+  const atools::fs::sc::SimConnectData& simulatorData = *snapshot;
   // Pass to handler for averaging
   perfHandler->simDataChanged(simulatorData);
 
@@ -43,6 +43,7 @@ class AircraftPerfHandler;
 }
 
 class MainWindow;
+class SimDataSnapshot;
 
 /*
  * Takes care of aircraft performance managment, loading, saving, generating the report on the flight plan dock.
@@ -92,7 +93,7 @@ public:
   }
 
   /* Updates for automatic performance calculation */
-  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+  void simDataChanged(const SimDataSnapshot& snapshot);
 
   /* Cruise speed knots TAS */
   float getRouteCruiseSpeedKts();
@@ -47,6 +47,9 @@
 #include <QRubberBand>
 #include <QMouseEvent>
 #include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <functional>
 
 #include <marble/ElevationModel.h>
 #include <marble/GeoDataCoordinates.h>
@@ -134,8 +137,9 @@ void ProfileWidget::aircraftTrackPruned()
   update();
 }
 
-void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+void ProfileWidget::simDataChanged(const SimDataSnapshot& snapshot)
 {
+  const atools::fs::sc::SimConnectData& simulatorData = *snapshot;
   if(databaseLoadStatus || !simulatorData.getUserAircraftConst().getPosition().isValid())
     return;
 
@@ -146,10 +150,10 @@ void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulat
   {
     if((showAircraft || showAircraftTrack))
     {
-      simData = simulatorData;
+      simData = snapshot;
 
-      Pos lastPos = lastSimData.getUserAircraftConst().getPosition();
-      Pos simPos = simData.getUserAircraftConst().getPosition();
+      Pos lastPos = lastSimData->getUserAircraftConst().getPosition();
+      Pos simPos = simData->getUserAircraftConst().getPosition();
 
       aircraftDistanceFromStart = route.getProjectionDistance();
 
@@ -160,7 +164,7 @@ void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulat
       if(aircraftDistanceFromStart < map::INVALID_DISTANCE_VALUE)
       {
 #ifdef DEBUG_INFORMATION_PROFILE_SIMDATA
-        if(simData.getUserAircraft().isDebug())
+        if(simData->getUserAircraftConst().isDebug())
           qDebug() << Q_FUNC_INFO << aircraftDistanceFromStart;
 #endif
 
@@ -214,7 +218,7 @@ void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulat
             // Probably center aircraft on scroll area
             if(NavApp::getMainUi()->actionProfileCenterAircraft->isChecked() && !jumpBack->isActive())
               scrollArea->centerAircraft(toScreen(currentPoint),
-                                         simData.getUserAircraftConst().getVerticalSpeedFeetPerMin());
+                                         simData->getUserAircraftConst().getVerticalSpeedFeetPerMin());
 
             // Aircraft position has changed enough
             updateWidget = true;
@@ -225,8 +229,8 @@ void ProfileWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulat
     else
     {
       // Neither aircraft nor track shown - update simulator data only
-      bool valid = simData.getUserAircraftConst().getPosition().isValid();
-      simData = atools::fs::sc::SimConnectData();
+      bool valid = simData->getUserAircraftConst().getPosition().isValid();
+      simData = SimDataSnapshot();
       if(valid)
         updateWidget = true;
     }
@@ -243,7 +247,7 @@ void ProfileWidget::connectedToSimulator()
 {
   qDebug() << Q_FUNC_INFO;
   jumpBack->cancel();
-  simData = atools::fs::sc::SimConnectData();
+  simData = SimDataSnapshot();
   updateScreenCoords();
   update();
   updateLabel();
@@ -253,7 +257,7 @@ void ProfileWidget::disconnectedFromSimulator()
 {
   qDebug() << Q_FUNC_INFO;
   jumpBack->cancel();
-  simData = atools::fs::sc::SimConnectData();
+  simData = SimDataSnapshot();
   updateScreenCoords();
   update();
   updateLabel();
@@ -283,9 +287,9 @@ void ProfileWidget::updateScreenCoords()
   flightplanAltFt = routeController->getRoute().getCruisingAltitudeFeet();
   maxWindowAlt = std::max(minSafeAltitudeFt, flightplanAltFt);
 
-  if(simData.getUserAircraftConst().getPosition().isValid() &&
+  if(simData->getUserAircraftConst().getPosition().isValid() &&
      (showAircraft || showAircraftTrack) && !NavApp::getRouteConst().isFlightplanEmpty())
-    maxWindowAlt = std::max(maxWindowAlt, simData.getUserAircraftConst().getPosition().getAltitude());
+    maxWindowAlt = std::max(maxWindowAlt, simData->getUserAircraftConst().getPosition().getAltitude());
 
   // if(showAircraftTrack)
   // maxWindowAlt = std::max(maxWindowAlt, maxTrackAltitudeFt);
@@ -1136,11 +1140,11 @@ void ProfileWidget::paintEvent(QPaintEvent *)
   }
 
   // Draw user aircraft =========================================================
-  if(simData.getUserAircraftConst().getPosition().isValid() && showAircraft &&
+  if(simData->getUserAircraftConst().getPosition().isValid() && showAircraft &&
      aircraftDistanceFromStart < map::INVALID_DISTANCE_VALUE)
   {
     float acx = distanceX(aircraftDistanceFromStart);
-    float acy = altitudeY(simData.getUserAircraftConst().getPosition().getAltitude());
+    float acy = altitudeY(simData->getUserAircraftConst().getPosition().getAltitude());
 
     // Draw aircraft symbol
     int acsize = atools::roundToInt(optData.getDisplaySymbolSizeAircraftUser() / 100. * 32.);
@@ -1154,14 +1158,14 @@ void ProfileWidget::paintEvent(QPaintEvent *)
       // Reflection is a special case of scaling matrix
       painter.scale(1., -1.);
 
-    const QPixmap *pixmap = NavApp::getVehicleIcons()->pixmapFromCache(simData.getUserAircraftConst(), acsize, 0);
+    const QPixmap *pixmap = NavApp::getVehicleIcons()->pixmapFromCache(simData->getUserAircraftConst(), acsize, 0);
     painter.drawPixmap(QPointF(-acsize / 2., -acsize / 2.), *pixmap);
     painter.resetTransform();
 
     // Draw aircraft label
     mapcolors::scaleFont(&painter, optData.getDisplayTextSizeAircraftUser() / 100.f, &defaultFont);
 
-    int vspeed = atools::roundToInt(simData.getUserAircraftConst().getVerticalSpeedFeetPerMin());
+    int vspeed = atools::roundToInt(simData->getUserAircraftConst().getVerticalSpeedFeetPerMin());
     QString upDown;
     if(vspeed > 100.f)
       upDown = tr(" ▲");
@@ -1169,7 +1173,7 @@ void ProfileWidget::paintEvent(QPaintEvent *)
       upDown = tr(" ▼");
 
     QStringList texts;
-    texts.append(Unit::altFeet(simData.getUserAircraftConst().getPosition().getAltitude()));
+    texts.append(Unit::altFeet(simData->getUserAircraftConst().getPosition().getAltitude()));
 
     if(vspeed > 10.f || vspeed < -10.f)
       texts.append(Unit::speedVertFpm(vspeed) + upDown);
@@ -1318,20 +1322,21 @@ bool ProfileWidget::fetchRouteElevations(atools::geo::LineString& elevations,
     QVector<Marble::GeoDataLineString *> coordsCorrected = coords.toDateLineCorrected();
     for(const Marble::GeoDataLineString *ls : coordsCorrected)
     {
-      for(int j = 1; j < ls->size(); j++)
+      if(terminateThreadSignal)
       {
-        if(terminateThreadSignal)
-          return false;
-
-        const Marble::GeoDataCoordinates& c1 = ls->at(j - 1);
-        const Marble::GeoDataCoordinates& c2 = ls->at(j);
-        Pos p1(c1.longitude(), c1.latitude());
-        Pos p2(c2.longitude(), c2.latitude());
+        qDeleteAll(coordsCorrected);
+        return false;
+      }
 
-        p1.toDeg();
-        p2.toDeg();
-        elevationProvider->getElevations(elevations, atools::geo::Line(p1, p2));
+      // Fetch all segments of the part in one call
+      LineString part;
+      for(const Marble::GeoDataCoordinates& c : *ls)
+      {
+        Pos pos(c.longitude(), c.latitude());
+        pos.toDeg();
+        part.append(pos);
       }
+      elevationProvider->getElevations(elevations, part);
     }
     qDeleteAll(coordsCorrected);
   }
@@ -1367,34 +1372,73 @@ ProfileWidget::ElevationLegList ProfileWidget::fetchRouteElevationsThread(Elevat
     // Return empty result
     return ElevationLegList();
 
-  // Loop over all route legs
+  // Collect indexes of all legs to calculate
+  QVector<int> legIndexes;
   for(int i = 1; i <= legs.route.getDestinationLegIndex(); i++)
   {
-    if(terminateThreadSignal)
-      // Return empty result
-      return ElevationLegList();
-
     const RouteLeg& routeLeg = legs.route.value(i);
     if(routeLeg.getProcedureLeg().isMissed() || routeLeg.isAlternate())
       break;
+    legIndexes.append(i);
+  }
 
-    const RouteLeg& lastLeg = legs.route.value(i - 1);
-    ElevationLeg leg;
+  ElevationProvider *elevationProvider = NavApp::getElevationProvider();
+  bool offline = elevationProvider->isGlobeOfflineProvider();
 
-    // Skip for too long segments when using the marble online provider
-    if(routeLeg.getDistanceTo() < ELEVATION_MAX_LEG_NM || NavApp::getElevationProvider()->isGlobeOfflineProvider())
+  // Fetch elevation points for one leg - empty if leg is too long for the online provider
+  std::function<LineString(int)> fetchLeg = [ =, &legs](int index) -> LineString
+  {
+    const RouteLeg& routeLeg = legs.route.value(index);
+    LineString elevations;
+    if(routeLeg.getDistanceTo() < ELEVATION_MAX_LEG_NM || offline)
     {
       LineString geometry;
       if(routeLeg.isAnyProcedure() && routeLeg.getGeometry().size() > 2)
         geometry = routeLeg.getGeometry();
       else
-        geometry << lastLeg.getPosition() << routeLeg.getPosition();
+        geometry << legs.route.value(index - 1).getPosition() << routeLeg.getPosition();
 
       geometry.removeInvalid();
+      fetchRouteElevations(elevations, geometry);
+    }
+    return elevations;
+  };
+
+  // Legs are independent of each other. Offline GLOBE data can be read concurrently, so use all cores.
+  // The Marble online provider is not thread safe.
+  QVector<LineString> legElevations;
+  if(offline)
+    legElevations = QtConcurrent::blockingMapped<QVector<LineString> >(legIndexes, fetchLeg);
+  else
+  {
+    for(int index : legIndexes)
+    {
+      legElevations.append(fetchLeg(index));
+      if(terminateThreadSignal)
+        break;
+    }
+  }
 
-      LineString elevations;
-      if(!fetchRouteElevations(elevations, geometry))
-        return ElevationLegList();
+  if(terminateThreadSignal)
+    // Return empty result
+    return ElevationLegList();
+
+  // Loop over all route legs and calculate distances and maximum
+  for(int k = 0; k < legIndexes.size(); k++)
+  {
+    if(terminateThreadSignal)
+      // Return empty result
+      return ElevationLegList();
+
+    int i = legIndexes.at(k);
+    const RouteLeg& routeLeg = legs.route.value(i);
+    const RouteLeg& lastLeg = legs.route.value(i - 1);
+    ElevationLeg leg;
+
+    // Skip for too long segments when using the marble online provider
+    if(routeLeg.getDistanceTo() < ELEVATION_MAX_LEG_NM || offline)
+    {
+      LineString elevations = legElevations.at(k);
 
       float dist = legs.totalDistance;
       // Loop over all elevation points for the current leg
@@ -1736,7 +1780,7 @@ void ProfileWidget::updateLabel()
 {
   float distFromStartNm = 0.f, distToDestNm = 0.f, nearestLegDistance = 0.f;
 
-  if(simData.getUserAircraftConst().getPosition().isValid())
+  if(simData->getUserAircraftConst().getPosition().isValid())
   {
     if(routeController->getRoute().getRouteDistances(&distFromStartNm, &distToDestNm, &nearestLegDistance))
     {
@@ -1920,8 +1964,8 @@ void ProfileWidget::jumpBackToAircraftTimeout()
     {
       jumpBack->cancel();
 
-      QPoint pt = toScreen(QPointF(aircraftDistanceFromStart, simData.getUserAircraft().getPosition().getAltitude()));
-      bool centered = scrollArea->centerAircraft(pt, simData.getUserAircraft().getVerticalSpeedFeetPerMin());
+      QPoint pt = toScreen(QPointF(aircraftDistanceFromStart, simData->getUserAircraftConst().getPosition().getAltitude()));
+      bool centered = scrollArea->centerAircraft(pt, simData->getUserAircraftConst().getVerticalSpeedFeetPerMin());
 
       if(centered)
         NavApp::setStatusMessage(tr("Jumped back to aircraft."));
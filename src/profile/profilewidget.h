@@ -19,7 +19,7 @@
 #define LITTLENAVMAP_PROFILEWIDGET_H
 
 #include "route/route.h"
-#include "fs/sc/simconnectdata.h"
+#include "connect/simdatasnapshot.h"
 
 #include <QFuture>
 #include <QFutureWatcher>
@@ -65,7 +65,7 @@ public:
   void routeAltitudeChanged(int altitudeFeet);
 
   /* Update user aircraft on profile display */
-  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+  void simDataChanged(const SimDataSnapshot& snapshot);
 
   /* Track was shortened and needs a full update */
   void aircraftTrackPruned();
@@ -249,7 +249,7 @@ private:
   static Q_DECL_CONSTEXPR int ELEVATION_MAX_LEG_NM = 2000;
 
   /* User aircraft data */
-  atools::fs::sc::SimConnectData simData, lastSimData;
+  SimDataSnapshot simData, lastSimData;
 
   /* Track x = distance from start in NM and y = altitude in feet */
   QPolygonF aircraftTrackPoints;
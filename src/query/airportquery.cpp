@@ -356,7 +356,9 @@ const QList<map::MapParking> *AirportQuery::getParkingsForAirport(int airportId)
       mapTypesFactory->fillParking(parkingQuery->record(), p);
       ps->append(p);
     }
+    // Insert can remove other entries
     parkingCache.insert(airportId, ps);
+    parkingGeneration++;
     return ps;
   }
 }
@@ -566,6 +568,7 @@ const QList<map::MapHelipad> *AirportQuery::getHelipads(int airportId)
       hs->append(hp);
     }
     helipadCache.insert(airportId, hs);
+    helipadGeneration++;
     return hs;
   }
 }
@@ -1024,8 +1027,10 @@ void AirportQuery::deInitQueries()
   apronCache.clear();
   taxipathCache.clear();
   parkingCache.clear();
+  parkingGeneration++;
   startCache.clear();
   helipadCache.clear();
+  helipadGeneration++;
   airportIdentCache.clear();
   airportIdCache.clear();
 
@@ -1091,23 +1096,3 @@ void AirportQuery::deInitQueries()
   delete runwayEndByNameQuery;
   runwayEndByNameQuery = nullptr;
 }
-
-QHash<int, QList<map::MapParking> > AirportQuery::getParkingCache() const
-{
-  QHash<int, QList<map::MapParking> > retval;
-
-  for(int key : parkingCache.keys())
-    retval.insert(key, *parkingCache.object(key));
-
-  return retval;
-}
-
-QHash<int, QList<map::MapHelipad> > AirportQuery::getHelipadCache() const
-{
-  QHash<int, QList<map::MapHelipad> > retval;
-
-  for(int key : helipadCache.keys())
-    retval.insert(key, *helipadCache.object(key));
-
-  return retval;
-}
@@ -148,9 +148,27 @@ public:
   /* Create and prepare all queries */
   void deInitQueries();
 
-  QHash<int, QList<map::MapParking> > getParkingCache() const;
+  /* Parking and helipads by airport id. Use in place - do not keep pointers to objects in cache. */
+  const QCache<int, QList<map::MapParking> >& getParkingCache() const
+  {
+    return parkingCache;
+  }
+
+  const QCache<int, QList<map::MapHelipad> >& getHelipadCache() const
+  {
+    return helipadCache;
+  }
 
-  QHash<int, QList<map::MapHelipad> > getHelipadCache() const;
+  /* Incremented each time the content of the parking or helipad cache changes */
+  quint32 getParkingGeneration() const
+  {
+    return parkingGeneration;
+  }
+
+  quint32 getHelipadGeneration() const
+  {
+    return helipadGeneration;
+  }
 
   static QStringList airportColumns(const atools::sql::SqlDatabase *db);
   static QStringList airportOverviewColumns(const atools::sql::SqlDatabase *db);
@@ -204,6 +222,7 @@ private:
   QCache<int, QList<map::MapParking> > parkingCache;
   QCache<int, QList<map::MapStart> > startCache;
   QCache<int, QList<map::MapHelipad> > helipadCache;
+  quint32 parkingGeneration = 0, helipadGeneration = 0;
 
   QCache<QString, map::MapAirport> airportIdentCache;
   QCache<int, map::MapAirport> airportIdCache;
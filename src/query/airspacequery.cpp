@@ -135,23 +135,8 @@ const QList<map::MapAirspace> *AirspaceQuery::getAirspaces(const GeoDataLatLonBo
 
   if(airspaceCache.list.isEmpty() && !lazy)
   {
-    QStringList typeStrings;
-
     if(filter.types != map::AIRSPACE_NONE)
     {
-      // Build a list of query strings based on the bitfield
-      if(filter.types == map::AIRSPACE_ALL)
-        typeStrings.append("%");
-      else
-      {
-        for(int i = 0; i <= map::MAP_AIRSPACE_TYPE_BITS; i++)
-        {
-          map::MapAirspaceTypes t(1 << i);
-          if(filter.types & t)
-            typeStrings.append(map::airspaceTypeToDatabase(t));
-        }
-      }
-
       SqlQuery *query = nullptr;
       int alt;
       if(filter.flags & map::AIRSPACE_AT_FLIGHTPLAN)
@@ -189,44 +174,47 @@ const QList<map::MapAirspace> *AirspaceQuery::getAirspaces(const GeoDataLatLonBo
 
       // qDebug() << rect.toString(GeoDataCoordinates::Degree);
 
-      // Get the airspace objects without geometry
-      for(const GeoDataLatLonBox& r :
-          query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+      // Get the airspace objects without geometry - one query for all types which returns rows in drawing order
+      const QList<GeoDataLatLonBox> rects =
+        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement);
+      for(const GeoDataLatLonBox& r : rects)
       {
         // qDebug() << r.toString(GeoDataCoordinates::Degree);
 
-        for(const QString& typeStr : typeStrings)
-        {
-          query::bindRect(r, query);
-          query->bindValue(":type", typeStr);
+        query::bindRect(r, query);
+
+        if(alt > 0)
+          query->bindValue(":alt", alt);
 
-          if(alt > 0)
-            query->bindValue(":alt", alt);
+        // qDebug() << "==================== query" << endl << query->getFullQueryString();
 
-          // qDebug() << "==================== query" << endl << query->getFullQueryString();
+        query->exec();
+        while(query->next())
+        {
+          // Filter by type bitmask before creating the object
+          if(filter.types != map::AIRSPACE_ALL &&
+             !(map::airspaceTypeFromDatabase(query->valueStr("type")) & filter.types))
+            continue;
 
-          query->exec();
-          while(query->next())
-          {
-            // Avoid double airspaces which can happen if they cross the date boundary
-            if(ids.contains(query->valueInt("boundary_id")))
-              continue;
+          // Avoid double airspaces which can happen if they cross the date boundary
+          if(ids.contains(query->valueInt("boundary_id")))
+            continue;
 
-            map::MapAirspace airspace;
-            mapTypesFactory->fillAirspace(query->record(), airspace, source);
-            airspaceCache.list.append(airspace);
+          map::MapAirspace airspace;
+          mapTypesFactory->fillAirspace(query->record(), airspace, source);
+          airspaceCache.list.append(airspace);
 
-            ids.insert(airspace.id);
-          }
+          ids.insert(airspace.id);
         }
       }
 
-      // Sort by importance
-      std::sort(airspaceCache.list.begin(), airspaceCache.list.end(),
-                [](const map::MapAirspace& airspace1, const map::MapAirspace& airspace2) -> bool
-      {
-        return map::airspaceDrawingOrder(airspace1.type) < map::airspaceDrawingOrder(airspace2.type);
-      });
+      if(rects.size() > 1)
+        // Merge results from both sides of the anti-meridian - sort by importance
+        std::stable_sort(airspaceCache.list.begin(), airspaceCache.list.end(),
+                         [](const map::MapAirspace& airspace1, const map::MapAirspace& airspace2) -> bool
+        {
+          return map::airspaceDrawingOrder(airspace1.type) < map::airspaceDrawingOrder(airspace2.type);
+        });
     }
   }
   airspaceCache.validate(queryMaxRows);
@@ -333,6 +321,21 @@ LineString *AirspaceQuery::getAirspaceGeometryByName(const QString& callsign, co
   return nullptr;
 }
 
+void AirspaceQuery::getAllAirspaces(QVector<map::MapAirspace>& airspaces)
+{
+  if(airspaceAllQuery != nullptr && hasAirspaces)
+  {
+    airspaceAllQuery->exec();
+    while(airspaceAllQuery->next())
+    {
+      map::MapAirspace airspace;
+      mapTypesFactory->fillAirspace(airspaceAllQuery->record(), airspace, source);
+      airspaces.append(airspace);
+    }
+    airspaceAllQuery->finish();
+  }
+}
+
 SqlRecord AirspaceQuery::getAirspaceInfoRecordById(int airspaceId)
 {
   SqlRecord retval;
@@ -409,22 +412,33 @@ void AirspaceQuery::initQueries()
   // Get all that are crossing the anti meridian too and filter them out from the query result
   QString airspaceRect =
     " (not (max_lonx < :leftx or min_lonx > :rightx or "
-    "min_laty > :topy or max_laty < :bottomy) or max_lonx < min_lonx) and ";
+    "min_laty > :topy or max_laty < :bottomy) or max_lonx < min_lonx) ";
+
+  // Return rows sorted by drawing order of airspace type - lower values are drawn first
+  QString orderBy = " order by case type ";
+  for(int i = 0; i <= map::MAP_AIRSPACE_TYPE_BITS; i++)
+  {
+    map::MapAirspaceTypes t(1 << i);
+    const QString& typeStr = map::airspaceTypeToDatabase(t);
+    if(!typeStr.isEmpty())
+      orderBy += QString("when '%1' then %2 ").arg(typeStr).arg(map::airspaceDrawingOrder(t));
+  }
+  orderBy += "else 0 end";
 
   airspaceByRectQuery = new SqlQuery(db);
   airspaceByRectQuery->prepare(
     "select " + airspaceQueryBase + "from " + table +
-    " where " + airspaceRect + " type like :type");
+    " where " + airspaceRect + orderBy);
 
   airspaceByRectBelowAltQuery = new SqlQuery(db);
   airspaceByRectBelowAltQuery->prepare(
     "select " + airspaceQueryBase + "from " + table +
-    " where " + airspaceRect + " type like :type and min_altitude < :alt");
+    " where " + airspaceRect + " and min_altitude < :alt" + orderBy);
 
   airspaceByRectAboveAltQuery = new SqlQuery(db);
   airspaceByRectAboveAltQuery->prepare(
     "select " + airspaceQueryBase + "from " + table +
-    " where " + airspaceRect + " type like :type and max_altitude > :alt");
+    " where " + airspaceRect + " and max_altitude > :alt" + orderBy);
 
   airspaceByRectAtAltQuery = new SqlQuery(db);
   airspaceByRectAtAltQuery->prepare(
@@ -432,8 +446,10 @@ void AirspaceQuery::initQueries()
     " where "
     "not (max_lonx < :leftx or min_lonx > :rightx or "
     "min_laty > :topy or max_laty < :bottomy) and "
-    "type like :type and "
-    ":alt between min_altitude and max_altitude");
+    ":alt between min_altitude and max_altitude" + orderBy);
+
+  airspaceAllQuery = new SqlQuery(db);
+  airspaceAllQuery->prepare("select " + airspaceQueryBase + " from " + table);
 
   airspaceLinesByIdQuery = new SqlQuery(db);
   airspaceLinesByIdQuery->prepare("select geometry from " + table + " where " + id + " = :id");
@@ -477,6 +493,9 @@ void AirspaceQuery::deInitQueries()
 
   delete airspaceInfoQuery;
   airspaceInfoQuery = nullptr;
+
+  delete airspaceAllQuery;
+  airspaceAllQuery = nullptr;
 }
 
 void AirspaceQuery::clearCache()
@@ -31,6 +31,7 @@
 #include "navapp.h"
 #include "settings/settings.h"
 #include "db/databasemanager.h"
+#include "mapgui/mapscreengrid.h"
 
 using namespace Marble;
 using namespace atools::sql;
@@ -63,6 +64,15 @@ MapQuery::MapQuery(atools::sql::SqlDatabase *sqlDb, SqlDatabase *sqlDbNav, SqlDa
     lnm::SETTINGS_MAPQUERY + "QueryRectInflationIncrement", 0.1).toDouble();
   queryMaxRows = settings.getAndStoreValue(
     lnm::SETTINGS_MAPQUERY + "QueryRowLimit", 5000).toInt();
+
+  // Maximum number of objects kept in all tiles for each type
+  int tileCacheMaxObjects = settings.getAndStoreValue(
+    lnm::SETTINGS_MAPQUERY + "TileCacheMaxObjects", 50000).toInt();
+  airportCache.setMaxObjects(tileCacheMaxObjects);
+  vorCache.setMaxObjects(tileCacheMaxObjects);
+  ndbCache.setMaxObjects(tileCacheMaxObjects);
+  markerCache.setMaxObjects(tileCacheMaxObjects);
+  ilsCache.setMaxObjects(tileCacheMaxObjects);
 }
 
 MapQuery::~MapQuery()
@@ -486,70 +496,206 @@ QVector<map::MapIls> MapQuery::ilsByAirportAndRunway(const QString& airportIdent
   return ilsList;
 }
 
+/* Add screen coordinates of all objects in list to grid */
+template<typename TYPE, typename POSFUNC>
+void addToScreenGrid(MapScreenGrid& grid, const CoordinateConverter& conv, MapScreenGrid::Type type,
+                     const QList<TYPE>& list, quint32 generation, POSFUNC posFunc)
+{
+  int x, y;
+  for(int i = 0; i < list.size(); i++)
+  {
+    if(conv.wToS(posFunc(list.at(i)), x, y))
+      grid.add(type, x, y, i);
+  }
+  grid.setGeneration(type, generation);
+}
+
+/* Call func for all objects in list near xs/ys. Uses the grid if valid or falls back to a linear search */
+template<typename TYPE, typename POSFUNC, typename FUNC>
+void forEachNearestScreen(const CoordinateConverter& conv, const MapScreenGrid *grid, MapScreenGrid::Type type,
+                          const QList<TYPE>& list, quint32 generation, int xs, int ys, int screenDistance,
+                          POSFUNC posFunc, FUNC func)
+{
+  if(grid != nullptr && grid->isValid(conv.getViewport(), type, generation, screenDistance))
+  {
+    grid->forEachNearest(type, xs, ys, screenDistance, [&list, &func](const MapScreenGrid::Entry& entry) {
+      if(entry.index < list.size())
+        func(list.at(entry.index));
+    });
+  }
+  else
+  {
+    int x, y;
+    for(int i = list.size() - 1; i >= 0; i--)
+    {
+      const TYPE& obj = list.at(i);
+      if(conv.wToS(posFunc(obj), x, y))
+        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
+          func(obj);
+    }
+  }
+}
+
+/* Same as above for parking and helipads which are used in place from the airport query cache */
+template<typename TYPE, typename FUNC>
+void forEachNearestScreenAirportCache(const CoordinateConverter& conv, const MapScreenGrid *grid,
+                                      MapScreenGrid::Type type, const QCache<int, QList<TYPE> >& cache,
+                                      quint32 generation, int xs, int ys, int screenDistance, FUNC func)
+{
+  if(grid != nullptr && grid->isValid(conv.getViewport(), type, generation, screenDistance))
+  {
+    grid->forEachNearest(type, xs, ys, screenDistance, [&cache, &func](const MapScreenGrid::Entry& entry) {
+      const QList<TYPE> *list = cache.object(entry.id);
+      if(list != nullptr && entry.index < list->size())
+        func(list->at(entry.index));
+    });
+  }
+  else
+  {
+    int x, y;
+    for(int id : cache.keys())
+    {
+      for(const TYPE& obj : *cache.object(id))
+      {
+        if(conv.wToS(obj.position, x, y) && atools::geo::manhattanDistance(x, y, xs, ys) < screenDistance)
+          func(obj);
+      }
+    }
+  }
+}
+
+void MapQuery::updateScreenGrid(MapScreenGrid& grid, const CoordinateConverter& conv, bool airportDiagram)
+{
+  grid.reset(conv.getViewport());
+
+  addToScreenGrid(grid, conv, MapScreenGrid::AIRPORT, airportCache.list, airportCache.generation,
+                  [](const MapAirport& obj) -> const Pos& {
+    return obj.position;
+  });
+
+  addToScreenGrid(grid, conv, MapScreenGrid::VOR, vorCache.list, vorCache.generation,
+                  [](const MapVor& obj) -> const Pos& {
+    return obj.position;
+  });
+
+  addToScreenGrid(grid, conv, MapScreenGrid::NDB, ndbCache.list, ndbCache.generation,
+                  [](const MapNdb& obj) -> const Pos& {
+    return obj.position;
+  });
+
+  addToScreenGrid(grid, conv, MapScreenGrid::USERPOINT, userpointCache.list, userpointCache.generation,
+                  [](const MapUserpoint& obj) -> const Pos& {
+    return obj.position;
+  });
+
+  addToScreenGrid(grid, conv, MapScreenGrid::MARKER, markerCache.list, markerCache.generation,
+                  [](const MapMarker& obj) -> const Pos& {
+    return obj.position;
+  });
+
+  addToScreenGrid(grid, conv, MapScreenGrid::ILS, ilsCache.list, ilsCache.generation,
+                  [](const MapIls& obj) -> const Pos& {
+    return obj.position;
+  });
+
+  if(airportDiagram)
+  {
+    // Tower, parking and helipads are only needed for airport diagrams
+    addToScreenGrid(grid, conv, MapScreenGrid::AIRPORT_TOWER, airportCache.list, airportCache.generation,
+                    [](const MapAirport& obj) -> const Pos& {
+      return obj.towerCoords;
+    });
+
+    int x, y;
+    const AirportQuery *airportQuery = NavApp::getAirportQuerySim();
+    const QCache<int, QList<map::MapParking> >& parkingCache = airportQuery->getParkingCache();
+    for(int id : parkingCache.keys())
+    {
+      const QList<MapParking>& parkings = *parkingCache.object(id);
+      for(int i = 0; i < parkings.size(); i++)
+      {
+        if(conv.wToS(parkings.at(i).position, x, y))
+          grid.add(MapScreenGrid::PARKING, x, y, i, id);
+      }
+    }
+    grid.setGeneration(MapScreenGrid::PARKING, airportQuery->getParkingGeneration());
+
+    const QCache<int, QList<map::MapHelipad> >& helipadCache = airportQuery->getHelipadCache();
+    for(int id : helipadCache.keys())
+    {
+      const QList<MapHelipad>& helipads = *helipadCache.object(id);
+      for(int i = 0; i < helipads.size(); i++)
+      {
+        if(conv.wToS(helipads.at(i).position, x, y))
+          grid.add(MapScreenGrid::HELIPAD, x, y, i, id);
+      }
+    }
+    grid.setGeneration(MapScreenGrid::HELIPAD, airportQuery->getHelipadGeneration());
+  }
+
+  grid.finish();
+}
+
 void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const MapLayer *mapLayer,
                                        bool airportDiagram, map::MapObjectTypes types,
                                        int xs, int ys, int screenDistance,
-                                       map::MapSearchResult& result)
+                                       map::MapSearchResult& result, const MapScreenGrid *grid)
 {
   using maptools::insertSortedByDistance;
   using maptools::insertSortedByTowerDistance;
 
-  int x, y;
   if(mapLayer->isAirport() && types.testFlag(map::AIRPORT))
   {
-    for(int i = airportCache.list.size() - 1; i >= 0; i--)
-    {
-      const MapAirport& airport = airportCache.list.at(i);
-
+    forEachNearestScreen(conv, grid, MapScreenGrid::AIRPORT, airportCache.list, airportCache.generation,
+                         xs, ys, screenDistance, [](const MapAirport& obj) -> const Pos& {
+      return obj.position;
+    }, [&](const MapAirport& airport) {
       if(airport.isVisible(types))
-      {
-        if(conv.wToS(airport.position, x, y))
-          if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-            insertSortedByDistance(conv, result.airports, &result.airportIds, xs, ys, airport);
+        insertSortedByDistance(conv, result.airports, &result.airportIds, xs, ys, airport);
+    });
 
-        if(airportDiagram)
-        {
-          // Include tower for airport diagrams
-          if(conv.wToS(airport.towerCoords, x, y) &&
-             atools::geo::manhattanDistance(x, y, xs, ys) < screenDistance)
-            insertSortedByTowerDistance(conv, result.towers, xs, ys, airport);
-        }
-      }
+    if(airportDiagram)
+    {
+      // Include tower for airport diagrams
+      forEachNearestScreen(conv, grid, MapScreenGrid::AIRPORT_TOWER, airportCache.list, airportCache.generation,
+                           xs, ys, screenDistance, [](const MapAirport& obj) -> const Pos& {
+        return obj.towerCoords;
+      }, [&](const MapAirport& airport) {
+        if(airport.isVisible(types))
+          insertSortedByTowerDistance(conv, result.towers, xs, ys, airport);
+      });
     }
   }
 
   if(mapLayer->isVor() && types.testFlag(map::VOR))
   {
-    for(int i = vorCache.list.size() - 1; i >= 0; i--)
-    {
-      const MapVor& vor = vorCache.list.at(i);
-      if(conv.wToS(vor.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.vors, &result.vorIds, xs, ys, vor);
-    }
+    forEachNearestScreen(conv, grid, MapScreenGrid::VOR, vorCache.list, vorCache.generation,
+                         xs, ys, screenDistance, [](const MapVor& obj) -> const Pos& {
+      return obj.position;
+    }, [&](const MapVor& vor) {
+      insertSortedByDistance(conv, result.vors, &result.vorIds, xs, ys, vor);
+    });
   }
 
   if(mapLayer->isNdb() && types.testFlag(map::NDB))
   {
-    for(int i = ndbCache.list.size() - 1; i >= 0; i--)
-    {
-      const MapNdb& ndb = ndbCache.list.at(i);
-      if(conv.wToS(ndb.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.ndbs, &result.ndbIds, xs, ys, ndb);
-    }
+    forEachNearestScreen(conv, grid, MapScreenGrid::NDB, ndbCache.list, ndbCache.generation,
+                         xs, ys, screenDistance, [](const MapNdb& obj) -> const Pos& {
+      return obj.position;
+    }, [&](const MapNdb& ndb) {
+      insertSortedByDistance(conv, result.ndbs, &result.ndbIds, xs, ys, ndb);
+    });
   }
 
   // No flag since visibility is defined by type
   if(mapLayer->isUserpoint())
   {
-    for(int i = userpointCache.list.size() - 1; i >= 0; i--)
-    {
-      const MapUserpoint& wp = userpointCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.userpoints, &result.userpointIds, xs, ys, wp);
-    }
+    forEachNearestScreen(conv, grid, MapScreenGrid::USERPOINT, userpointCache.list, userpointCache.generation,
+                         xs, ys, screenDistance, [](const MapUserpoint& obj) -> const Pos& {
+      return obj.position;
+    }, [&](const MapUserpoint& wp) {
+      insertSortedByDistance(conv, result.userpoints, &result.userpointIds, xs, ys, wp);
+    });
   }
 
   // Add waypoints that displayed together with airways =================================
@@ -560,24 +706,22 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
 
   if(mapLayer->isMarker() && types.testFlag(map::MARKER))
   {
-    for(int i = markerCache.list.size() - 1; i >= 0; i--)
-    {
-      const MapMarker& wp = markerCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.markers, nullptr, xs, ys, wp);
-    }
+    forEachNearestScreen(conv, grid, MapScreenGrid::MARKER, markerCache.list, markerCache.generation,
+                         xs, ys, screenDistance, [](const MapMarker& obj) -> const Pos& {
+      return obj.position;
+    }, [&](const MapMarker& wp) {
+      insertSortedByDistance(conv, result.markers, nullptr, xs, ys, wp);
+    });
   }
 
   if(mapLayer->isIls() && types.testFlag(map::ILS))
   {
-    for(int i = ilsCache.list.size() - 1; i >= 0; i--)
-    {
-      const MapIls& wp = ilsCache.list.at(i);
-      if(conv.wToS(wp.position, x, y))
-        if((atools::geo::manhattanDistance(x, y, xs, ys)) < screenDistance)
-          insertSortedByDistance(conv, result.ils, nullptr, xs, ys, wp);
-    }
+    forEachNearestScreen(conv, grid, MapScreenGrid::ILS, ilsCache.list, ilsCache.generation,
+                         xs, ys, screenDistance, [](const MapIls& obj) -> const Pos& {
+      return obj.position;
+    }, [&](const MapIls& wp) {
+      insertSortedByDistance(conv, result.ils, nullptr, xs, ys, wp);
+    });
   }
 
   // Get objects from airport diagram =====================================================
@@ -585,30 +729,17 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
   {
     if(airportDiagram)
     {
-      QHash<int, QList<map::MapParking> > parkingCache = NavApp::getAirportQuerySim()->getParkingCache();
-
-      // Also check parking and helipads in airport diagrams
-      for(int id : parkingCache.keys())
-      {
-        const QList<MapParking>& parkings = parkingCache.value(id);
-        for(const MapParking& p : parkings)
-        {
-          if(conv.wToS(p.position, x, y) && atools::geo::manhattanDistance(x, y, xs, ys) < screenDistance)
-            insertSortedByDistance(conv, result.parkings, nullptr, xs, ys, p);
-        }
-      }
-
-      QHash<int, QList<map::MapHelipad> > helipadCache = NavApp::getAirportQuerySim()->getHelipadCache();
+      // Also check parking and helipads in airport diagrams - caches are used in place
+      const AirportQuery *airportQuery = NavApp::getAirportQuerySim();
+      forEachNearestScreenAirportCache(conv, grid, MapScreenGrid::PARKING, airportQuery->getParkingCache(),
+                                       airportQuery->getParkingGeneration(), xs, ys, screenDistance, [&](const MapParking& p) {
+        insertSortedByDistance(conv, result.parkings, nullptr, xs, ys, p);
+      });
 
-      for(int id : helipadCache.keys())
-      {
-        const QList<MapHelipad>& helipads = helipadCache.value(id);
-        for(const MapHelipad& p : helipads)
-        {
-          if(conv.wToS(p.position, x, y) && atools::geo::manhattanDistance(x, y, xs, ys) < screenDistance)
-            insertSortedByDistance(conv, result.helipads, nullptr, xs, ys, p);
-        }
-      }
+      forEachNearestScreenAirportCache(conv, grid, MapScreenGrid::HELIPAD, airportQuery->getHelipadCache(),
+                                       airportQuery->getHelipadGeneration(), xs, ys, screenDistance, [&](const MapHelipad& p) {
+        insertSortedByDistance(conv, result.helipads, nullptr, xs, ys, p);
+      });
     }
   }
 }
@@ -616,83 +747,70 @@ void MapQuery::getNearestScreenObjects(const CoordinateConverter& conv, const Ma
 const QList<map::MapAirport> *MapQuery::getAirports(const Marble::GeoDataLatLonBox& rect,
                                                     const MapLayer *mapLayer, bool lazy)
 {
-  airportCache.updateCache(rect, mapLayer, queryRectInflationFactor, queryRectInflationIncrement, lazy,
-                           [](const MapLayer *curLayer, const MapLayer *newLayer) -> bool
-  {
-    return curLayer->hasSameQueryParametersAirport(newLayer);
-  });
+  // Source table and minimum runway length define the query parameters
+  int layerKey = mapLayer->getDataSource() * 100000 + mapLayer->getMinRunwayLength();
 
-  switch(mapLayer->getDataSource())
+  airportCache.updateCache(rect, layerKey, queryRectInflationFactor, queryRectInflationIncrement, lazy, queryMaxRows,
+                           [ = ](const GeoDataLatLonBox& tileRect, QList<map::MapAirport>& airports) -> void
   {
-    case layer::ALL:
-      airportByRectQuery->bindValue(":minlength", mapLayer->getMinRunwayLength());
-      return fetchAirports(rect, airportByRectQuery, lazy, false /* overview */);
-
-    case layer::MEDIUM:
-      // Airports > 4000 ft
-      return fetchAirports(rect, airportMediumByRectQuery, lazy, true /* overview */);
-
-    case layer::LARGE:
-      // Airports > 8000 ft
-      return fetchAirports(rect, airportLargeByRectQuery, lazy, true /* overview */);
-
-  }
-  return nullptr;
+    switch(mapLayer->getDataSource())
+    {
+      case layer::ALL:
+        airportByRectQuery->bindValue(":minlength", mapLayer->getMinRunwayLength());
+        fetchAirports(tileRect, airportByRectQuery, false /* overview */, airports);
+        break;
+
+      case layer::MEDIUM:
+        // Airports > 4000 ft
+        fetchAirports(tileRect, airportMediumByRectQuery, true /* overview */, airports);
+        break;
+
+      case layer::LARGE:
+        // Airports > 8000 ft
+        fetchAirports(tileRect, airportLargeByRectQuery, true /* overview */, airports);
+        break;
+    }
+  });
+  return &airportCache.list;
 }
 
 const QList<map::MapVor> *MapQuery::getVors(const GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                                             bool lazy)
 {
-  vorCache.updateCache(rect, mapLayer, queryRectInflationFactor, queryRectInflationIncrement, lazy,
-                       [](const MapLayer *curLayer, const MapLayer *newLayer) -> bool
-  {
-    return curLayer->hasSameQueryParametersVor(newLayer);
-  });
+  Q_UNUSED(mapLayer)
 
-  if(vorCache.list.isEmpty() && !lazy)
+  vorCache.updateCache(rect, 0, queryRectInflationFactor, queryRectInflationIncrement, lazy, queryMaxRows,
+                       [ = ](const GeoDataLatLonBox& tileRect, QList<map::MapVor>& vors) -> void
   {
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+    query::bindRect(tileRect, vorsByRectQuery);
+    vorsByRectQuery->exec();
+    while(vorsByRectQuery->next())
     {
-      query::bindRect(r, vorsByRectQuery);
-      vorsByRectQuery->exec();
-      while(vorsByRectQuery->next())
-      {
-        map::MapVor vor;
-        mapTypesFactory->fillVor(vorsByRectQuery->record(), vor);
-        vorCache.list.append(vor);
-      }
+      map::MapVor vor;
+      mapTypesFactory->fillVor(vorsByRectQuery->record(), vor);
+      vors.append(vor);
     }
-  }
-  vorCache.validate(queryMaxRows);
+  });
   return &vorCache.list;
 }
 
 const QList<map::MapNdb> *MapQuery::getNdbs(const GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                                             bool lazy)
 {
-  ndbCache.updateCache(rect, mapLayer, queryRectInflationFactor, queryRectInflationIncrement, lazy,
-                       [](const MapLayer *curLayer, const MapLayer *newLayer) -> bool
-  {
-    return curLayer->hasSameQueryParametersNdb(newLayer);
-  });
+  Q_UNUSED(mapLayer)
 
-  if(ndbCache.list.isEmpty() && !lazy)
+  ndbCache.updateCache(rect, 0, queryRectInflationFactor, queryRectInflationIncrement, lazy, queryMaxRows,
+                       [ = ](const GeoDataLatLonBox& tileRect, QList<map::MapNdb>& ndbs) -> void
   {
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+    query::bindRect(tileRect, ndbsByRectQuery);
+    ndbsByRectQuery->exec();
+    while(ndbsByRectQuery->next())
     {
-      query::bindRect(r, ndbsByRectQuery);
-      ndbsByRectQuery->exec();
-      while(ndbsByRectQuery->next())
-      {
-        map::MapNdb ndb;
-        mapTypesFactory->fillNdb(ndbsByRectQuery->record(), ndb);
-        ndbCache.list.append(ndb);
-      }
+      map::MapNdb ndb;
+      mapTypesFactory->fillNdb(ndbsByRectQuery->record(), ndb);
+      ndbs.append(ndb);
     }
-  }
-  ndbCache.validate(queryMaxRows);
+  });
   return &ndbCache.list;
 }
 
@@ -754,102 +872,72 @@ const QList<map::MapUserpoint> MapQuery::getUserdataPoints(const GeoDataLatLonBo
 const QList<map::MapMarker> *MapQuery::getMarkers(const GeoDataLatLonBox& rect, const MapLayer *mapLayer,
                                                   bool lazy)
 {
-  markerCache.updateCache(rect, mapLayer, queryRectInflationFactor, queryRectInflationIncrement, lazy,
-                          [](const MapLayer *curLayer, const MapLayer *newLayer) -> bool
-  {
-    return curLayer->hasSameQueryParametersMarker(newLayer);
-  });
+  Q_UNUSED(mapLayer)
 
-  if(markerCache.list.isEmpty() && !lazy)
+  markerCache.updateCache(rect, 0, queryRectInflationFactor, queryRectInflationIncrement, lazy, queryMaxRows,
+                          [ = ](const GeoDataLatLonBox& tileRect, QList<map::MapMarker>& markers) -> void
   {
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+    query::bindRect(tileRect, markersByRectQuery);
+    markersByRectQuery->exec();
+    while(markersByRectQuery->next())
     {
-      query::bindRect(r, markersByRectQuery);
-      markersByRectQuery->exec();
-      while(markersByRectQuery->next())
-      {
-        map::MapMarker marker;
-        mapTypesFactory->fillMarker(markersByRectQuery->record(), marker);
-        markerCache.list.append(marker);
-      }
+      map::MapMarker marker;
+      mapTypesFactory->fillMarker(markersByRectQuery->record(), marker);
+      markers.append(marker);
     }
-  }
-  markerCache.validate(queryMaxRows);
+  });
   return &markerCache.list;
 }
 
 const QList<map::MapIls> *MapQuery::getIls(GeoDataLatLonBox rect, const MapLayer *mapLayer, bool lazy)
 {
-  ilsCache.updateCache(rect, mapLayer, queryRectInflationFactor, queryRectInflationIncrement, lazy,
-                       [](const MapLayer *curLayer, const MapLayer *newLayer) -> bool
-  {
-    return curLayer->hasSameQueryParametersIls(newLayer);
-  });
+  Q_UNUSED(mapLayer)
 
-  if(ilsCache.list.isEmpty() && !lazy)
-  {
-    // ILS length is 9 NM * 1' per degree
-    double increase = atools::geo::toRadians(9. / 60.);
+  // ILS length is 9 NM * 1' per degree
+  double increase = atools::geo::toRadians(9. / 60.);
 
-    // Increase bounding rect since ILS has no bounding to query
-    rect.setBoundaries(rect.north() + increase, rect.south() - increase,
-                       rect.east() + increase, rect.west() - increase);
+  // Increase bounding rect since ILS has no bounding to query
+  rect.setBoundaries(rect.north() + increase, rect.south() - increase,
+                     rect.east() + increase, rect.west() - increase);
 
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+  ilsCache.updateCache(rect, 0, queryRectInflationFactor, queryRectInflationIncrement, lazy, queryMaxRows,
+                       [ = ](const GeoDataLatLonBox& tileRect, QList<map::MapIls>& ils) -> void
+  {
+    query::bindRect(tileRect, ilsByRectQuery);
+    ilsByRectQuery->exec();
+    while(ilsByRectQuery->next())
     {
-      query::bindRect(r, ilsByRectQuery);
-
-      ilsByRectQuery->exec();
-      while(ilsByRectQuery->next())
-      {
-        map::MapIls ils;
-        mapTypesFactory->fillIls(ilsByRectQuery->record(), ils);
-        ilsCache.list.append(ils);
-      }
+      map::MapIls i;
+      mapTypesFactory->fillIls(ilsByRectQuery->record(), i);
+      ils.append(i);
     }
-  }
-  ilsCache.validate(queryMaxRows);
+  });
   return &ilsCache.list;
 }
 
 /*
- * Get airport cache
- * @param reverse reverse order of airports to have unimportant small ones below in painting order
- * @param lazy do not update cache - instead return incomplete resut
+ * Load airports for a tile
  * @param overview fetch only incomplete data for overview airports
- * @return pointer to the airport cache
  */
-const QList<map::MapAirport> *MapQuery::fetchAirports(const Marble::GeoDataLatLonBox& rect,
-                                                      atools::sql::SqlQuery *query,
-                                                      bool lazy, bool overview)
+void MapQuery::fetchAirports(const Marble::GeoDataLatLonBox& rect, atools::sql::SqlQuery *query, bool overview,
+                             QList<map::MapAirport>& airports)
 {
-  if(airportCache.list.isEmpty() && !lazy)
+  bool navdata = NavApp::getDatabaseManager()->getNavDatabaseStatus() == dm::NAVDATABASE_ALL;
+  bool xplane = NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11;
+
+  query::bindRect(rect, query);
+  query->exec();
+  while(query->next())
   {
-    bool navdata = NavApp::getDatabaseManager()->getNavDatabaseStatus() == dm::NAVDATABASE_ALL;
-    for(const GeoDataLatLonBox& r :
-        query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
-    {
-      query::bindRect(r, query);
-      query->exec();
-      while(query->next())
-      {
-        map::MapAirport ap;
-        if(overview)
-          // Fill only a part of the object
-          mapTypesFactory->fillAirportForOverview(query->record(), ap, navdata,
-                                                  NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11);
-        else
-          mapTypesFactory->fillAirport(query->record(), ap, true /* complete */, navdata,
-                                       NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11);
-
-        airportCache.list.append(ap);
-      }
-    }
+    map::MapAirport ap;
+    if(overview)
+      // Fill only a part of the object
+      mapTypesFactory->fillAirportForOverview(query->record(), ap, navdata, xplane);
+    else
+      mapTypesFactory->fillAirport(query->record(), ap, true /* complete */, navdata, xplane);
+
+    airports.append(ap);
   }
-  airportCache.validate(queryMaxRows);
-  return &airportCache.list;
 }
 
 const QList<map::MapRunway> *MapQuery::getRunwaysForOverview(int airportId)
@@ -1045,6 +1133,9 @@ void MapQuery::initQueries()
 
 void MapQuery::deInitQueries()
 {
+  qDebug() << Q_FUNC_INFO << "airports" << airportCache.getStats() << "VOR" << vorCache.getStats()
+           << "NDB" << ndbCache.getStats() << "marker" << markerCache.getStats() << "ILS" << ilsCache.getStats();
+
   airportCache.clear();
   vorCache.clear();
   ndbCache.clear();
@@ -35,6 +35,7 @@ class SqlQuery;
 class CoordinateConverter;
 class MapTypesFactory;
 class MapLayer;
+class MapScreenGrid;
 
 /*
  * Provides map related database queries.
@@ -119,10 +120,14 @@ public:
    * @param xs/ys Screen coordinates
    * @param screenDistance maximum distance to coordinates
    * @param result will receive objects based on type
+   * @param grid screen grid built by updateScreenGrid(). A linear search is used if null or outdated.
    */
   void getNearestScreenObjects(const CoordinateConverter& conv, const MapLayer *mapLayer, bool airportDiagram,
                                map::MapObjectTypes types, int xs, int ys, int screenDistance,
-                               map::MapSearchResult& result);
+                               map::MapSearchResult& result, const MapScreenGrid *grid = nullptr);
+
+  /* Fill screen grid with all cached objects. Call after painting when caches are up to date. */
+  void updateScreenGrid(MapScreenGrid& grid, const CoordinateConverter& conv, bool airportDiagram);
 
   /* Only VOR, NDB, ILS and waypoints
    * All sorted by distance to pos with a maximum distance distanceNm
@@ -181,9 +186,8 @@ private:
                                 const atools::geo::Pos& sortByDistancePos,
                                 float maxDistance, bool airportFromNavDatabase);
 
-  const QList<map::MapAirport> *fetchAirports(const Marble::GeoDataLatLonBox& rect,
-                                              atools::sql::SqlQuery *query,
-                                              bool lazy, bool overview);
+  void fetchAirports(const Marble::GeoDataLatLonBox& rect, atools::sql::SqlQuery *query, bool overview,
+                     QList<map::MapAirport>& airports);
   QVector<map::MapIls> ilsByAirportAndRunway(const QString& airportIdent, const QString& runway);
 
   void runwayEndByNameFuzzy(QList<map::MapRunwayEnd>& runwayEnds, const QString& name, const map::MapAirport& airport,
@@ -192,13 +196,15 @@ private:
   MapTypesFactory *mapTypesFactory;
   atools::sql::SqlDatabase *dbSim, *dbNav, *dbUser;
 
-  /* Simple bounding rectangle caches */
-  query::SimpleRectCache<map::MapAirport> airportCache;
+  /* Tiled spatial caches which load only newly exposed tiles */
+  query::TileRectCache<map::MapAirport> airportCache;
+  query::TileRectCache<map::MapVor> vorCache;
+  query::TileRectCache<map::MapNdb> ndbCache;
+  query::TileRectCache<map::MapMarker> markerCache;
+  query::TileRectCache<map::MapIls> ilsCache;
+
+  /* Simple bounding rectangle cache used for the screen index only */
   query::SimpleRectCache<map::MapUserpoint> userpointCache;
-  query::SimpleRectCache<map::MapVor> vorCache;
-  query::SimpleRectCache<map::MapNdb> ndbCache;
-  query::SimpleRectCache<map::MapMarker> markerCache;
-  query::SimpleRectCache<map::MapIls> ilsCache;
 
   /* ID/object caches */
   QCache<int, QList<map::MapRunway> > runwayOverwiewCache;
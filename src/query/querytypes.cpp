@@ -20,6 +20,8 @@
 #include "sql/sqlquery.h"
 #include "geo/rect.h"
 
+#include <cmath>
+
 using namespace Marble;
 
 namespace query {
@@ -106,4 +108,78 @@ void fetchObjectsForRect(const atools::geo::Rect& rect, atools::sql::SqlQuery *q
   }
 }
 
+/* Tiles smaller than this are not used */
+static const int MAX_TILE_LEVEL = 14;
+
+int tileLevelForSize(double sizeDeg)
+{
+  if(sizeDeg < 1.e-6)
+    return MAX_TILE_LEVEL;
+
+  // Tile size is 360 / 2^level degree and should be between half and the full size of the rectangle
+  int level = static_cast<int>(std::floor(std::log2(360. / sizeDeg))) + 1;
+
+  // Level one and up to avoid tiles spanning the whole world which cannot be expressed in a lat lon box
+  return std::min(std::max(level, 1), MAX_TILE_LEVEL);
+}
+
+double tileSizeForLevel(int level)
+{
+  return 360. / static_cast<double>(1 << level);
 }
+
+/* Tile coordinates for lonx, laty clamped to valid range */
+static void tileCoordinates(int& x, int& y, double lonx, double laty, int level)
+{
+  double size = tileSizeForLevel(level);
+  int numX = 1 << level;
+  int numY = std::max(numX / 2, 1);
+
+  x = std::min(std::max(static_cast<int>(std::floor((lonx + 180.) / size)), 0), numX - 1);
+  y = std::min(std::max(static_cast<int>(std::floor((laty + 90.) / size)), 0), numY - 1);
+}
+
+void tilesForRect(QVector<TileKey>& keys, const Marble::GeoDataLatLonBox& rect, int layerKey, int level)
+{
+  int left, bottom, right, top;
+  tileCoordinates(left, bottom, rect.west(GeoDataCoordinates::Degree), rect.south(GeoDataCoordinates::Degree),
+                  level);
+  tileCoordinates(right, top, rect.east(GeoDataCoordinates::Degree), rect.north(GeoDataCoordinates::Degree),
+                  level);
+
+  for(int y = bottom; y <= top; y++)
+  {
+    for(int x = left; x <= right; x++)
+    {
+      TileKey key = {layerKey, level, x, y};
+      if(!keys.contains(key))
+        keys.append(key);
+    }
+  }
+}
+
+Marble::GeoDataLatLonBox tileRect(const TileKey& key)
+{
+  double size = tileSizeForLevel(key.level);
+  double west = -180. + key.x * size, south = -90. + key.y * size;
+
+  return GeoDataLatLonBox(std::min(south + size, 90.), south, std::min(west + size, 180.), west,
+                          GeoDataCoordinates::Degree);
+}
+
+bool tileContains(const TileKey& key, const atools::geo::Pos& pos)
+{
+  int x, y;
+  tileCoordinates(x, y, pos.getLonX(), pos.getLatY(), key.level);
+  return x == key.x && y == key.y;
+}
+
+QDebug operator<<(QDebug out, const TileCacheStats& stats)
+{
+  QDebugStateSaver saver(out);
+  out.nospace().noquote() << "TileCacheStats[hits " << stats.hits << ", misses " << stats.misses
+                          << ", evictions " << stats.evictions << ", truncated " << stats.truncated << "]";
+  return out;
+}
+
+} // namespace query
@@ -22,8 +22,11 @@
 #include "sql/sqlquery.h"
 #include "common/maptypes.h"
 
+#include <QCache>
+#include <QDebug>
 #include <QList>
 
+#include <algorithm>
 #include <functional>
 
 #include <marble/GeoDataCoordinates.h>
@@ -85,6 +88,9 @@ struct SimpleRectCache
   const MapLayer *curMapLayer = nullptr;
   QList<TYPE> list;
 
+  /* Incremented each time the list is cleared */
+  quint32 generation = 0;
+
 };
 
 // ---------------------------------------------------------------------------------
@@ -108,6 +114,7 @@ bool SimpleRectCache<TYPE>::updateCache(const Marble::GeoDataLatLonBox& rect, co
   {
     // Rectangle not covered by loaded data or new layer selected
     list.clear();
+    generation++;
     curRect = rect;
     curMapLayer = mapLayer;
     return true;
@@ -129,10 +136,217 @@ template<typename TYPE>
 void SimpleRectCache<TYPE>::clear()
 {
   list.clear();
+  generation++;
   curRect.clear();
   curMapLayer = nullptr;
 }
 
+/* Key for a single tile of a TileRectCache. layerKey separates datasets loaded with different query parameters. */
+struct TileKey
+{
+  int layerKey, level, x, y;
+
+  bool operator==(const query::TileKey& other) const
+  {
+    return layerKey == other.layerKey && level == other.level && x == other.x && y == other.y;
+  }
+
+  bool operator!=(const query::TileKey& other) const
+  {
+    return !operator==(other);
+  }
+
+};
+
+inline uint qHash(const query::TileKey& key)
+{
+  return ::qHash(key.layerKey) ^ ::qHash(key.level << 28 ^ key.x << 14 ^ key.y);
+}
+
+/* Counters for tile cache usage */
+struct TileCacheStats
+{
+  quint64 hits = 0, misses = 0, evictions = 0, truncated = 0;
+};
+
+QDebug operator<<(QDebug out, const query::TileCacheStats& stats);
+
+/* Calculate tile level for the given bounding rectangle dimension in degree. Tiles are
+ * always a bit smaller than the rectangle resulting in about 3 x 3 tiles for a view. */
+int tileLevelForSize(double sizeDeg);
+
+/* Tile size in degree for level */
+double tileSizeForLevel(int level);
+
+/* Get all tiles touching the rectangle. The rectangle must not cross the anti-meridian. */
+void tilesForRect(QVector<TileKey>& keys, const Marble::GeoDataLatLonBox& rect, int layerKey, int level);
+
+/* Get bounding rectangle for tile */
+Marble::GeoDataLatLonBox tileRect(const TileKey& key);
+
+/* true if position is in tile. Left and bottom border are inclusive while right and top are exclusive
+ * except at the anti-meridian and the poles. Used to avoid duplicates from tile queries. */
+bool tileContains(const TileKey& key, const atools::geo::Pos& pos);
+
+/*
+ * Spatial cache which divides the world into tiles of a size depending on the view rectangle.
+ * Each tile is loaded separately and kept in a LRU cache bounded by the number of objects.
+ * Only tiles not in the cache are loaded if the view moves. The tiles covering the current view are joined
+ * into "list" which is used for painting and the screen index.
+ *
+ * TYPE must have a member "position" of type atools::geo::Pos.
+ */
+template<typename TYPE>
+struct TileRectCache
+{
+  /* Load all objects for the given tile rectangle into list. */
+  typedef std::function<void (const Marble::GeoDataLatLonBox& tileRect, QList<TYPE>& tileList)> TileLoadFunc;
+
+  /*
+   * @param rect bounding rectangle - all objects inside this rectangle are returned
+   * @param layerKey number identifying the query parameters of the current map layer
+   * @param lazy if true do not fetch new data but return the old potentially incomplete dataset
+   * @param maxRows query row limit. Tiles which are truncated due to this limit are not cached.
+   * Also limits the size of the joined list. The view is loaded again on the next call if the list was truncated.
+   * @param loadFunc called for each tile not found in the cache
+   * @return true if the list was updated
+   */
+  bool updateCache(const Marble::GeoDataLatLonBox& rect, int layerKey, double factor, double increment,
+                   bool lazy, int maxRows, TileLoadFunc loadFunc);
+  void clear();
+
+  /* Maximum number of objects in all cached tiles */
+  void setMaxObjects(int maxObjects)
+  {
+    tiles.setMaxCost(maxObjects);
+  }
+
+  const TileCacheStats& getStats() const
+  {
+    return stats;
+  }
+
+  /* Objects in all tiles covering the current view */
+  QList<TYPE> list;
+
+  /* Incremented each time the list is changed */
+  quint32 generation = 0;
+
+private:
+  QCache<TileKey, QList<TYPE> > tiles;
+  QVector<TileKey> curTiles;
+  TileCacheStats stats;
+};
+
+// ---------------------------------------------------------------------------------
+
+template<typename TYPE>
+bool TileRectCache<TYPE>::updateCache(const Marble::GeoDataLatLonBox& rect, int layerKey, double factor,
+                                      double increment, bool lazy, int maxRows, TileLoadFunc loadFunc)
+{
+  if(lazy)
+    // Nothing changed
+    return false;
+
+  // Inflate rectangle to prefetch a margin and split it at the anti-meridian
+  QList<Marble::GeoDataLatLonBox> rects = query::splitAtAntiMeridian(rect, factor, increment);
+
+  double width = 0., height = 0.;
+  for(const Marble::GeoDataLatLonBox& r : rects)
+  {
+    width += r.width(Marble::GeoDataCoordinates::Degree);
+    height = std::max(height, r.height(Marble::GeoDataCoordinates::Degree));
+  }
+
+  int level = tileLevelForSize(std::max(width, height));
+  QVector<TileKey> keys;
+  for(const Marble::GeoDataLatLonBox& r : rects)
+    tilesForRect(keys, r, layerKey, level);
+
+#ifndef DEBUG_DISABLE_RECT_CACHE
+  if(keys == curTiles)
+    // Still the same set of tiles
+    return false;
+#endif
+
+  list.clear();
+  generation++;
+  bool overflow = false;
+  for(const TileKey& key : keys)
+  {
+    if(list.size() >= maxRows)
+    {
+      // Limit reached - do not load more tiles
+      overflow = true;
+      break;
+    }
+
+    QList<TYPE> *tile = tiles.object(key);
+    if(tile != nullptr)
+    {
+      stats.hits++;
+      list.append(*tile);
+    }
+    else
+    {
+      stats.misses++;
+      tile = new QList<TYPE>;
+      loadFunc(tileRect(key), *tile);
+
+      // Check limit before removing objects which belong to neighbor tiles
+      bool truncated = tile->size() >= maxRows;
+
+      // Remove objects which are exactly on the border and belong to a neighbor tile
+      auto it = std::remove_if(tile->begin(), tile->end(), [&key](const TYPE& obj) -> bool {
+        return !tileContains(key, obj.position);
+      });
+      tile->erase(it, tile->end());
+
+      list.append(*tile);
+
+      if(truncated)
+      {
+        // Incomplete - will be loaded again next time
+        stats.truncated++;
+        delete tile;
+      }
+      else
+      {
+        int numTiles = tiles.count();
+        if(tiles.insert(key, tile, std::max(tile->size(), 1)))
+          // Key is new - anything missing was evicted to make room
+          stats.evictions += static_cast<quint64>(std::max(numTiles + 1 - tiles.count(), 0));
+      }
+    }
+  }
+
+  if(list.size() > maxRows)
+  {
+    // Apply global limit like for a single query for the whole view
+    overflow = true;
+    list.erase(list.begin() + maxRows, list.end());
+  }
+
+  if(overflow)
+  {
+    // Incomplete view - check again next time
+    stats.truncated++;
+    curTiles.clear();
+  }
+  else
+    curTiles = keys;
+  return true;
+}
+
+template<typename TYPE>
+void TileRectCache<TYPE>::clear()
+{
+  list.clear();
+  generation++;
+  tiles.clear();
+  curTiles.clear();
+}
+
 /* Get a record from the cache or get it from a database query */
 template<typename ID>
 const atools::sql::SqlRecord *cachedRecord(QCache<ID, atools::sql::SqlRecord>& cache, atools::sql::SqlQuery *query,
@@ -112,6 +112,7 @@ void Route::copy(const Route& other)
 
   activeLegIndex = other.activeLegIndex;
   activeLegResult = other.activeLegResult;
+  legIndex = other.legIndex;
 
   // Update flightplan pointers to this instance
   for(RouteLeg& routeLeg : *this)
@@ -315,8 +316,10 @@ void Route::updateActiveLegAndPos(const map::PosCourse& pos)
     Pos pos1 = getPrevPositionAt(nextLeg);
     Pos pos2 = getPositionAt(nextLeg);
 
-    // Calculate course difference
-    float legCrs = normalizeCourse(pos1.angleDegTo(pos2));
+    // Calculate course difference - use cached course if available
+    float legCrs = legIndex.size() == size() ? legIndex.getCourse(nextLeg) : map::INVALID_COURSE_VALUE;
+    if(!(legCrs < map::INVALID_COURSE_VALUE))
+      legCrs = normalizeCourse(pos1.angleDegTo(pos2));
     courseDiff = atools::mod(pos.course - legCrs + 360.f, 360.f);
     if(courseDiff > 180.f)
       courseDiff = 360.f - courseDiff;
@@ -1460,6 +1463,8 @@ void Route::updateDistancesAndCourse()
     }
     last = &leg;
   }
+
+  legIndex.build(*this);
 }
 
 void Route::updateMagvar()
@@ -1525,6 +1530,20 @@ void Route::nearestAllLegIndex(const map::PosCourse& pos, float& crossTrackDista
   if(!pos.isValid())
     return;
 
+  if(legIndex.size() == size())
+  {
+    // Index is up to date ===========================================
+    atools::geo::LineDistance result;
+    int legIdx = legIndex.getNearestLeg(pos, atools::geo::nmToMeter(100.f), result);
+    if(legIdx != map::INVALID_INDEX_VALUE)
+    {
+      crossTrackDistanceMeter = result.distance;
+      index = legIdx;
+    }
+    return;
+  }
+
+  // Linear search if legs were changed without update ===========================================
   float minDistance = map::INVALID_DISTANCE_VALUE;
 
   // Check only until the approach starts if required
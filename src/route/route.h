@@ -19,6 +19,7 @@
 #define LITTLENAVMAP_ROUTE_H
 
 #include "route/routeleg.h"
+#include "route/routelegindex.h"
 
 #include "fs/pln/flightplan.h"
 
@@ -572,8 +573,10 @@ private:
   /* Update and calculate magnetic variation for all route map objects */
   void updateMagvar();
 
-  /* Get indexes to nearest approach or route leg and cross track distance to the nearest ofthem in nm */
   void copy(const Route& other);
+
+  /* Get indexes to nearest approach or route leg and cross track distance to the nearest ofthem in nm.
+   * Uses the leg index if it is up to date. */
   void nearestAllLegIndex(const map::PosCourse& pos, float& crossTrackDistanceMeter, int& index) const;
   bool isSmaller(const atools::geo::LineDistance& dist1, const atools::geo::LineDistance& dist2, float epsilon);
   int adjustedActiveLeg() const;
@@ -600,6 +603,9 @@ private:
   int numAlternateLegs = 0;
 
   RouteAltitude *altitude;
+
+  /* Leg geometry for fast lookup of the active leg. Rebuilt in updateDistancesAndCourse(). */
+  RouteLegIndex legIndex;
 };
 
 QDebug operator<<(QDebug out, const Route& route);
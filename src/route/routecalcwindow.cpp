@@ -66,10 +66,17 @@ RouteCalcWindow::RouteCalcWindow(QWidget *parent) :
           this, &RouteCalcWindow::updateWidgets);
   connect(ui->horizontalSliderRouteCalcAirwayPreference, &QSlider::valueChanged,
           this, &RouteCalcWindow::updatePreferenceLabel);
+  connect(ui->pushButtonRouteCalcCancel, &QPushButton::clicked, this, &RouteCalcWindow::cancelClicked);
+  connect(ui->comboBoxRouteCalcAlternatives, static_cast<void (QComboBox::*)(int)>(&QComboBox::activated),
+          this, &RouteCalcWindow::alternativeSelected);
 
   units = new UnitStringTool();
   units->init({ui->spinBoxRouteCalcCruiseAltitude});
 
+  ui->progressBarRouteCalc->setVisible(false);
+  ui->pushButtonRouteCalcCancel->setEnabled(false);
+  clearAlternatives();
+
   Q_ASSERT(ui->horizontalSliderRouteCalcAirwayPreference->minimum() == AIRWAY_WAYPOINT_PREF_MIN);
   Q_ASSERT(ui->horizontalSliderRouteCalcAirwayPreference->maximum() == AIRWAY_WAYPOINT_PREF_MAX);
 }
@@ -140,16 +147,69 @@ void RouteCalcWindow::updateWidgets()
 
   bool canCalcRoute = NavApp::getRouteConst().canCalcRoute();
   ui->pushButtonRouteCalcAdjustAltitude->setEnabled(canCalcRoute);
-  ui->pushButtonRouteCalc->setEnabled(isCalculateSelection() ? canCalculateSelection : canCalcRoute);
+  ui->pushButtonRouteCalc->setEnabled(!calculating && (isCalculateSelection() ? canCalculateSelection : canCalcRoute));
 
-  ui->pushButtonRouteCalcDirect->setEnabled(!isCalculateSelection() && canCalcRoute &&
+  ui->pushButtonRouteCalcDirect->setEnabled(!calculating && !isCalculateSelection() && canCalcRoute &&
                                             NavApp::getRouteConst().hasEntries());
-  ui->pushButtonRouteCalcReverse->setEnabled(!isCalculateSelection() && canCalcRoute);
+  ui->pushButtonRouteCalcReverse->setEnabled(!calculating && !isCalculateSelection() && canCalcRoute);
 
   updateHeader();
   updatePreferenceLabel();
 }
 
+void RouteCalcWindow::calculationStarted()
+{
+  Ui::MainWindow *ui = NavApp::getMainUi();
+  calculating = true;
+  clearAlternatives();
+
+  // Busy indicator until first progress report arrives
+  ui->progressBarRouteCalc->setRange(0, 0);
+  ui->progressBarRouteCalc->setVisible(true);
+  ui->pushButtonRouteCalcCancel->setEnabled(true);
+  updateWidgets();
+}
+
+void RouteCalcWindow::calculationFinished()
+{
+  Ui::MainWindow *ui = NavApp::getMainUi();
+  calculating = false;
+  ui->progressBarRouteCalc->setVisible(false);
+  ui->pushButtonRouteCalcCancel->setEnabled(false);
+  updateWidgets();
+}
+
+void RouteCalcWindow::calculationProgress(int maximum, int value)
+{
+  // Ignore late reports from the worker thread
+  if(calculating)
+  {
+    Ui::MainWindow *ui = NavApp::getMainUi();
+    ui->progressBarRouteCalc->setRange(0, maximum);
+    ui->progressBarRouteCalc->setValue(value);
+  }
+}
+
+void RouteCalcWindow::setAlternatives(const QStringList& texts)
+{
+  Ui::MainWindow *ui = NavApp::getMainUi();
+  ui->comboBoxRouteCalcAlternatives->clear();
+  ui->comboBoxRouteCalcAlternatives->addItems(texts);
+  ui->comboBoxRouteCalcAlternatives->setCurrentIndex(0);
+
+  // Selection makes only sense if there is more than one route
+  ui->comboBoxRouteCalcAlternatives->setEnabled(texts.size() > 1);
+  ui->labelRouteCalcAlternatives->setEnabled(texts.size() > 1);
+}
+
+void RouteCalcWindow::clearAlternatives()
+{
+  Ui::MainWindow *ui = NavApp::getMainUi();
+  ui->comboBoxRouteCalcAlternatives->clear();
+  ui->comboBoxRouteCalcAlternatives->setEnabled(false);
+  ui->labelRouteCalcAlternatives->setEnabled(false);
+}
+
 void RouteCalcWindow::updatePreferenceLabel()
 {
   Ui::MainWindow *ui = NavApp::getMainUi();
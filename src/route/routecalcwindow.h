@@ -113,6 +113,19 @@ public:
 
   float getAirwayPreferenceCostFactor() const;
 
+  /* Show progress bar and enable cancel button. Disables calculation buttons and clears alternatives. */
+  void calculationStarted();
+
+  /* Hide progress bar and disable cancel button */
+  void calculationFinished();
+
+  /* Update progress bar. Called from the calculation worker thread using a queued connection. */
+  void calculationProgress(int maximum, int value);
+
+  /* Fill the alternatives combo box. First entry is selected. */
+  void setAlternatives(const QStringList& texts);
+  void clearAlternatives();
+
   static constexpr int AIRWAY_WAYPOINT_PREF_MIN = 0;
   static constexpr int AIRWAY_WAYPOINT_PREF_MAX = 10;
 
@@ -122,6 +135,12 @@ signals:
   void calculateDirectClicked();
   void calculateReverseClicked();
 
+  /* Cancel button for a running calculation clicked */
+  void cancelClicked();
+
+  /* User selected an entry in the alternatives combo box */
+  void alternativeSelected(int index);
+
 private:
   /* Fill header message with departure, destination or error messages. */
   void updateHeader();
@@ -135,6 +154,9 @@ private:
   /* Range/selection */
   int fromIndex = -1, toIndex = -1;
   bool canCalculateSelection = false;
+
+  /* Route finder running in background */
+  bool calculating = false;
   UnitStringTool *units = nullptr;
 
   QList<QObject *> widgets;
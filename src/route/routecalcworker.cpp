@@ -0,0 +1,190 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "route/routecalcworker.h"
+
+#include "routing/routefinder.h"
+#include "routing/routenetwork.h"
+#include "atools.h"
+
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
+
+using atools::routing::RouteFinder;
+using atools::routing::RouteNetwork;
+
+/* Cost factors for direct connections used to find alternatives. See DIRECT_COST_FACTORS in RouteCalcWindow. */
+static const float ALTERNATIVE_COST_FACTORS[] = {1.f, 1.5f, 3.f, 6.f, 10.f};
+
+/* true if both routes use the same waypoints and airways */
+static bool sameRoute(const QVector<RouteEntry>& route1, const QVector<RouteEntry>& route2)
+{
+  if(route1.size() != route2.size())
+    return false;
+
+  for(int i = 0; i < route1.size(); i++)
+  {
+    const RouteEntry& e1 = route1.at(i), & e2 = route2.at(i);
+    if(e1.ref.id != e2.ref.id || e1.ref.objType != e2.ref.objType || e1.airwayId != e2.airwayId)
+      return false;
+  }
+  return true;
+}
+
+RouteCalcWorker::RouteCalcWorker(QObject *parent)
+  : QObject(parent)
+{
+  connect(&watcher, &QFutureWatcher<rc::CalcResultList>::finished, this, &RouteCalcWorker::calculateFinished);
+}
+
+RouteCalcWorker::~RouteCalcWorker()
+{
+  cancelAndWait();
+}
+
+void RouteCalcWorker::start(atools::routing::RouteNetwork *network, const rc::CalcParams& params)
+{
+  if(future.isRunning())
+  {
+    qWarning() << Q_FUNC_INFO << "Calculation already running";
+    return;
+  }
+
+  qDebug() << Q_FUNC_INFO << "alternatives" << params.numAlternatives << "timeout" << params.timeoutMs;
+
+  results.clear();
+  canceled.storeRelease(0);
+  timedOut.storeRelease(0);
+
+  future = QtConcurrent::run(this, &RouteCalcWorker::calculateThread, network, params);
+  watcher.setFuture(future);
+}
+
+void RouteCalcWorker::cancel()
+{
+  if(future.isRunning())
+  {
+    qDebug() << Q_FUNC_INFO;
+    canceled.storeRelease(1);
+  }
+}
+
+void RouteCalcWorker::cancelAndWait()
+{
+  if(future.isRunning())
+  {
+    cancel();
+    future.waitForFinished();
+  }
+}
+
+void RouteCalcWorker::calculateFinished()
+{
+  results = future.result();
+  qDebug() << Q_FUNC_INFO << "results" << results.size() << "canceled" << isCanceled() << "timed out" << isTimedOut();
+  emit finished();
+}
+
+rc::CalcResultList RouteCalcWorker::calculateThread(atools::routing::RouteNetwork *network, rc::CalcParams params)
+{
+  rc::CalcResultList resultList;
+
+  // Best route with user selected cost factor first and then the alternatives ====================
+  QVector<float> costFactors({params.costFactorForceAirways});
+  if(params.numAlternatives > 0 && params.mode & atools::routing::MODE_AIRWAY &&
+     params.mode & atools::routing::MODE_WAYPOINT)
+  {
+    // Varying the cost factor makes only sense if both airways and direct connections are allowed
+    for(float factor : ALTERNATIVE_COST_FACTORS)
+    {
+      if(!costFactors.contains(factor))
+        costFactors.append(factor);
+    }
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  int numRuns = costFactors.size();
+  for(int run = 0; run < numRuns && resultList.size() <= params.numAlternatives; run++)
+  {
+    RouteFinder routeFinder(network);
+    routeFinder.setCostFactorForceAirways(costFactors.at(run));
+    routeFinder.setPreferVorToAirway(params.preferVor);
+    routeFinder.setPreferNdbToAirway(params.preferNdb);
+
+    int lastValue = -1;
+    routeFinder.setProgressCallback([ =, &timer, &lastValue](int distToDest, int currentDistToDest) -> bool {
+      if(params.timeoutMs > 0 && timer.hasExpired(params.timeoutMs))
+      {
+        timedOut.storeRelease(1);
+        return false;
+      }
+
+      if(distToDest > 0)
+      {
+        // Send only if changed to avoid flooding the event queue
+        int value = run * PROGRESS_STEPS + PROGRESS_STEPS * (distToDest - currentDistToDest) / distToDest;
+        if(value != lastValue)
+        {
+          lastValue = value;
+          emit progress(numRuns * PROGRESS_STEPS, value);
+        }
+      }
+      return canceled.loadAcquire() == 0;
+    });
+
+    bool found = routeFinder.calculateRoute(params.departurePos, params.destinationPos,
+                                            atools::roundToInt(params.altitudeFt), params.mode);
+
+    if(isCanceled() || isTimedOut())
+      break;
+
+    if(found)
+    {
+      rc::CalcResult result;
+      result.costFactorForceAirways = costFactors.at(run);
+      RouteExtractor(&routeFinder).extractRoute(result.entries, result.distanceMeter);
+
+      bool duplicate = false;
+      for(const rc::CalcResult& res : resultList)
+      {
+        if(sameRoute(res.entries, result.entries))
+        {
+          duplicate = true;
+          break;
+        }
+      }
+
+      if(!duplicate)
+        resultList.append(result);
+    }
+    else if(run == 0)
+      // Not found with the user selected parameters - alternatives will not help either
+      break;
+  }
+
+  // Keep best route from user parameters first and sort alternatives by distance
+  if(resultList.size() > 2)
+    std::sort(resultList.begin() + 1, resultList.end(), [](const rc::CalcResult& r1, const rc::CalcResult& r2) -> bool {
+      return r1.distanceMeter < r2.distanceMeter;
+    });
+
+  qDebug() << Q_FUNC_INFO << "runs" << numRuns << "found" << resultList.size() << "in" << timer.elapsed() << "ms";
+
+  return resultList;
+}
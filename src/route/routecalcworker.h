@@ -0,0 +1,139 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_ROUTECALCWORKER_H
+#define LNM_ROUTECALCWORKER_H
+
+#include "route/routeextractor.h"
+#include "routing/routenetworktypes.h"
+#include "geo/pos.h"
+
+#include <QFutureWatcher>
+#include <QAtomicInt>
+
+namespace atools {
+namespace routing {
+class RouteNetwork;
+}
+}
+
+namespace rc {
+
+/* Parameters for a route finder run. Copied into the worker thread. */
+struct CalcParams
+{
+  atools::geo::Pos departurePos, destinationPos;
+  float altitudeFt = 0.f;
+  atools::routing::Modes mode = atools::routing::MODE_NONE;
+
+  /* Cost factor for direct connections as selected in the window */
+  float costFactorForceAirways = 1.f;
+  bool preferVor = false, preferNdb = false;
+
+  /* Number of alternative routes to search in addition to the best one */
+  int numAlternatives = 0;
+
+  /* Stop all calculations after this time. Routes found up to this point are kept. */
+  int timeoutMs = 0;
+};
+
+/* One calculated route. Departure and destination are not included in entries. */
+struct CalcResult
+{
+  QVector<RouteEntry> entries;
+  float distanceMeter = 0.f;
+
+  /* Cost factor for direct connections which was used to find this route */
+  float costFactorForceAirways = 1.f;
+};
+
+typedef QVector<CalcResult> CalcResultList;
+
+}
+
+/*
+ * Runs the route finder in a background thread. The network has to be loaded by the caller in the main thread
+ * since database queries are bound to the thread that created them.
+ *
+ * Finds the best route and up to a given number of alternatives by repeating the search with different cost
+ * factors for direct connections. Duplicates are removed and alternatives are sorted by distance.
+ *
+ * The network must not be accessed or cleared while a calculation is running. Call cancelAndWait() before.
+ */
+class RouteCalcWorker :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit RouteCalcWorker(QObject *parent);
+  virtual ~RouteCalcWorker() override;
+
+  /* Start calculation in background. Emits progress and finished. Does nothing if already running. */
+  void start(atools::routing::RouteNetwork *network, const rc::CalcParams& params);
+
+  /* Ask calculation to stop. finished is emitted later. */
+  void cancel();
+
+  /* Stop calculation and wait until the thread is done */
+  void cancelAndWait();
+
+  bool isRunning() const
+  {
+    return future.isRunning();
+  }
+
+  /* true if stopped by cancel() */
+  bool isCanceled() const
+  {
+    return canceled.loadAcquire() != 0;
+  }
+
+  /* true if stopped due to timeout */
+  bool isTimedOut() const
+  {
+    return timedOut.loadAcquire() != 0;
+  }
+
+  /* Route for the given parameters first and alternatives sorted by distance. Valid after finished was emitted. */
+  const rc::CalcResultList& getResults() const
+  {
+    return results;
+  }
+
+signals:
+  /* Progress for all runs. Sent from the worker thread. */
+  void progress(int maximum, int value);
+
+  /* Calculation is done, canceled or timed out. Sent in the main thread. */
+  void finished();
+
+private:
+  /* Called in background thread */
+  rc::CalcResultList calculateThread(atools::routing::RouteNetwork *network, rc::CalcParams params);
+  void calculateFinished();
+
+  /* Steps used for the progress value for each run */
+  static Q_DECL_CONSTEXPR int PROGRESS_STEPS = 1000;
+
+  QFuture<rc::CalcResultList> future;
+  QFutureWatcher<rc::CalcResultList> watcher;
+  QAtomicInt canceled, timedOut;
+  rc::CalcResultList results;
+};
+
+#endif // LNM_ROUTECALCWORKER_H
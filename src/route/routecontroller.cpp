@@ -44,11 +44,9 @@
 #include "query/airportquery.h"
 #include "mapgui/mapwidget.h"
 #include "parkingdialog.h"
-#include "routing/routefinder.h"
 #include "routing/routenetwork.h"
 #include "route/customproceduredialog.h"
 #include "settings/settings.h"
-#include "routeextractor.h"
 #include "ui_mainwindow.h"
 #include "gui/dialog.h"
 #include "route/routealtitude.h"
@@ -63,13 +61,13 @@
 #include "common/mapcolors.h"
 #include "common/unit.h"
 #include "route/routecalcwindow.h"
+#include "route/routenetworkcache.h"
 #include "common/unitstringtool.h"
 #include "perf/aircraftperfcontroller.h"
-#include "fs/sc/simconnectdata.h"
+#include "connect/simdatasnapshot.h"
 #include "gui/tabwidgethandler.h"
 #include "gui/choicedialog.h"
 #include "geo/calculations.h"
-#include "routing/routenetworkloader.h"
 
 #include <QClipboard>
 #include <QFile>
@@ -77,7 +75,6 @@
 #include <QInputDialog>
 #include <QFileInfo>
 #include <QTextTable>
-#include <QProgressDialog>
 
 namespace rc {
 // Route table column indexes
@@ -204,10 +201,10 @@ RouteController::RouteController(QMainWindow *parentWindow, QTableView *tableVie
   view->setContextMenuPolicy(Qt::CustomContextMenu);
 
   // Create flight plan calculation caches
-  routeNetworkRadio = new atools::routing::RouteNetwork(atools::routing::SOURCE_RADIO);
-  routeNetworkAirway = new atools::routing::RouteNetwork(atools::routing::SOURCE_AIRWAY);
+  routeNetworkCache = new RouteNetworkCache(this);
 
   routeWindow = new RouteCalcWindow(mainWindow);
+  routeCalcWorker = new RouteCalcWorker(this);
 
   // Set up undo/redo framework
   undoStack = new QUndoStack(mainWindow);
@@ -305,19 +302,30 @@ RouteController::RouteController(QMainWindow *parentWindow, QTableView *tableVie
   connect(routeWindow, &RouteCalcWindow::calculateClicked, this, &RouteController::calculateRoute);
   connect(routeWindow, &RouteCalcWindow::calculateDirectClicked, this, &RouteController::calculateDirect);
   connect(routeWindow, &RouteCalcWindow::calculateReverseClicked, this, &RouteController::reverseRoute);
+  connect(routeWindow, &RouteCalcWindow::cancelClicked, this, &RouteController::calculateRouteCancel);
+  connect(routeWindow, &RouteCalcWindow::alternativeSelected,
+          this, &RouteController::calculateRouteAlternativeSelected);
+  connect(this, &RouteController::routeChanged, this, &RouteController::calculateRouteInvalidate);
+
+  // Progress is sent from the worker thread and queued automatically
+  connect(routeCalcWorker, &RouteCalcWorker::progress, routeWindow, &RouteCalcWindow::calculationProgress);
+  connect(routeCalcWorker, &RouteCalcWorker::finished, this, &RouteController::calculateRouteFinished);
 }
 
 RouteController::~RouteController()
 {
   routeAltDelayTimer.stop();
+
+  // Stop calculation before deleting the networks
+  routeCalcWorker->cancelAndWait();
+  delete routeCalcWorker;
   delete routeWindow;
   delete tabHandlerRoute;
   delete units;
   delete entryBuilder;
   delete model;
   delete undoStack;
-  delete routeNetworkRadio;
-  delete routeNetworkAirway;
+  delete routeNetworkCache;
   delete zoomHandler;
   delete symbolPainter;
   delete flightplanIO;
@@ -1479,6 +1487,9 @@ void RouteController::calculateRoute()
 {
   qDebug() << Q_FUNC_INFO;
 
+  if(routeCalcWorker->isRunning())
+    return;
+
   atools::routing::RouteNetwork *net = nullptr;
   atools::fs::pln::RouteType type = atools::fs::pln::UNKNOWN;
   QString command;
@@ -1488,7 +1499,6 @@ void RouteController::calculateRoute()
   // Build configuration for route finder =======================================
   if(routeWindow->getRoutingType() == rd::AIRWAY)
   {
-    net = routeNetworkAirway;
     fetchAirways = true;
 
     // Airway preference =======================================
@@ -1536,226 +1546,260 @@ void RouteController::calculateRoute()
     // Radionav settings ========================================
     command = tr("Radionnav Flight Plan Calculation");
     fetchAirways = false;
-    net = routeNetworkRadio;
     type = atools::fs::pln::VOR;
     mode = atools::routing::MODE_RADIONAV_VOR;
     if(routeWindow->isRadionavNdb())
       mode |= atools::routing::MODE_RADIONAV_NDB;
   }
 
-  if(!net->isLoaded())
-  {
-    atools::routing::RouteNetworkLoader loader(NavApp::getDatabaseNav(), NavApp::getDatabaseTrack());
-    loader.load(net);
-  }
+  // Stop any background tasks
+  beforeRouteCalc();
 
-  atools::routing::RouteFinder routeFinder(net);
-  routeFinder.setCostFactorForceAirways(routeWindow->getAirwayPreferenceCostFactor());
+  // Wait for background loading or load network from database if not already done
+  QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+  net = fetchAirways ? routeNetworkCache->getNetworkAirway() : routeNetworkCache->getNetworkRadio();
+  QGuiApplication::restoreOverrideCursor();
+
+  // Remember all parameters needed to build the flight plan when the worker is done
+  calcRouteType = type;
+  calcCommandName = command;
+  calcFetchAirways = fetchAirways;
+  calcAltitudeFt = routeWindow->getCruisingAltitudeFt();
+  calcFromIndex = calcToIndex = -1;
+  calcResults.clear();
 
-  int fromIdx = -1, toIdx = -1;
+  rc::CalcParams params;
   if(routeWindow->isCalculateSelection())
   {
-    fromIdx = routeWindow->getRouteRangeFromIndex();
-    toIdx = routeWindow->getRouteRangeToIndex();
-  }
+    calcFromIndex = std::max(route.getStartIndexAfterProcedure(), routeWindow->getRouteRangeFromIndex());
+    calcToIndex = std::min(route.getDestinationIndexBeforeProcedure(), routeWindow->getRouteRangeToIndex());
 
-  if(calculateRouteInternal(&routeFinder, type, command, fetchAirways, routeWindow->getCruisingAltitudeFt(),
-                            fromIdx, toIdx, mode))
-    NavApp::setStatusMessage(tr("Calculated flight plan."));
+    params.departurePos = route.value(calcFromIndex).getPosition();
+    params.destinationPos = route.value(calcToIndex).getPosition();
+  }
   else
-    NavApp::setStatusMessage(tr("No route found."));
+  {
+    params.departurePos = route.getStartAfterProcedure().getPosition();
+    params.destinationPos = route.getDestinationBeforeProcedure().getPosition();
+  }
 
-  routeWindow->updateWidgets();
+  atools::settings::Settings& settings = atools::settings::Settings::instance();
+  params.altitudeFt = calcAltitudeFt;
+  params.mode = mode;
+  params.costFactorForceAirways = routeWindow->getAirwayPreferenceCostFactor();
+  params.preferVor = OptionData::instance().getFlags() & opts::ROUTE_PREFER_VOR;
+  params.preferNdb = OptionData::instance().getFlags() & opts::ROUTE_PREFER_NDB;
+  params.numAlternatives = settings.getAndStoreValue(lnm::ROUTE_CALC_NUM_ALTERNATIVES, 3).toInt();
+  params.timeoutMs = settings.getAndStoreValue(lnm::ROUTE_CALC_TIMEOUT_SECONDS, 30).toInt() * 1000;
+  calcDeparturePos = params.departurePos;
+  calcDestinationPos = params.destinationPos;
+
+  NavApp::setStatusMessage(tr("Calculating flight plan ..."));
+  routeWindow->calculationStarted();
+
+  // Calls calculateRouteFinished() when done
+  routeCalcWorker->start(net, params);
 }
 
-void RouteController::clearAirwayNetworkCache()
+void RouteController::calculateRouteCancel()
 {
-  routeNetworkAirway->clear();
+  routeCalcWorker->cancel();
 }
 
-/* Calculate a flight plan to all types */
-bool RouteController::calculateRouteInternal(atools::routing::RouteFinder *routeFinder, atools::fs::pln::RouteType type,
-                                             const QString& commandName, bool fetchAirways,
-                                             float altitudeFt, int fromIndex, int toIndex,
-                                             atools::routing::Modes mode)
+void RouteController::calculateRouteFinished()
 {
-  bool calcRange = fromIndex != -1 && toIndex != -1;
-  int oldRouteSize = route.size();
+  routeWindow->calculationFinished();
 
-  // Stop any background tasks
-  beforeRouteCalc();
+  if(routeCalcWorker->isCanceled())
+  {
+    NavApp::setStatusMessage(tr("Flight plan calculation canceled."));
+    return;
+  }
 
-  Flightplan& flightplan = route.getFlightplan();
+  // Remove all routes which are too long compared to the direct connection ====================
+  float directDistance = calcDeparturePos.distanceMeterTo(calcDestinationPos);
+  for(const rc::CalcResult& result : routeCalcWorker->getResults())
+  {
+    float ratio = result.distanceMeter / directDistance;
+    qDebug() << "route distance" << QString::number(result.distanceMeter, 'f', 0)
+             << "direct distance" << QString::number(directDistance, 'f', 0) << "ratio" << ratio
+             << "cost factor" << result.costFactorForceAirways;
 
-  // Load network from database if not already done
-  QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+    if(ratio < MAX_DISTANCE_DIRECT_RATIO)
+      calcResults.append(result);
+  }
 
-  routeFinder->setPreferVorToAirway(OptionData::instance().getFlags() & opts::ROUTE_PREFER_VOR);
-  routeFinder->setPreferNdbToAirway(OptionData::instance().getFlags() & opts::ROUTE_PREFER_NDB);
+  if(!calcResults.isEmpty())
+  {
+    QStringList texts;
+    for(int i = 0; i < calcResults.size(); i++)
+    {
+      const rc::CalcResult& result = calcResults.at(i);
+      if(i == 0)
+        texts.append(tr("Best: %1, %2 waypoints").
+                     arg(Unit::distMeter(result.distanceMeter)).arg(result.entries.size()));
+      else
+        texts.append(tr("Alternative %1: %2, %3 waypoints").
+                     arg(i).arg(Unit::distMeter(result.distanceMeter)).arg(result.entries.size()));
+    }
 
-  Pos departurePos, destinationPos;
+    applyCalculatedRoute(calcResults.first(), calcCommandName);
+    routeWindow->setAlternatives(texts);
 
-  if(calcRange)
+    if(routeCalcWorker->isTimedOut())
+      NavApp::setStatusMessage(tr("Calculation timed out. Using best flight plan found so far."));
+    else
+      NavApp::setStatusMessage(tr("Calculated flight plan."));
+  }
+  else
   {
-    fromIndex = std::max(route.getStartIndexAfterProcedure(), fromIndex);
-    toIndex = std::min(route.getDestinationIndexBeforeProcedure(), toIndex);
+    NavApp::setStatusMessage(tr("No route found."));
 
-    departurePos = route.value(fromIndex).getPosition();
-    destinationPos = route.value(toIndex).getPosition();
+    QString message;
+    if(routeCalcWorker->isTimedOut())
+      message = tr("Cannot calculate a flight plan within the time limit.\n"
+                   "Try another calculation type, change the cruise altitude or\n"
+                   "create the flight plan manually.");
+    else
+      message = tr("Cannot calculate a flight plan.\n"
+                   "Try another calculation type, change the cruise altitude or\n"
+                   "create the flight plan manually.");
+
+    atools::gui::Dialog(mainWindow).showInfoMsgBox(lnm::ACTIONS_SHOWROUTE_ERROR, message,
+                                                   tr("Do not &show this dialog again."));
   }
-  else
+}
+
+void RouteController::calculateRouteAlternativeSelected(int index)
+{
+  if(index >= 0 && index < calcResults.size())
   {
-    departurePos = route.getStartAfterProcedure().getPosition();
-    destinationPos = route.getDestinationBeforeProcedure().getPosition();
+    qDebug() << Q_FUNC_INFO << index;
+    applyCalculatedRoute(calcResults.at(index), index == 0 ? calcCommandName :
+                         tr("%1 (Alternative %2)").arg(calcCommandName).arg(index));
   }
+}
+
+void RouteController::calculateRouteInvalidate()
+{
+  if(!applyingCalculatedRoute)
+  {
+    // Flight plan was changed by user - calculation parameters or alternatives are not valid anymore
+    if(routeCalcWorker->isRunning())
+      routeCalcWorker->cancel();
 
-  // ===================================================================
-  // Set up a progress dialog which shows for all calculations taking more than half a second
-  QProgressDialog progress(tr("Calculating Flight Plan ..."), tr("Cancel"), 0, 0, mainWindow);
-  progress.setWindowTitle(tr("Little Navmap - Calculating Flight Plan"));
-  progress.setWindowFlags(progress.windowFlags() & ~Qt::WindowContextHelpButtonHint);
-  progress.setWindowModality(Qt::ApplicationModal);
-  progress.setMinimumDuration(500);
-
-  bool dialogShown = false, canceled = false;
-  routeFinder->setProgressCallback([&progress, &canceled, &dialogShown](int distToDest, int currentDistToDest) -> bool {
-    progress.setMaximum(distToDest);
-    progress.setValue(distToDest - currentDistToDest);
-    canceled = progress.wasCanceled();
-
-    if(!dialogShown && progress.isVisible())
+    if(!calcResults.isEmpty())
     {
-      // Dialog is shown - remove wait cursor
-      dialogShown = true;
-      QGuiApplication::restoreOverrideCursor();
+      calcResults.clear();
+      routeWindow->clearAlternatives();
     }
+  }
+}
 
-    return !canceled;
-  });
-
-  // Calculate the route - calls above lambda ================================================
-  bool found = routeFinder->calculateRoute(departurePos, destinationPos, atools::roundToInt(altitudeFt), mode);
+void RouteController::preloadRouteNetworks()
+{
+  // Networks must not be changed while the worker uses them
+  if(!routeCalcWorker->isRunning())
+    routeNetworkCache->preload();
+}
 
-  if(!dialogShown)
-    QGuiApplication::restoreOverrideCursor();
+void RouteController::clearAirwayNetworkCache()
+{
+  // Worker uses network
+  routeCalcWorker->cancelAndWait();
+  routeNetworkCache->tracksChanged();
+}
 
-  // Hide dialog
-  progress.reset();
+/* Replace flight plan or selected legs with a calculated route */
+void RouteController::applyCalculatedRoute(const rc::CalcResult& result, const QString& commandName)
+{
+  bool calcRange = calcFromIndex != -1 && calcToIndex != -1;
+  int oldRouteSize = route.size();
+  applyingCalculatedRoute = true;
 
-  // Create wait cursor if calculation takes too long
+  Flightplan& flightplan = route.getFlightplan();
   QGuiApplication::setOverrideCursor(Qt::WaitCursor);
 
-  if(found && !canceled)
-  {
-    // A route was found
-    float distance = 0.f;
-    QVector<RouteEntry> calculatedRoute;
-
-    // Fetch waypoints
-    RouteExtractor extractor(routeFinder);
-    extractor.extractRoute(calculatedRoute, distance);
-
-    // Compare to direct connection and check if route is too long
-    float directDistance = departurePos.distanceMeterTo(destinationPos);
-    float ratio = distance / directDistance;
-    qDebug() << "route distance" << QString::number(distance, 'f', 0)
-             << "direct distance" << QString::number(directDistance, 'f', 0) << "ratio" << ratio;
-
-    if(ratio < MAX_DISTANCE_DIRECT_RATIO)
-    {
-      // Start undo
-      RouteCommand *undoCommand = preChange(commandName);
-      int numAlternateLegs = route.getNumAlternateLegs();
+  // Start undo
+  RouteCommand *undoCommand = preChange(commandName);
+  int numAlternateLegs = route.getNumAlternateLegs();
 
-      QList<FlightplanEntry>& entries = flightplan.getEntries();
+  QList<FlightplanEntry>& entries = flightplan.getEntries();
 
-      flightplan.setRouteType(type);
-      if(calcRange)
-        entries.erase(flightplan.getEntries().begin() + fromIndex + 1, flightplan.getEntries().begin() + toIndex);
-      else
-        // Erase all but start and destination
-        entries.erase(flightplan.getEntries().begin() + 1, entries.end() - numAlternateLegs - 1);
+  flightplan.setRouteType(calcRouteType);
+  if(calcRange)
+    entries.erase(flightplan.getEntries().begin() + calcFromIndex + 1, flightplan.getEntries().begin() + calcToIndex);
+  else
+    // Erase all but start and destination
+    entries.erase(flightplan.getEntries().begin() + 1, entries.end() - numAlternateLegs - 1);
 
-      int idx = 1;
-      // Create flight plan entries - will be copied later to the route map objects
-      for(const RouteEntry& routeEntry : calculatedRoute)
-      {
-        FlightplanEntry flightplanEntry;
-        entryBuilder->buildFlightplanEntry(routeEntry.ref.id, atools::geo::EMPTY_POS, routeEntry.ref.objType,
-                                           flightplanEntry, fetchAirways);
-        if(fetchAirways && routeEntry.airwayId != -1)
-          // Get airway by id - needed to fetch the name first
-          updateFlightplanEntryAirway(routeEntry.airwayId, flightplanEntry);
-
-        if(calcRange)
-          entries.insert(flightplan.getEntries().begin() + fromIndex + idx, flightplanEntry);
-        else
-          entries.insert(entries.end() - numAlternateLegs - 1, flightplanEntry);
-        idx++;
-      }
+  int idx = 1;
+  // Create flight plan entries - will be copied later to the route map objects
+  for(const RouteEntry& routeEntry : result.entries)
+  {
+    FlightplanEntry flightplanEntry;
+    entryBuilder->buildFlightplanEntry(routeEntry.ref.id, atools::geo::EMPTY_POS, routeEntry.ref.objType,
+                                       flightplanEntry, calcFetchAirways);
+    if(calcFetchAirways && routeEntry.airwayId != -1)
+      // Get airway by id - needed to fetch the name first
+      updateFlightplanEntryAirway(routeEntry.airwayId, flightplanEntry);
+
+    if(calcRange)
+      entries.insert(flightplan.getEntries().begin() + calcFromIndex + idx, flightplanEntry);
+    else
+      entries.insert(entries.end() - numAlternateLegs - 1, flightplanEntry);
+    idx++;
+  }
 
-      // Remove procedure points from flight plan
-      flightplan.removeNoSaveEntries();
+  // Remove procedure points from flight plan
+  flightplan.removeNoSaveEntries();
 
-      // Copy flight plan to route object
-      route.createRouteLegsFromFlightplan();
+  // Copy flight plan to route object
+  route.createRouteLegsFromFlightplan();
 
-      // Reload procedures from properties
-      loadProceduresFromFlightplan(true /* clear old procedure properties */, true /* quiet */, nullptr);
-      loadAlternateFromFlightplan(true /* quiet */);
-      QGuiApplication::restoreOverrideCursor();
+  // Reload procedures from properties
+  loadProceduresFromFlightplan(true /* clear old procedure properties */, true /* quiet */, nullptr);
+  loadAlternateFromFlightplan(true /* quiet */);
+  QGuiApplication::restoreOverrideCursor();
 
-      // Remove duplicates in flight plan and route
-      route.removeDuplicateRouteLegs();
-      route.updateAll();
+  // Remove duplicates in flight plan and route
+  route.removeDuplicateRouteLegs();
+  route.updateAll();
 
-      flightplan.setCruisingAltitude(atools::roundToInt(Unit::rev(altitudeFt, Unit::altFeetF)));
+  flightplan.setCruisingAltitude(atools::roundToInt(Unit::rev(calcAltitudeFt, Unit::altFeetF)));
 
-      bool adjustRouteType = type != atools::fs::pln::HIGH_ALTITUDE && type != atools::fs::pln::LOW_ALTITUDE &&
-                             type != atools::fs::pln::VOR;
-      route.updateAirwaysAndAltitude(false /* adjustRouteAltitude */, adjustRouteType);
+  bool adjustRouteType = calcRouteType != atools::fs::pln::HIGH_ALTITUDE &&
+                         calcRouteType != atools::fs::pln::LOW_ALTITUDE && calcRouteType != atools::fs::pln::VOR;
+  route.updateAirwaysAndAltitude(false /* adjustRouteAltitude */, adjustRouteType);
 
-      updateActiveLeg();
+  updateActiveLeg();
 
-      route.updateLegAltitudes();
+  route.updateLegAltitudes();
 
-      updateTableModel();
+  updateTableModel();
 
-      postChange(undoCommand);
-      NavApp::updateWindowTitle();
+  postChange(undoCommand);
+  NavApp::updateWindowTitle();
 
 #ifdef DEBUG_INFORMATION
-      qDebug() << flightplan;
+  qDebug() << flightplan;
 #endif
 
-      updateErrorLabel();
-
-      if(calcRange)
-      {
-        // will also update route window
-        int newToIndex = toIndex - (oldRouteSize - route.size());
-        selectRange(fromIndex, newToIndex);
-      }
+  updateErrorLabel();
 
-      emit routeChanged(true);
-    }
-    else
-      // Too long
-      found = false;
+  if(calcRange)
+  {
+    // will also update route window - remember new end of range for alternatives
+    calcToIndex = calcToIndex - (oldRouteSize - route.size());
+    selectRange(calcFromIndex, calcToIndex);
   }
 
-  QGuiApplication::restoreOverrideCursor();
-  if(!found && !canceled)
-    atools::gui::Dialog(mainWindow).showInfoMsgBox(lnm::ACTIONS_SHOWROUTE_ERROR,
-                                                   tr("Cannot calculate a flight plan.\n"
-                                                      "Try another calculation type, change the cruise altitude or\n"
-                                                      "create the flight plan manually."),
-                                                   tr("Do not &show this dialog again."));
+  emit routeChanged(true);
+  applyingCalculatedRoute = false;
+
 #ifdef DEBUG_INFORMATION
   qDebug() << Q_FUNC_INFO << route;
 #endif
-
-  return found;
 }
 
 void RouteController::adjustFlightplanAltitude()
@@ -1843,6 +1887,8 @@ void RouteController::preDatabaseLoad()
 {
   loadingDatabaseState = true;
   routeAltDelayTimer.stop();
+  routeCalcWorker->cancelAndWait();
+  routeNetworkCache->preDatabaseLoad();
 
   // Reset active to avoid crash when indexes change
   route.resetActive();
@@ -1853,8 +1899,8 @@ void RouteController::preDatabaseLoad()
 
 void RouteController::postDatabaseLoad()
 {
-  routeNetworkRadio->clear();
-  routeNetworkAirway->clear();
+  routeCalcWorker->cancelAndWait();
+  routeNetworkCache->postDatabaseLoad();
 
   // Remove the legs but keep the properties
   route.clearProcedures(proc::PROCEDURE_ALL);
@@ -4004,8 +4050,9 @@ void RouteController::disconnectedFromSimulator()
   emit routeChanged(false);
 }
 
-void RouteController::simDataChanged(const atools::fs::sc::SimConnectData& simulatorData)
+void RouteController::simDataChanged(const SimDataSnapshot& snapshot)
 {
+  const atools::fs::sc::SimConnectData& simulatorData = *snapshot;
   if(!loadingDatabaseState && atools::almostNotEqual(QDateTime::currentDateTime().toMSecsSinceEpoch(),
                                                      lastSimUpdate, static_cast<qint64>(MIN_SIM_UPDATE_TIME_MS)))
   {
@@ -4596,20 +4643,15 @@ void RouteController::debugNetworkClick(const atools::geo::Pos& pos)
   {
     qDebug() << Q_FUNC_INFO << pos;
 
-    atools::routing::RouteNetworkLoader loader(NavApp::getDatabaseNav(), NavApp::getDatabaseTrack());
-    if(!routeNetworkAirway->isLoaded())
-      loader.load(routeNetworkAirway);
-    if(!routeNetworkRadio->isLoaded())
-      loader.load(routeNetworkRadio);
-
-    atools::routing::Node node = routeNetworkAirway->getNearestNode(pos);
+    routeCalcWorker->cancelAndWait();
+    atools::routing::Node node = routeNetworkCache->getNetworkAirway()->getNearestNode(pos);
     if(node.isValid())
     {
       qDebug() << "Airway node" << node;
       qDebug() << "Airway edges" << node.edges;
     }
 
-    node = routeNetworkRadio->getNearestNode(pos);
+    node = routeNetworkCache->getNetworkRadio()->getNearestNode(pos);
     if(node.isValid())
     {
       qDebug() << "Radio node" << node;
@@ -21,6 +21,7 @@
 #include "route/routecommand.h"
 #include "routing/routenetworktypes.h"
 #include "route/route.h"
+#include "route/routecalcworker.h"
 #include "common/tabindexes.h"
 
 #include <QIcon>
@@ -29,7 +30,6 @@
 
 namespace atools {
 namespace routing {
-class RouteFinder;
 class RouteNetwork;
 }
 namespace gui {
@@ -63,6 +63,8 @@ class AirwayTrackQuery;
 class UnitStringTool;
 class QTextCursor;
 class RouteCalcWindow;
+class RouteNetworkCache;
+class SimDataSnapshot;
 
 /*
  * All flight plan related tasks like saving, loading, modification, calculation and table
@@ -231,7 +233,7 @@ public:
 
   void disconnectedFromSimulator();
 
-  void simDataChanged(const atools::fs::sc::SimConnectData& simulatorData);
+  void simDataChanged(const SimDataSnapshot& snapshot);
 
   void editUserWaypointName(int index);
 
@@ -270,9 +272,12 @@ public:
     return tabHandlerRoute;
   }
 
-  /* Clear network, so it will be reloaded before next flight plan calculation. */
+  /* Tracks were reloaded. Airway network is reloaded in background if the track database has changed. */
   void clearAirwayNetworkCache();
 
+  /* Load flight plan calculation networks in background to avoid delay on first calculation */
+  void preloadRouteNetworks();
+
 #ifdef DEBUG_INFORMATION
   void debugNetworkClick(const atools::geo::Pos& pos);
 
@@ -366,12 +371,21 @@ private:
 
   void clearRoute();
 
-  /* Calculate flight plan pressed in dock window */
+  /* Calculate flight plan pressed in dock window. Starts the background worker. */
   void calculateRoute();
-  bool calculateRouteInternal(atools::routing::RouteFinder *routeFinder, atools::fs::pln::RouteType type,
-                              const QString& commandName,
-                              bool fetchAirways, float altitudeFt, int fromIndex, int toIndex,
-                              atools::routing::Modes mode);
+
+  /* Worker is done. Apply best route and fill alternatives. */
+  void calculateRouteFinished();
+  void calculateRouteCancel();
+
+  /* Replace flight plan with one of the alternatives from the last calculation */
+  void calculateRouteAlternativeSelected(int index);
+
+  /* Flight plan was changed - stop calculation and clear alternatives */
+  void calculateRouteInvalidate();
+
+  /* Create flight plan entries from calculation result using the calc* parameters below */
+  void applyCalculatedRoute(const rc::CalcResult& result, const QString& commandName);
 
   void updateModelRouteTimeFuel();
 
@@ -449,7 +463,7 @@ private:
   int undoIndexClean = 0;
 
   /* Network cache for flight plan calculation */
-  atools::routing::RouteNetwork *routeNetworkRadio = nullptr, *routeNetworkAirway = nullptr;
+  RouteNetworkCache *routeNetworkCache = nullptr;
 
   /* Flightplan and route objects */
   Route route; /* real route containing all segments */
@@ -474,6 +488,20 @@ private:
   /* Route calculation dock window controller */
   RouteCalcWindow *routeWindow = nullptr;
 
+  /* Runs route finder in background */
+  RouteCalcWorker *routeCalcWorker = nullptr;
+
+  /* Parameters of the last flight plan calculation needed to apply the results */
+  atools::fs::pln::RouteType calcRouteType = atools::fs::pln::UNKNOWN;
+  QString calcCommandName;
+  bool calcFetchAirways = false, applyingCalculatedRoute = false;
+  float calcAltitudeFt = 0.f;
+  int calcFromIndex = -1, calcToIndex = -1;
+  atools::geo::Pos calcDeparturePos, calcDestinationPos;
+
+  /* Best route first and alternatives sorted by distance */
+  QVector<rc::CalcResult> calcResults;
+
   /* Do not update aircraft information more than every 0.1 seconds */
   static Q_DECL_CONSTEXPR int MIN_SIM_UPDATE_TIME_MS = 100;
   static Q_DECL_CONSTEXPR int ROUTE_ALT_CHANGE_DELAY_MS = 500;
@@ -0,0 +1,271 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "route/routelegindex.h"
+
+#include "route/route.h"
+#include "geo/calculations.h"
+
+#include <cmath>
+
+using atools::geo::Pos;
+using atools::geo::LineDistance;
+
+/* Use a slightly smaller radius than the distance calculations to get a safe lower bound */
+static const float LOWER_BOUND_EARTH_RADIUS_METER = 6300000.f;
+
+float RouteLegIndex::Box::distance(const float point[3]) const
+{
+  float sum = 0.f;
+  for(int i = 0; i < 3; i++)
+  {
+    float diff = 0.f;
+    if(point[i] < min[i])
+      diff = min[i] - point[i];
+    else if(point[i] > max[i])
+      diff = point[i] - max[i];
+    sum += diff * diff;
+  }
+  return std::sqrt(sum);
+}
+
+void RouteLegIndex::clear()
+{
+  nodes.clear();
+  segments.clear();
+  courses.clear();
+  root = -1;
+}
+
+void RouteLegIndex::toCartesian(const Pos& pos, float point[3])
+{
+  float lon = atools::geo::toRadians(pos.getLonX()), lat = atools::geo::toRadians(pos.getLatY());
+  point[0] = std::cos(lat) * std::cos(lon);
+  point[1] = std::cos(lat) * std::sin(lon);
+  point[2] = std::sin(lat);
+}
+
+float RouteLegIndex::chordToMeter(float chord)
+{
+  return 2.f * std::asin(std::min(chord / 2.f, 1.f)) * LOWER_BOUND_EARTH_RADIUS_METER;
+}
+
+void RouteLegIndex::build(const Route& route)
+{
+  clear();
+
+  courses.fill(map::INVALID_COURSE_VALUE, route.size());
+  segments.reserve(route.size());
+
+  // First leg is the departure point and not a segment
+  for(int i = 1; i < route.size(); i++)
+  {
+    const Pos& pos1 = route.getPrevPositionAt(i);
+    const Pos& pos2 = route.getPositionAt(i);
+    if(!pos1.isValid() || !pos2.isValid())
+      continue;
+
+    if(pos1 != pos2)
+      courses[i] = atools::geo::normalizeCourse(pos1.angleDegTo(pos2));
+
+    Segment segment;
+    segment.pos1 = pos1;
+    segment.pos2 = pos2;
+    segment.leg = i;
+
+    float p1[3], p2[3];
+    toCartesian(pos1, p1);
+    toCartesian(pos2, p2);
+
+    // Arc is inside the chord box extended by the maximum distance between arc and chord
+    float chord = std::sqrt((p1[0] - p2[0]) * (p1[0] - p2[0]) + (p1[1] - p2[1]) * (p1[1] - p2[1]) +
+                            (p1[2] - p2[2]) * (p1[2] - p2[2]));
+    float halfAngle = std::asin(std::min(chord / 2.f, 1.f));
+    float bulge = 1.f - std::cos(halfAngle) + 1.e-6f;
+
+    for(int j = 0; j < 3; j++)
+    {
+      segment.box.min[j] = std::min(p1[j], p2[j]) - bulge;
+      segment.box.max[j] = std::max(p1[j], p2[j]) + bulge;
+    }
+    segments.append(segment);
+  }
+
+  if(!segments.isEmpty())
+  {
+    nodes.reserve(segments.size() * 2);
+    root = buildNode(segments, 0, segments.size() - 1);
+  }
+}
+
+int RouteLegIndex::buildNode(QVector<Segment>& segmentList, int first, int last)
+{
+  Node node;
+  node.box = segmentList.at(first).box;
+  for(int i = first + 1; i <= last; i++)
+    node.box.extend(segmentList.at(i).box);
+
+  if(first == last)
+  {
+    node.left = node.right = -1;
+    node.segment = first;
+  }
+  else
+  {
+    // Split at median of box centers along the longest axis
+    int axis = 0;
+    float maxExtent = 0.f;
+    for(int j = 0; j < 3; j++)
+    {
+      if(node.box.max[j] - node.box.min[j] > maxExtent)
+      {
+        maxExtent = node.box.max[j] - node.box.min[j];
+        axis = j;
+      }
+    }
+
+    int middle = (first + last) / 2;
+    std::nth_element(segmentList.begin() + first, segmentList.begin() + middle, segmentList.begin() + last + 1,
+                     [axis](const Segment& s1, const Segment& s2) -> bool
+    {
+      return s1.box.min[axis] + s1.box.max[axis] < s2.box.min[axis] + s2.box.max[axis];
+    });
+
+    node.segment = -1;
+    node.left = buildNode(segmentList, first, middle);
+    node.right = buildNode(segmentList, middle + 1, last);
+  }
+
+  nodes.append(node);
+  return nodes.size() - 1;
+}
+
+void RouteLegIndex::distance(LineDistance& result, const Pos& pos, int segment) const
+{
+  const Segment& seg = segments.at(segment);
+  pos.distanceMeterToLine(seg.pos1, seg.pos2, result);
+}
+
+void RouteLegIndex::searchNearest(int node, const Pos& pos, const float point[3], float& bestDistance,
+                                  int& bestSegment) const
+{
+  const Node& n = nodes.at(node);
+  if(chordToMeter(n.box.distance(point)) > bestDistance)
+    return;
+
+  if(n.segment != -1)
+  {
+    LineDistance result;
+    distance(result, pos, n.segment);
+    float dist = std::abs(result.distance);
+
+    // Lower leg index wins on equal distance
+    if(result.status != atools::geo::INVALID &&
+       (dist < bestDistance ||
+        (dist <= bestDistance && bestSegment != -1 && segments.at(n.segment).leg < segments.at(bestSegment).leg)))
+    {
+      bestDistance = dist;
+      bestSegment = n.segment;
+    }
+  }
+  else
+  {
+    // Visit closer child first to shrink the best distance early
+    float distLeft = nodes.at(n.left).box.distance(point), distRight = nodes.at(n.right).box.distance(point);
+    if(distLeft <= distRight)
+    {
+      searchNearest(n.left, pos, point, bestDistance, bestSegment);
+      searchNearest(n.right, pos, point, bestDistance, bestSegment);
+    }
+    else
+    {
+      searchNearest(n.right, pos, point, bestDistance, bestSegment);
+      searchNearest(n.left, pos, point, bestDistance, bestSegment);
+    }
+  }
+}
+
+void RouteLegIndex::searchRange(QVector<int>& result, int node, const float point[3], float maxDistanceMeter) const
+{
+  const Node& n = nodes.at(node);
+  if(chordToMeter(n.box.distance(point)) > maxDistanceMeter)
+    return;
+
+  if(n.segment != -1)
+    result.append(n.segment);
+  else
+  {
+    searchRange(result, n.left, point, maxDistanceMeter);
+    searchRange(result, n.right, point, maxDistanceMeter);
+  }
+}
+
+int RouteLegIndex::getNearestLeg(const map::PosCourse& pos, float maxDistanceMeter, LineDistance& result) const
+{
+  result.status = atools::geo::INVALID;
+  result.distance = map::INVALID_DISTANCE_VALUE;
+
+  if(root == -1 || !pos.isValid())
+    return map::INVALID_INDEX_VALUE;
+
+  float point[3];
+  toCartesian(pos.pos, point);
+
+  // Nearest segment by absolute cross track distance ===============================
+  float bestDistance = maxDistanceMeter;
+  int bestSegment = -1;
+  searchNearest(root, pos.pos, point, bestDistance, bestSegment);
+
+  if(bestSegment == -1)
+    return map::INVALID_INDEX_VALUE;
+
+  distance(result, pos.pos, bestSegment);
+  if(!pos.isCourseValid())
+    return segments.at(bestSegment).leg;
+
+  // Prefer a leg close to the nearest one which is flown in aircraft direction ===============================
+  QVector<int> candidates;
+  searchRange(candidates, root, point, bestDistance + CANDIDATE_TOLERANCE_METER);
+
+  int bestLeg = segments.at(bestSegment).leg;
+  float bestCourseDiff = map::INVALID_COURSE_VALUE;
+  LineDistance candidateResult;
+  for(int segment : candidates)
+  {
+    int leg = segments.at(segment).leg;
+    float course = courses.at(leg);
+    if(!(course < map::INVALID_COURSE_VALUE))
+      continue;
+
+    distance(candidateResult, pos.pos, segment);
+    if(candidateResult.status == atools::geo::INVALID ||
+       std::abs(candidateResult.distance) > bestDistance + CANDIDATE_TOLERANCE_METER)
+      continue;
+
+    float courseDiff = std::abs(atools::geo::angleAbsDiff(pos.course, course));
+
+    // Only legs in aircraft direction qualify - nearest wins if none is found
+    if(courseDiff < 90.f && (courseDiff < bestCourseDiff || (courseDiff <= bestCourseDiff && leg < bestLeg)))
+    {
+      bestCourseDiff = courseDiff;
+      bestLeg = leg;
+      result = candidateResult;
+    }
+  }
+  return bestLeg;
+}
@@ -0,0 +1,123 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LNM_ROUTELEGINDEX_H
+#define LNM_ROUTELEGINDEX_H
+
+#include "common/maptypes.h"
+
+#include <algorithm>
+
+class Route;
+
+/*
+ * Spatial index for the great circle segments of all flight plan legs used to find the active leg.
+ *
+ * Segments are kept in a bounding volume hierarchy of boxes in earth centered cartesian coordinates on the
+ * unit sphere. Boxes are extended by the bulge of the arc over its chord, so distance to a box is a lower bound
+ * for the distance to all contained segments. This avoids special handling of the anti-meridian and poles.
+ *
+ * Leg courses are cached to avoid recalculation on each simulator update.
+ * Leg index i refers to the segment from the position of leg i - 1 to the position of leg i.
+ */
+class RouteLegIndex
+{
+public:
+  /* Build from current leg positions. Call whenever legs are added, removed or moved. */
+  void build(const Route& route);
+  void clear();
+
+  /* Number of legs the index was built for */
+  int size() const
+  {
+    return courses.size();
+  }
+
+  /* Initial true course from previous position to leg position or INVALID_COURSE_VALUE */
+  float getCourse(int legIndex) const
+  {
+    return legIndex >= 0 && legIndex < courses.size() ? courses.at(legIndex) : map::INVALID_COURSE_VALUE;
+  }
+
+  /* Find the leg nearest to the position not further away than maxDistanceMeter.
+   * Legs having a cross track distance close to the nearest one are considered equal.
+   * From these the leg following the aircraft course is preferred if course is valid
+   * which avoids picking opposite legs in holds or procedures going back and forth.
+   * Returns map::INVALID_INDEX_VALUE if nothing was found. */
+  int getNearestLeg(const map::PosCourse& pos, float maxDistanceMeter, atools::geo::LineDistance& result) const;
+
+private:
+  /* Legs having a distance within this tolerance of the nearest are compared by course */
+  const float CANDIDATE_TOLERANCE_METER = 926.f; /* 0.5 NM */
+
+  struct Box
+  {
+    float min[3], max[3];
+
+    void extend(const Box& other)
+    {
+      for(int i = 0; i < 3; i++)
+      {
+        min[i] = std::min(min[i], other.min[i]);
+        max[i] = std::max(max[i], other.max[i]);
+      }
+    }
+
+    /* Chord length on unit sphere from point to box */
+    float distance(const float point[3]) const;
+  };
+
+  /* Leaf if segment is not -1. Children are stored as node indexes otherwise. */
+  struct Node
+  {
+    Box box;
+    int left, right, segment;
+  };
+
+  struct Segment
+  {
+    atools::geo::Pos pos1, pos2;
+    Box box;
+    int leg;
+  };
+
+  /* Split segments at median along the longest axis recursively - returns node index */
+  int buildNode(QVector<Segment>& segmentList, int first, int last);
+
+  /* Convert chord distance to a lower bound in meter on the earth surface */
+  static float chordToMeter(float chord);
+
+  static void toCartesian(const atools::geo::Pos& pos, float point[3]);
+
+  /* Exact distance to segment */
+  void distance(atools::geo::LineDistance& result, const atools::geo::Pos& pos, int segment) const;
+
+  /* Depth first with closer child first and pruning by the best distance found so far */
+  void searchNearest(int node, const atools::geo::Pos& pos, const float point[3], float& bestDistance,
+                     int& bestSegment) const;
+
+  /* Collect segments with a lower bound distance not exceeding maxDistanceMeter */
+  void searchRange(QVector<int>& result, int node, const float point[3], float maxDistanceMeter) const;
+
+  QVector<Node> nodes;
+  QVector<Segment> segments; /* Indexed by leaf */
+  QVector<float> courses; /* Indexed by leg */
+  int root = -1;
+};
+
+#endif // LNM_ROUTELEGINDEX_H
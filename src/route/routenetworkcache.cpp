@@ -0,0 +1,222 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "route/routenetworkcache.h"
+
+#include "navapp.h"
+#include "exception.h"
+#include "routing/routenetwork.h"
+#include "routing/routenetworkloader.h"
+#include "sql/sqldatabase.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QtConcurrent/QtConcurrentRun>
+
+using atools::routing::RouteNetwork;
+using atools::routing::RouteNetworkLoader;
+using atools::sql::SqlDatabase;
+
+/* Connection names used for loading in the background thread */
+static const QLatin1String DATABASE_NAME_NAV_ROUTE("LNMDBNAVROUTE");
+static const QLatin1String DATABASE_NAME_TRACK_ROUTE("LNMDBTRACKROUTE");
+
+RouteNetworkCache::RouteNetworkCache(QObject *parent)
+  : QObject(parent)
+{
+  networkRadio = new RouteNetwork(atools::routing::SOURCE_RADIO);
+  networkAirway = new RouteNetwork(atools::routing::SOURCE_AIRWAY);
+}
+
+RouteNetworkCache::~RouteNetworkCache()
+{
+  future.waitForFinished();
+  delete networkRadio;
+  delete networkAirway;
+}
+
+RouteNetwork *RouteNetworkCache::getNetworkAirway()
+{
+  return getNetwork(networkAirway, loadedKeyAirway, keyAirway());
+}
+
+RouteNetwork *RouteNetworkCache::getNetworkRadio()
+{
+  return getNetwork(networkRadio, loadedKeyRadio, keyRadio());
+}
+
+RouteNetwork *RouteNetworkCache::getNetwork(RouteNetwork *network, QString& loadedKey, const QString& currentKey)
+{
+  future.waitForFinished();
+
+  // Loading might have failed in background or databases have changed
+  if(!network->isLoaded() || loadedKey != currentKey)
+  {
+    qDebug() << Q_FUNC_INFO << "Loading synchronously" << currentKey;
+    network->clear();
+    RouteNetworkLoader loader(NavApp::getDatabaseNav(), NavApp::getDatabaseTrack());
+    loader.load(network);
+    loadedKey = currentKey;
+  }
+  return network;
+}
+
+void RouteNetworkCache::preload()
+{
+  if(future.isRunning())
+    return;
+
+  clearOutdated();
+
+  QVector<RouteNetwork *> networks;
+  if(!networkRadio->isLoaded())
+  {
+    networks.append(networkRadio);
+    loadedKeyRadio = keyRadio();
+  }
+
+  if(!networkAirway->isLoaded())
+  {
+    networks.append(networkAirway);
+    loadedKeyAirway = keyAirway();
+  }
+
+  const SqlDatabase *dbNav = NavApp::getDatabaseNav(), *dbTrack = NavApp::getDatabaseTrack();
+  if(!networks.isEmpty() && dbNav != nullptr && dbNav->isOpen())
+  {
+    QString trackFile = dbTrack != nullptr && dbTrack->isOpen() ? dbTrack->databaseName() : QString();
+
+    qDebug() << Q_FUNC_INFO << "Loading" << networks.size() << "networks from" << dbNav->databaseName() << trackFile;
+    future = QtConcurrent::run(this, &RouteNetworkCache::loadThread, networks, dbNav->databaseName(), trackFile);
+  }
+}
+
+void RouteNetworkCache::tracksChanged()
+{
+  future.waitForFinished();
+
+  if(loadedKeyAirway != keyAirway())
+  {
+    qDebug() << Q_FUNC_INFO << "Tracks changed";
+    networkAirway->clear();
+    loadedKeyAirway.clear();
+    preload();
+  }
+}
+
+void RouteNetworkCache::preDatabaseLoad()
+{
+  future.waitForFinished();
+}
+
+void RouteNetworkCache::postDatabaseLoad()
+{
+  future.waitForFinished();
+  preload();
+}
+
+void RouteNetworkCache::clearOutdated()
+{
+  if(loadedKeyRadio != keyRadio())
+  {
+    networkRadio->clear();
+    loadedKeyRadio.clear();
+  }
+
+  if(loadedKeyAirway != keyAirway())
+  {
+    networkAirway->clear();
+    loadedKeyAirway.clear();
+  }
+}
+
+void RouteNetworkCache::loadThread(QVector<RouteNetwork *> networks, QString navFile, QString trackFile)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  try
+  {
+    SqlDatabase::addDatabase("QSQLITE", DATABASE_NAME_NAV_ROUTE);
+    SqlDatabase::addDatabase("QSQLITE", DATABASE_NAME_TRACK_ROUTE);
+
+    {
+      // Separate connections for this thread - track database can be updated in the main thread while loading
+      SqlDatabase dbNav(DATABASE_NAME_NAV_ROUTE), dbTrack(DATABASE_NAME_TRACK_ROUTE);
+      dbNav.setDatabaseName(navFile);
+      dbNav.setReadonly();
+      dbNav.open({"PRAGMA busy_timeout=2000"});
+
+      if(!trackFile.isEmpty())
+      {
+        dbTrack.setDatabaseName(trackFile);
+        dbTrack.setReadonly();
+        dbTrack.open({"PRAGMA busy_timeout=2000"});
+      }
+
+      RouteNetworkLoader loader(&dbNav, trackFile.isEmpty() ? nullptr : &dbTrack);
+      for(RouteNetwork *network : networks)
+        loader.load(network);
+
+      dbNav.close();
+      if(dbTrack.isOpen())
+        dbTrack.close();
+    }
+  }
+  catch(atools::Exception& e)
+  {
+    // Networks will be loaded on demand in main thread
+    qWarning() << Q_FUNC_INFO << "Loading failed" << e.what();
+    for(RouteNetwork *network : networks)
+      network->clear();
+  }
+  catch(...)
+  {
+    qWarning() << Q_FUNC_INFO << "Loading failed";
+    for(RouteNetwork *network : networks)
+      network->clear();
+  }
+
+  SqlDatabase::removeDatabase(DATABASE_NAME_NAV_ROUTE);
+  SqlDatabase::removeDatabase(DATABASE_NAME_TRACK_ROUTE);
+
+  qDebug() << Q_FUNC_INFO << "Loaded" << networks.size() << "networks in" << timer.elapsed() << "ms";
+}
+
+QString RouteNetworkCache::databaseKey(const SqlDatabase *db)
+{
+  if(db != nullptr && db->isOpen())
+  {
+    QFileInfo fileinfo(db->databaseName());
+    return fileinfo.canonicalFilePath() + "|" + QString::number(fileinfo.size()) + "|" +
+           QString::number(fileinfo.lastModified().toMSecsSinceEpoch());
+  }
+  else
+    return QString();
+}
+
+QString RouteNetworkCache::keyAirway() const
+{
+  // Airway network includes tracks
+  return databaseKey(NavApp::getDatabaseNav()) + "|" + databaseKey(NavApp::getDatabaseTrack());
+}
+
+QString RouteNetworkCache::keyRadio() const
+{
+  return databaseKey(NavApp::getDatabaseNav());
+}
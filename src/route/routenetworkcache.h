@@ -0,0 +1,101 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_ROUTENETWORKCACHE_H
+#define LNM_ROUTENETWORKCACHE_H
+
+#include <QFuture>
+#include <QObject>
+
+namespace atools {
+namespace routing {
+class RouteNetwork;
+}
+namespace sql {
+class SqlDatabase;
+}
+}
+
+/*
+ * Keeps the airway and radionav route networks for flight plan calculation loaded across
+ * database and track changes.
+ *
+ * Each network remembers the identity of the databases it was loaded from. Nav database identity is
+ * file, size and modification time. The airway network additionally depends on the track database.
+ * A network is only dropped if the identity of its source databases changed. The radionav network
+ * is therefore kept when only tracks are reloaded.
+ *
+ * Networks are loaded in a background thread using separate read only database connections since
+ * the application connections are bound to the main thread.
+ */
+class RouteNetworkCache :
+  public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit RouteNetworkCache(QObject *parent);
+  virtual ~RouteNetworkCache() override;
+
+  /* Get networks which are up to date with the current databases. Waits for background loading
+   * and loads synchronously in the calling main thread if needed. */
+  atools::routing::RouteNetwork *getNetworkAirway();
+  atools::routing::RouteNetwork *getNetworkRadio();
+
+  /* Load all outdated or not loaded networks in background. Does nothing if loading is already running. */
+  void preload();
+
+  /* Tracks were reloaded. Reloads the airway network in background if the track database has changed. */
+  void tracksChanged();
+
+  /* Wait for background loading to finish before databases are closed */
+  void preDatabaseLoad();
+
+  /* Drop outdated networks and reload them in background */
+  void postDatabaseLoad();
+
+  /* true if background loading is running */
+  bool isLoading() const
+  {
+    return future.isRunning();
+  }
+
+private:
+  /* Waits for loading and returns network after reloading it if needed */
+  atools::routing::RouteNetwork *getNetwork(atools::routing::RouteNetwork *network, QString& loadedKey,
+                                            const QString& currentKey);
+
+  /* Clear networks which do not match the current database identity */
+  void clearOutdated();
+
+  /* Called in background thread */
+  void loadThread(QVector<atools::routing::RouteNetwork *> networks, QString navFile, QString trackFile);
+
+  /* Identity of the database file or empty if not open */
+  static QString databaseKey(const atools::sql::SqlDatabase *db);
+  QString keyAirway() const;
+  QString keyRadio() const;
+
+  atools::routing::RouteNetwork *networkRadio = nullptr, *networkAirway = nullptr;
+
+  /* Database identity the networks were loaded from. Empty if not loaded. */
+  QString loadedKeyRadio, loadedKeyAirway;
+
+  QFuture<void> future;
+};
+
+#endif // LNM_ROUTENETWORKCACHE_H
@@ -266,6 +266,16 @@ void OnlineClientSearch::postDatabaseLoad()
   setCallbacks();
 }
 
+void OnlineClientSearch::onlineClientsUpdated(bool loadAll, bool keepSelection)
+{
+  if(loadAll || !keepSelection)
+    // Network changed or similar - reload all
+    refreshData(loadAll, keepSelection);
+  else
+    // Rows might be inserted or removed - keep selection by callsign and load only needed rows
+    refreshDataKeepSelection("callsign");
+}
+
 /* Sets controller data formatting callback and desired data roles */
 void OnlineClientSearch::setCallbacks()
 {
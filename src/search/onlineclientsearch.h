@@ -53,6 +53,9 @@ public:
   virtual void connectSearchSlots() override;
   virtual void postDatabaseLoad() override;
 
+  /* Reload all rows if loadAll is set. Otherwise reload only needed rows and keep selection by callsign */
+  void onlineClientsUpdated(bool loadAll, bool keepSelection);
+
 private:
   virtual void updateButtonMenu() override;
   virtual void saveViewState(bool distSearchActive) override;
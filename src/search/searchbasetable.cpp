@@ -669,6 +669,13 @@ void SearchBaseTable::refreshData(bool loadAll, bool keepSelection)
   tableSelectionChangedInternal(true /* do not follow selection */);
 }
 
+void SearchBaseTable::refreshDataKeepSelection(const QString& keyColumn)
+{
+  controller->refreshDataKeepSelection(keyColumn);
+
+  tableSelectionChangedInternal(true /* do not follow selection */);
+}
+
 void SearchBaseTable::refreshView()
 {
   controller->refreshView();
@@ -116,6 +116,9 @@ public:
   void refreshData(bool loadAll, bool keepSelection);
   void refreshView();
 
+  /* Refresh table and keep selection by values in the key column */
+  void refreshDataKeepSelection(const QString& keyColumn);
+
   /* Number of rows currently loaded into the table view */
   int getVisibleRowCount() const;
 
@@ -122,6 +122,51 @@ void SqlController::refreshData(bool loadAll, bool keepSelection)
   }
 }
 
+void SqlController::refreshDataKeepSelection(const QString& keyColumn)
+{
+  QItemSelectionModel *sm = view->selectionModel();
+
+  // Remember key values for all selected rows
+  QSet<QString> keys;
+  if(sm != nullptr)
+  {
+    for(const QModelIndex& index : sm->selectedRows(0))
+      keys.insert(getRawData(index.row(), keyColumn).toString());
+  }
+
+  // Reload query model
+  model->refreshData();
+
+  // Selection changes when updating model
+  sm = view->selectionModel();
+
+  if(sm != nullptr && !keys.isEmpty())
+  {
+    // Find rows for the remembered key values which can be at different positions now
+    sm->blockSignals(true);
+    int found = 0;
+    for(int row = 0; found < keys.size(); row++)
+    {
+      if(row >= getVisibleRowCount())
+      {
+        // Load more rows if possible
+        if(model->canFetchMore())
+          model->fetchMore(QModelIndex());
+
+        if(row >= getVisibleRowCount())
+          break;
+      }
+
+      if(keys.contains(getRawData(row, keyColumn).toString()))
+      {
+        sm->select(view->model()->index(row, 0), QItemSelectionModel::Select | QItemSelectionModel::Rows);
+        found++;
+      }
+    }
+    sm->blockSignals(false);
+  }
+}
+
 void SqlController::refreshView()
 {
   view->update();
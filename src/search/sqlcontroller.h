@@ -176,6 +176,10 @@ public:
   /* Update query on changes in the database. Loads all data needed to restore selection if keepSelection is true */
   void refreshData(bool loadAll, bool keepSelection);
 
+  /* Update query on changes in the database but restore selection by the values in the given column instead of
+   * row numbers. Used if rows were inserted or removed. Loads rows only until all selected values are found. */
+  void refreshDataKeepSelection(const QString& keyColumn);
+
   /* Update view only */
   void refreshView();
 
@@ -67,6 +67,7 @@ WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::
   mainWindow(parentWindow)
 {
   using namespace std::placeholders;
+  metarCache.setMaxCost(Settings::instance().getAndStoreValue(lnm::OPTIONS_WEATHER_METAR_CACHE_SIZE, 20000).toInt());
   onlineWeatherTimeoutSecs = atools::settings::Settings::instance().valueInt(lnm::OPTIONS_WEATHER_UPDATE, 600);
 
   verbose = Settings::instance().getAndStoreValue(lnm::OPTIONS_WEATHER_DEBUG, false).toBool();
@@ -107,6 +108,9 @@ WeatherReporter::WeatherReporter(MainWindow *parentWindow, atools::fs::FsPaths::
   connect(vatsimWeather, &WeatherNetSingle::weatherUpdated, this, &WeatherReporter::weatherUpdated);
   connect(ivaoWeather, &WeatherNetDownload::weatherUpdated, this, &WeatherReporter::weatherUpdated);
 
+  // Parsed metars are outdated - connect first to clear before other receivers get the signal
+  connect(this, &WeatherReporter::weatherUpdated, this, &WeatherReporter::clearMetarCache);
+
   // Forward signals from clients for errors
   connect(noaaWeather, &NoaaWeatherDownloader::weatherDownloadFailed, this, &WeatherReporter::weatherDownloadFailed);
   connect(vatsimWeather, &WeatherNetSingle::weatherDownloadFailed, this, &WeatherReporter::weatherDownloadFailed);
@@ -591,38 +595,79 @@ atools::fs::weather::MetarResult WeatherReporter::getIvaoMetar(const QString& ai
   return ivaoWeather->getMetar(airportIcao, pos);
 }
 
+uint qHash(const WeatherReporter::MetarCacheKey& key)
+{
+  return qHash(key.metar) ^ qHash(key.station) ^ qHash(key.timestamp) ^
+         static_cast<uint>(key.source << 1 | key.simFormat);
+}
+
+bool WeatherReporter::MetarCacheKey::operator==(const WeatherReporter::MetarCacheKey& other) const
+{
+  return source == other.source && simFormat == other.simFormat && station == other.station &&
+         timestamp == other.timestamp && metar == other.metar;
+}
+
+atools::fs::weather::Metar WeatherReporter::getParsedMetar(map::MapWeatherSource source, const QString& metar,
+                                                           const QString& station, const QDateTime& timestamp,
+                                                           bool simFormat)
+{
+  if(metar.isEmpty())
+    return Metar();
+
+  MetarCacheKey key = {source, station, metar, timestamp, simFormat};
+
+  QMutexLocker locker(&metarCacheMutex);
+  Metar *cached = metarCache.object(key);
+  if(cached != nullptr)
+    return *cached;
+
+  // Not found - parse and cache
+  Metar *parsed = new Metar(metar, station, timestamp, simFormat);
+  metarCache.insert(key, parsed);
+  return *parsed;
+}
+
+void WeatherReporter::clearMetarCache()
+{
+  QMutexLocker locker(&metarCacheMutex);
+  metarCache.clear();
+}
+
 atools::fs::weather::Metar WeatherReporter::getAirportWeather(const QString& airportIcao,
                                                               const atools::geo::Pos& airportPos,
-                                                              map::MapWeatherSource source)
+                                                              map::MapWeatherSource source,
+                                                              bool requestSimulator)
 {
   switch(source)
   {
     case map::WEATHER_SOURCE_SIMULATOR:
       if(NavApp::getCurrentSimulatorDb() == atools::fs::FsPaths::XPLANE11)
         // X-Plane weather file
-        return Metar(getXplaneMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+        return getParsedMetar(source, getXplaneMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
       else if(NavApp::getConnectClient()->isConnected() /*&& !NavApp::getConnectClient()->isConnectedNetwork()*/)
       {
-        atools::fs::weather::MetarResult res =
-          NavApp::getConnectClient()->requestWeather(airportIcao, airportPos, true);
+        ConnectClient *client = NavApp::getConnectClient();
+        atools::fs::weather::MetarResult res = requestSimulator ?
+                                               client->requestWeather(airportIcao, airportPos, true) :
+                                               client->getCachedWeather(airportIcao);
 
         if(res.isValid() && !res.metarForStation.isEmpty())
           // FSX/P3D - Flight simulator fetched weather or network connection
-          return Metar(res.metarForStation, res.requestIdent, res.timestamp, true);
+          return getParsedMetar(source, res.metarForStation, res.requestIdent, res.timestamp, true);
       }
       return Metar();
 
     case map::WEATHER_SOURCE_ACTIVE_SKY:
-      return Metar(getActiveSkyMetar(airportIcao));
+      return getParsedMetar(source, getActiveSkyMetar(airportIcao));
 
     case map::WEATHER_SOURCE_NOAA:
-      return Metar(getNoaaMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+      return getParsedMetar(source, getNoaaMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
 
     case map::WEATHER_SOURCE_VATSIM:
-      return Metar(getVatsimMetar(airportIcao));
+      return getParsedMetar(source, getVatsimMetar(airportIcao));
 
     case map::WEATHER_SOURCE_IVAO:
-      return Metar(getIvaoMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
+      return getParsedMetar(source, getIvaoMetar(airportIcao, atools::geo::EMPTY_POS).metarForStation);
   }
   return Metar();
 }
@@ -21,7 +21,10 @@
 #include "fs/fspaths.h"
 #include "common/mapflags.h"
 
+#include <QCache>
+#include <QDateTime>
 #include <QHash>
+#include <QMutex>
 #include <QObject>
 
 namespace atools {
@@ -97,9 +100,19 @@ public:
    */
   atools::fs::weather::MetarResult getIvaoMetar(const QString& airportIcao, const atools::geo::Pos& pos);
 
-  /* For display. Source depends on settings and parsed objects are cached. */
+  /* For display. Source depends on settings and parsed objects are cached.
+   * requestSimulator: Start a request for simulator weather if not cached. Otherwise use the cache only. */
   atools::fs::weather::Metar getAirportWeather(const QString& airportIcao, const atools::geo::Pos& airportPos,
-                                               map::MapWeatherSource source);
+                                               map::MapWeatherSource source, bool requestSimulator = true);
+
+  /* Get parsed metar from cache or parse and add it to the cache. Key is source, station and raw report.
+   * Cache is cleared when weatherUpdated is emitted. Returns an invalid metar if report is empty. Thread safe. */
+  atools::fs::weather::Metar getParsedMetar(map::MapWeatherSource source, const QString& metar,
+                                            const QString& station = QString(),
+                                            const QDateTime& timestamp = QDateTime(), bool simFormat = false);
+
+  /* Remove all parsed metars */
+  void clearMetarCache();
 
   /* Does nothing currently */
   void preDatabaseLoad();
@@ -164,6 +177,19 @@ signals:
   void weatherUpdated();
 
 private:
+  /* Key for parsed metars. Uses the full report to avoid collisions. */
+  struct MetarCacheKey
+  {
+    bool operator==(const WeatherReporter::MetarCacheKey& other) const;
+
+    map::MapWeatherSource source;
+    QString station, metar;
+    QDateTime timestamp;
+    bool simFormat;
+  };
+
+  friend uint qHash(const WeatherReporter::MetarCacheKey& key);
+
   void weatherDownloadFailed(const QString& error, int errorCode, QString url);
 
   void activeSkyWeatherFileChanged(const QString& path);
@@ -210,6 +236,10 @@ private:
 
   bool errorReported = false;
 
+  /* Parsed metars for map display, tooltips and information window */
+  QCache<MetarCacheKey, atools::fs::weather::Metar> metarCache;
+  QMutex metarCacheMutex;
+
   bool verbose = false;
 };
 
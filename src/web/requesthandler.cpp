@@ -45,7 +45,8 @@ using namespace stefanfrings;
 
 RequestHandler::RequestHandler(QObject *parent, WebMapController *webMapController,
                                HtmlInfoBuilder *htmlInfoBuilderParam, bool verboseParam)
-  : HttpRequestHandler(parent), htmlInfoBuilder(htmlInfoBuilderParam), verbose(verboseParam)
+  : HttpRequestHandler(parent), htmlInfoBuilder(htmlInfoBuilderParam), mapController(webMapController),
+  verbose(verboseParam)
 {
   qDebug() << Q_FUNC_INFO;
 
@@ -64,14 +65,7 @@ RequestHandler::RequestHandler(QObject *parent, WebMapController *webMapControll
   connect(this, &RequestHandler::getCurrentMapWidgetPos,
           NavApp::getMapPaintWidget(), &MapPaintWidget::getCurrentViewCenterPos, Qt::BlockingQueuedConnection);
 
-  connect(this, &RequestHandler::getPixmap, webMapController, &WebMapController::getPixmap,
-          Qt::BlockingQueuedConnection);
-  connect(this, &RequestHandler::getPixmapObject, webMapController, &WebMapController::getPixmapObject,
-          Qt::BlockingQueuedConnection);
-  connect(this, &RequestHandler::getPixmapPosDistance, webMapController, &WebMapController::getPixmapPosDistance,
-          Qt::BlockingQueuedConnection);
-  connect(this, &RequestHandler::getPixmapRect, webMapController, &WebMapController::getPixmapRect,
-          Qt::BlockingQueuedConnection);
+  // Map images are rendered in the main thread by the render pool in WebMapController - see getPixmapQueued()
 }
 
 RequestHandler::~RequestHandler()
@@ -99,6 +93,10 @@ void RequestHandler::service(HttpRequest& request, HttpResponse& response)
     // ===========================================================================
     // Requests for map images only - either with or without session
     handleMapImage(request, response);
+  else if(path == "/maptile")
+    // ===========================================================================
+    // Slippy map tiles for web map libraries - no session needed
+    handleMapTile(request, response);
   else
   {
     HttpSession session = getSession(request, response);
@@ -324,14 +322,14 @@ void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& response
 
       if(mapcmd == "user")
         // Show user aircraft
-        mapPixmap = emit getPixmapObject(width, height, web::USER_AIRCRAFT, QString(), requestedDistanceKm);
+        mapPixmap = getPixmapObject(request, width, height, web::USER_AIRCRAFT, QString(), requestedDistanceKm);
       else if(mapcmd == "route")
         // Center flight plan
-        mapPixmap = emit getPixmapObject(width, height, web::ROUTE, QString(), requestedDistanceKm);
+        mapPixmap = getPixmapObject(request, width, height, web::ROUTE, QString(), requestedDistanceKm);
       else if(mapcmd == "airport")
         // Show an airport by ident
-        mapPixmap = emit getPixmapObject(width, height, web::AIRPORT, params.asStr(
-                                           "airport").toUpper(), requestedDistanceKm);
+        mapPixmap = getPixmapObject(request, width, height, web::AIRPORT, params.asStr("airport").toUpper(),
+                                    requestedDistanceKm);
       else
       {
         // When zooming in or out use the last corrected distance (i.e. actual distance) as a base
@@ -339,10 +337,14 @@ void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& response
                          session.get("corrected_distance").toFloat() : session.get("requested_distance").toFloat();
 
         // Zoom or move map
-        mapPixmap = emit getPixmapPosDistance(width, height,
-                                              atools::geo::Pos(session.get("lon").toFloat(),
-                                                               session.get("lat").toFloat()),
-                                              distance, mapcmd);
+        MapPixmapRequest pixmapRequest;
+        pixmapRequest.type = MapPixmapRequest::POS_DISTANCE;
+        pixmapRequest.width = width;
+        pixmapRequest.height = height;
+        pixmapRequest.pos = atools::geo::Pos(session.get("lon").toFloat(), session.get("lat").toFloat());
+        pixmapRequest.distanceKm = distance;
+        pixmapRequest.mapCommand = mapcmd;
+        mapPixmap = getPixmapQueued(request, pixmapRequest);
       }
 
       if(!mapPixmap.hasError())
@@ -361,35 +363,49 @@ void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& response
   // Session-less / state-less calls ============================================
   else if(params.has("user"))
     // User aircraft =======================
-    mapPixmap = emit getPixmapObject(width, height, web::USER_AIRCRAFT, QString(), requestedDistanceKm);
+    mapPixmap = getPixmapObject(request, width, height, web::USER_AIRCRAFT, QString(), requestedDistanceKm);
   else if(params.has("route"))
     // Center flight plan =======================
-    mapPixmap = emit getPixmapObject(width, height, web::ROUTE, QString(), requestedDistanceKm);
+    mapPixmap = getPixmapObject(request, width, height, web::ROUTE, QString(), requestedDistanceKm);
   else if(params.has("airport"))
     // Show airport =======================
-    mapPixmap = emit getPixmapObject(width, height, web::AIRPORT, params.asStr("airport"), requestedDistanceKm);
+    mapPixmap = getPixmapObject(request, width, height, web::AIRPORT, params.asStr("airport"), requestedDistanceKm);
   else if(params.has("leftlon") && params.has("toplat") && params.has("rightlon") && params.has("bottomlat"))
   {
     // Show rectangle =======================
-    atools::geo::Rect rect(params.asFloat("leftlon"), params.asFloat("toplat"),
-                           params.asFloat("rightlon"), params.asFloat("bottomlat"));
-    mapPixmap = emit getPixmapRect(width, height, rect);
+    MapPixmapRequest pixmapRequest;
+    pixmapRequest.type = MapPixmapRequest::RECT;
+    pixmapRequest.width = width;
+    pixmapRequest.height = height;
+    pixmapRequest.rect = atools::geo::Rect(params.asFloat("leftlon"), params.asFloat("toplat"),
+                                           params.asFloat("rightlon"), params.asFloat("bottomlat"));
+    mapPixmap = getPixmapQueued(request, pixmapRequest);
   }
   else if(params.has("distance") || (params.has("lon") && params.has("lat")))
   {
     // Show position =======================
-    atools::geo::Pos pos;
+    MapPixmapRequest pixmapRequest;
+    pixmapRequest.type = MapPixmapRequest::POS_DISTANCE;
+    pixmapRequest.width = width;
+    pixmapRequest.height = height;
     if(params.has("lon") && params.has("lat"))
     {
-      pos.setLonX(params.asFloat("lon"));
-      pos.setLatY(params.asFloat("lat"));
+      pixmapRequest.pos.setLonX(params.asFloat("lon"));
+      pixmapRequest.pos.setLatY(params.asFloat("lat"));
     }
+    pixmapRequest.distanceKm = requestedDistanceKm;
 
-    mapPixmap = emit getPixmapPosDistance(width, height, pos, requestedDistanceKm, QString());
+    mapPixmap = getPixmapQueued(request, pixmapRequest);
   }
   else
+  {
     // Show current map view =======================
-    mapPixmap = emit getPixmap(width, height);
+    MapPixmapRequest pixmapRequest;
+    pixmapRequest.type = MapPixmapRequest::CURRENT;
+    pixmapRequest.width = width;
+    pixmapRequest.height = height;
+    mapPixmap = getPixmapQueued(request, pixmapRequest);
+  }
 
   if(mapPixmap.isValid() && !mapPixmap.hasError())
   {
@@ -420,6 +436,43 @@ void RequestHandler::handleMapImage(HttpRequest& request, HttpResponse& response
     showErrorPixmap(response, width, height, 404, mapPixmap.error);
 }
 
+void RequestHandler::handleMapTile(HttpRequest& request, HttpResponse& response)
+{
+  Parameter params(request);
+
+  QByteArray bytes;
+  QString error;
+  if(params.has("z") && params.has("x") && params.has("y") &&
+     mapController->getTileQueued(request.getPeerAddress().toString(),
+                                  params.asInt("z"), params.asInt("x"), params.asInt("y"), bytes, error))
+  {
+    // Tiles do not change until map settings or database change - let the browser cache them for a while
+    response.setHeader("Content-Type", "image/png");
+    response.setHeader("Cache-Control", "max-age=60");
+    response.write(bytes);
+  }
+  else
+    showErrorPixmap(response, 256, 256, 404, error.isEmpty() ? tr("Tile not found") : error);
+}
+
+MapPixmap RequestHandler::getPixmapQueued(HttpRequest& request, const MapPixmapRequest& pixmapRequest)
+{
+  return mapController->getPixmapQueued(request.getPeerAddress().toString(), pixmapRequest);
+}
+
+MapPixmap RequestHandler::getPixmapObject(HttpRequest& request, int width, int height, web::ObjectType type,
+                                          const QString& ident, float distanceKm)
+{
+  MapPixmapRequest pixmapRequest;
+  pixmapRequest.type = MapPixmapRequest::OBJECT;
+  pixmapRequest.width = width;
+  pixmapRequest.height = height;
+  pixmapRequest.objectType = type;
+  pixmapRequest.ident = ident;
+  pixmapRequest.distanceKm = distanceKm;
+  return getPixmapQueued(request, pixmapRequest);
+}
+
 void RequestHandler::showErrorPixmap(HttpResponse& response, int width, int height, int status, const QString& text)
 {
   qWarning() << Q_FUNC_INFO << "Error" << status << text;
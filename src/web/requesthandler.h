@@ -61,12 +61,8 @@ public:
 signals:
   /* Calls to the MapPaintWidget have to run in the main event queue and thread.
    * Therefore, it is necessary to use queued signals to separate
-   * a thread from the HTTP server.*/
-  MapPixmap getPixmap(int width, int height);
-  MapPixmap getPixmapObject(int width, int height, web::ObjectType type, QString ident, float distanceKm);
-  MapPixmap getPixmapPosDistance(int width, int height, atools::geo::Pos pos, float distanceKm, QString mapCommand);
-  MapPixmap getPixmapRect(int width, int height, atools::geo::Rect rect);
-
+   * a thread from the HTTP server.
+   * Map images are requested through the queue in WebMapController. */
   atools::fs::sc::SimConnectUserAircraft getUserAircraft();
   Route getRoute();
   QString getFlightplanTableAsHtml(int iconSize, bool print);
@@ -87,6 +83,14 @@ private:
   /* Handle stateful and stateless map image requests. */
   void handleMapImage(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
 
+  /* Handle slippy map tile requests "/maptile?z=...&x=...&y=...". */
+  void handleMapTile(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
+
+  /* Queue map image request in the render pool using the peer address as client id for fair scheduling */
+  MapPixmap getPixmapQueued(stefanfrings::HttpRequest& request, const MapPixmapRequest& pixmapRequest);
+  MapPixmap getPixmapObject(stefanfrings::HttpRequest& request, int width, int height, web::ObjectType type,
+                            const QString& ident, float distanceKm);
+
   /* Build the select dropdown box HTML code with the default value pre-selected. */
   QString buildRefreshSelect(int defaultValue);
 
@@ -94,6 +98,7 @@ private:
   stefanfrings::HttpSession getSession(stefanfrings::HttpRequest& request, stefanfrings::HttpResponse& response);
 
   HtmlInfoBuilder *htmlInfoBuilder;
+  WebMapController *mapController;
 
   bool verbose = false;
 };
@@ -63,7 +63,11 @@ WebController::WebController(QWidget *parent) :
   sslKeyFile = listenerSettings.value("sslKeyFile").toString();
   sslCertFile = listenerSettings.value("sslCertFile").toString();
 
-  mapController = new WebMapController(parentWidget, verbose);
+  // Number of offscreen map widgets used to render map images for clients
+  int renderPoolSize = atools::settings::Settings::instance().getAndStoreValue(
+    lnm::OPTIONS_WEBSERVER_RENDER_POOL_SIZE, 2).toInt();
+
+  mapController = new WebMapController(parentWidget, verbose, renderPoolSize);
   htmlInfoBuilder = new HtmlInfoBuilder(parent, true /*info*/, true /*print*/);
   updateSettings();
 }
@@ -252,6 +256,16 @@ void WebController::optionsChanged()
     restartServer(true);
 }
 
+void WebController::mapSettingsChanged()
+{
+  mapController->clearTileCache();
+}
+
+void WebController::mapDynamicDataChanged()
+{
+  mapController->dynamicDataChanged();
+}
+
 bool WebController::updateSettings()
 {
   bool changed = false;
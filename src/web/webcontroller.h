@@ -73,6 +73,12 @@ public:
   /* Update settings and probably restart server. */
   void optionsChanged();
 
+  /* Map display settings, theme or database have changed. Drops cached web map tiles. */
+  void mapSettingsChanged();
+
+  /* Online centers or userpoints have changed. Cached web map tiles are not used anymore but kept. */
+  void mapDynamicDataChanged();
+
   /* Update settings from option data but do not restart. Returns true if any changes. */
   bool updateSettings();
 
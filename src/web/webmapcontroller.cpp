@@ -17,25 +17,48 @@
 
 #include "web/webmapcontroller.h"
 
-#include <navapp.h>
-
 #include "mapgui/mappaintwidget.h"
 #include "mapgui/mapwidget.h"
+#include "web/webtilecache.h"
 #include "navapp.h"
+#include "common/constants.h"
+#include "settings/settings.h"
+#include "geo/calculations.h"
 
+#include <QBuffer>
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
 #include <QPixmap>
+#include <QThread>
+
+#include <cmath>
+
+/* Print statistics to log after this number of requests */
+static const quint64 STATS_LOG_INTERVAL = 100;
 
-WebMapController::WebMapController(QWidget *parent, bool verboseParam)
-  : QObject(parent), parentWidget(parent), verbose(verboseParam)
+/* Slippy map tile size in pixel and maximum zoom level */
+static const int TILE_SIZE = 256;
+static const int TILE_MAX_ZOOM = 18;
+
+WebMapController::WebMapController(QWidget *parent, bool verboseParam, int poolSizeParam)
+  : QObject(parent), parentWidget(parent), verbose(verboseParam), poolSize(std::max(poolSizeParam, 1))
 {
-  qDebug() << Q_FUNC_INFO;
+  qDebug() << Q_FUNC_INFO << "pool size" << poolSize;
+
+  atools::settings::Settings& settings = atools::settings::Settings::instance();
+  qint64 memoryMb = settings.getAndStoreValue(lnm::OPTIONS_WEBSERVER_TILE_CACHE_MEMORY_MB, 64).toLongLong();
+  qint64 diskMb = settings.getAndStoreValue(lnm::OPTIONS_WEBSERVER_TILE_CACHE_DISK_MB, 512).toLongLong();
+
+  tileCache = new WebTileCache(atools::settings::Settings::getPath() + QDir::separator() + "webtiles",
+                               memoryMb * 1024 * 1024, diskMb * 1024 * 1024);
 }
 
 WebMapController::~WebMapController()
 {
   qDebug() << Q_FUNC_INFO;
   deInit();
+  delete tileCache;
 }
 
 void WebMapController::init()
@@ -44,32 +67,284 @@ void WebMapController::init()
 
   deInit();
 
-  // Create a map widget clone with the desired resolution
-  mapPaintWidget = new MapPaintWidget(parentWidget, false /* no real widget - hidden */);
+  for(int i = 0; i < poolSize; i++)
+  {
+    // Create a map widget clone with the desired resolution
+    MapPaintWidget *mapPaintWidget = new MapPaintWidget(parentWidget, false /* no real widget - hidden */);
 
-  // Activate painting
-  mapPaintWidget->setActive();
+    // Activate painting
+    mapPaintWidget->setActive();
+    mapPaintWidgets.append(mapPaintWidget);
+  }
 }
 
 void WebMapController::deInit()
 {
-  qDebug() << Q_FUNC_INFO;
+  qDebug() << Q_FUNC_INFO << getStats();
+
+  {
+    // Release all waiting server threads
+    QMutexLocker locker(&mutex);
+    for(QQueue<Job *>& queue : clientQueues)
+    {
+      for(Job *job : queue)
+      {
+        job->result.error = tr("Server shutting down");
+        job->done = true;
+      }
+    }
+    clientQueues.clear();
+    clientOrder.clear();
+    stats.queueDepth = 0;
+    jobDone.wakeAll();
+  }
 
-  delete mapPaintWidget;
-  mapPaintWidget = nullptr;
+  qDeleteAll(mapPaintWidgets);
+  mapPaintWidgets.clear();
+  clientWidgets.clear();
+  preparedStates.clear();
+}
+
+MapPixmap WebMapController::getPixmapQueued(const QString& clientId, const MapPixmapRequest& request)
+{
+  if(QThread::currentThread() == thread())
+  {
+    // Called from main thread - render directly since waiting would block the queue
+    if(mapPaintWidgets.isEmpty())
+      return MapPixmap();
+
+    return getPixmapRequest(widgetForClient(clientId), request);
+  }
+
+  Job job;
+  job.clientId = clientId;
+  job.request = request;
+  job.timer.start();
+
+  {
+    QMutexLocker locker(&mutex);
+    QQueue<Job *>& queue = clientQueues[clientId];
+    queue.enqueue(&job);
+    if(queue.size() == 1)
+      clientOrder.append(clientId);
+
+    stats.queueDepth++;
+    stats.maxQueueDepth = std::max(stats.maxQueueDepth, stats.queueDepth);
+  }
+
+  // Process one job in the main thread event queue - not necessarily this one
+  QMetaObject::invokeMethod(this, "processQueue", Qt::QueuedConnection);
+
+  QMutexLocker locker(&mutex);
+  while(!job.done)
+    jobDone.wait(&mutex);
+
+  return job.result;
+}
+
+MapPixmapStats WebMapController::getStats() const
+{
+  QMutexLocker locker(&mutex);
+  return stats;
 }
 
-MapPixmap WebMapController::getPixmap(int width, int height)
+bool WebMapController::getTileQueued(const QString& clientId, int z, int x, int y, QByteArray& png, QString& error)
+{
+  if(z < 0 || z > TILE_MAX_ZOOM || x < 0 || y < 0 || x >= (1 << z) || y >= (1 << z))
+  {
+    error = tr("Invalid tile %1/%2/%3").arg(z).arg(x).arg(y);
+    return false;
+  }
+
+  // Remember generation before rendering to avoid caching a tile which was rendered with outdated settings
+  int generation = tileGeneration.loadAcquire(), dynamicGeneration = tileDynamicGeneration.loadAcquire();
+  QString key = QString("%1-%2/%3/%4/%5").arg(generation).arg(dynamicGeneration).arg(z).arg(x).arg(y);
+
+  if(tileCache->getTile(key, png))
+    return true;
+
+  MapPixmapRequest request;
+  request.type = MapPixmapRequest::TILE;
+  request.tileZ = z;
+  request.tileX = x;
+  request.tileY = y;
+  MapPixmap mapPixmap = getPixmapQueued(clientId, request);
+
+  if(!mapPixmap.isValid() || mapPixmap.hasError())
+  {
+    error = mapPixmap.error;
+    return false;
+  }
+
+  QBuffer buffer(&png);
+  buffer.open(QIODevice::WriteOnly);
+  mapPixmap.pixmap.save(&buffer, "PNG");
+
+  if(generation == tileGeneration.loadAcquire() && dynamicGeneration == tileDynamicGeneration.loadAcquire())
+    tileCache->insertTile(key, png);
+  return true;
+}
+
+void WebMapController::clearTileCache()
+{
+  tileGeneration.fetchAndAddOrdered(1);
+  tileCache->clear();
+}
+
+void WebMapController::dynamicDataChanged()
+{
+  tileDynamicGeneration.fetchAndAddOrdered(1);
+}
+
+WebMapController::Job *WebMapController::nextJob()
+{
+  if(clientOrder.isEmpty())
+    return nullptr;
+
+  // Take one job from the next client in line
+  nextClient = nextClient % clientOrder.size();
+  QString clientId = clientOrder.at(nextClient);
+  QQueue<Job *>& queue = clientQueues[clientId];
+  Job *job = queue.dequeue();
+
+  if(queue.isEmpty())
+  {
+    // Client has nothing more to do - next client moves into this index
+    clientQueues.remove(clientId);
+    clientOrder.removeAt(nextClient);
+  }
+  else
+    nextClient++;
+
+  stats.queueDepth--;
+  return job;
+}
+
+void WebMapController::processQueue()
+{
+  Job *job = nullptr;
+  qint64 waitMs = 0;
+  {
+    QMutexLocker locker(&mutex);
+    job = nextJob();
+    if(job == nullptr)
+      return;
+
+    waitMs = job->timer.elapsed();
+  }
+
+  MapPixmap result;
+  if(mapPaintWidgets.isEmpty())
+    qWarning() << Q_FUNC_INFO << "mapPaintWidgets is empty";
+  else
+    result = getPixmapRequest(widgetForClient(job->clientId), job->request);
+
+  qint64 renderMs = job->timer.elapsed() - waitMs;
+
+  QMutexLocker locker(&mutex);
+  stats.requests++;
+  stats.totalWaitMs += waitMs;
+  stats.maxWaitMs = std::max(stats.maxWaitMs, waitMs);
+  stats.totalRenderMs += renderMs;
+  stats.maxRenderMs = std::max(stats.maxRenderMs, renderMs);
+
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << "client" << job->clientId << "wait" << waitMs << "ms render" << renderMs << "ms"
+             << "queue depth" << stats.queueDepth;
+
+  if(stats.requests % STATS_LOG_INTERVAL == 0)
+    qDebug() << Q_FUNC_INFO << stats;
+
+  // Job is owned by the waiting thread - do not touch after setting done
+  job->result = result;
+  job->done = true;
+  jobDone.wakeAll();
+}
+
+MapPaintWidget *WebMapController::widgetForClient(const QString& clientId)
+{
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if(now - lastClientPruneMs > CLIENT_PRUNE_INTERVAL_MS)
+  {
+    pruneClients();
+    lastClientPruneMs = now;
+  }
+
+  // Assign widgets to clients in round robin order and keep this assignment
+  QHash<QString, ClientWidget>::iterator it = clientWidgets.find(clientId);
+  if(it == clientWidgets.end())
+    it = clientWidgets.insert(clientId, {nextWidgetIndex++ % mapPaintWidgets.size(), now});
+  else
+    it->lastUsedMs = now;
+
+  return mapPaintWidgets.at(it->index);
+}
+
+void WebMapController::pruneClients()
+{
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  for(QHash<QString, ClientWidget>::iterator it = clientWidgets.begin(); it != clientWidgets.end();)
+  {
+    if(now - it->lastUsedMs > CLIENT_TIMEOUT_MS)
+      it = clientWidgets.erase(it);
+    else
+      ++it;
+  }
+}
+
+MapPixmap WebMapController::getPixmapRequest(MapPaintWidget *widget, const MapPixmapRequest& request)
+{
+  switch(request.type)
+  {
+    case MapPixmapRequest::CURRENT:
+      return getPixmap(widget, request.width, request.height);
+
+    case MapPixmapRequest::OBJECT:
+      return getPixmapObject(widget, request.width, request.height, request.objectType, request.ident,
+                             request.distanceKm);
+
+    case MapPixmapRequest::POS_DISTANCE:
+      return getPixmapPosDistance(widget, request.width, request.height, request.pos, request.distanceKm,
+                                  request.mapCommand);
+
+    case MapPixmapRequest::RECT:
+      return getPixmapRect(widget, request.width, request.height, request.rect);
+
+    case MapPixmapRequest::TILE:
+      return getPixmapTile(widget, request.tileZ, request.tileX, request.tileY);
+  }
+  return MapPixmap();
+}
+
+void WebMapController::prepareWidget(MapPaintWidget *widget, int width, int height)
+{
+  // Copy all map settings
+  widget->copySettings(*NavApp::getMapWidget());
+
+  PreparedState state;
+  state.size = QSize(width, height);
+  state.themeId = widget->mapThemeId();
+  state.projection = widget->projection();
+  if(!(preparedStates.value(widget) == state))
+  {
+    // Prepare marble for drawing by issuing a dummy paint event
+    // Not needed if the widget was already used with this size, theme and projection since state is kept
+    widget->prepareDraw(width, height);
+    preparedStates.insert(widget, state);
+  }
+}
+
+MapPixmap WebMapController::getPixmap(MapPaintWidget *widget, int width, int height)
 {
   if(verbose)
     qDebug() << Q_FUNC_INFO << width << "x" << height;
 
-  return getPixmapPosDistance(width, height, atools::geo::EMPTY_POS,
+  return getPixmapPosDistance(widget, width, height, atools::geo::EMPTY_POS,
                               static_cast<float>(NavApp::getMapWidget()->distance()), QString());
 }
 
-MapPixmap WebMapController::getPixmapObject(int width, int height, web::ObjectType type, QString ident,
-                                            float distanceKm)
+MapPixmap WebMapController::getPixmapObject(MapPaintWidget *widget, int width, int height, web::ObjectType type,
+                                            QString ident, float distanceKm)
 {
   if(verbose)
     qDebug() << Q_FUNC_INFO << width << "x" << height << "type" << type << "ident" << ident << "distanceKm" <<
@@ -85,7 +360,7 @@ MapPixmap WebMapController::getPixmapObject(int width, int height, web::ObjectTy
         mapPixmap.error = tr("No user aircraft");
       }
       else
-        mapPixmap = getPixmapPosDistance(width, height, NavApp::getUserAircraftPos(), distanceKm, QString());
+        mapPixmap = getPixmapPosDistance(widget, width, height, NavApp::getUserAircraftPos(), distanceKm, QString());
       break;
 
     case web::ROUTE:
@@ -95,7 +370,7 @@ MapPixmap WebMapController::getPixmapObject(int width, int height, web::ObjectTy
         mapPixmap.error = tr("No flight plan");
       }
       else
-        mapPixmap = getPixmapRect(width, height, NavApp::getRouteRect());
+        mapPixmap = getPixmapRect(widget, width, height, NavApp::getRouteRect());
       break;
 
     case web::AIRPORT:
@@ -106,25 +381,22 @@ MapPixmap WebMapController::getPixmapObject(int width, int height, web::ObjectTy
         mapPixmap.error = tr("Airport %1 not found").arg(ident);
       }
       else
-        mapPixmap = getPixmapPosDistance(width, height, NavApp::getAirportPos(ident), distanceKm, QString());
+        mapPixmap = getPixmapPosDistance(widget, width, height, NavApp::getAirportPos(ident), distanceKm, QString());
       break;
   }
   return mapPixmap;
 }
 
-MapPixmap WebMapController::getPixmapPosDistance(int width, int height, atools::geo::Pos pos, float distanceKm,
-                                                 QString mapCommand)
+MapPixmap WebMapController::getPixmapPosDistance(MapPaintWidget *mapPaintWidget, int width, int height,
+                                                 atools::geo::Pos pos, float distanceKm, QString mapCommand)
 {
   if(verbose)
     qDebug() << Q_FUNC_INFO << width << "x" << height << pos << "distanceKm" << distanceKm << "cmd" << mapCommand;
 
   if(mapPaintWidget != nullptr)
   {
-    // Copy all map settings
-    mapPaintWidget->copySettings(*NavApp::getMapWidget());
-
-    // Prepare marble for drawing by issuing a dummy paint event
-    mapPaintWidget->prepareDraw(width, height);
+    // Copy all map settings and prepare marble for drawing
+    prepareWidget(mapPaintWidget, width, height);
 
     // Zoom one out for sharp maps
     mapPaintWidget->setAvoidBlurredMap(true);
@@ -193,7 +465,8 @@ MapPixmap WebMapController::getPixmapPosDistance(int width, int height, atools::
   }
 }
 
-MapPixmap WebMapController::getPixmapRect(int width, int height, atools::geo::Rect rect)
+MapPixmap WebMapController::getPixmapRect(MapPaintWidget *mapPaintWidget, int width, int height,
+                                          atools::geo::Rect rect)
 {
   if(verbose)
     qDebug() << Q_FUNC_INFO << width << "x" << height << rect;
@@ -203,11 +476,8 @@ MapPixmap WebMapController::getPixmapRect(int width, int height, atools::geo::Re
   {
     if(mapPaintWidget != nullptr && rect.isValid())
     {
-      // Copy all map settings
-      mapPaintWidget->copySettings(*NavApp::getMapWidget());
-
-      // Prepare marble for drawing by issuing a dummy paint event
-      mapPaintWidget->prepareDraw(width, height);
+      // Copy all map settings and prepare marble for drawing
+      prepareWidget(mapPaintWidget, width, height);
 
       // Do not center world rectangle when resizing
       mapPaintWidget->setKeepWorldRect(false);
@@ -230,3 +500,57 @@ MapPixmap WebMapController::getPixmapRect(int width, int height, atools::geo::Re
     qWarning() << Q_FUNC_INFO << "mapPaintWidget is null";
   return mapPixmap;
 }
+
+MapPixmap WebMapController::getPixmapTile(MapPaintWidget *mapPaintWidget, int z, int x, int y)
+{
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << z << x << y;
+
+  MapPixmap mapPixmap;
+  if(mapPaintWidget != nullptr)
+  {
+    // Copy all map settings and prepare marble for drawing
+    prepareWidget(mapPaintWidget, TILE_SIZE, TILE_SIZE);
+
+    // Leave out all dynamic content which would make tiles outdated immediately
+    mapPaintWidget->setShowMapFeatures(map::FLIGHTPLAN | map::AIRCRAFT_ALL | map::AIRCRAFT_TRACK |
+                                       map::COMPASS_ROSE, false);
+
+    // Weather changes often and rendering it would also trigger weather requests
+    mapPaintWidget->setShowMapFeaturesDisplay(map::AIRPORT_WEATHER | map::WIND_BARBS | map::WIND_BARBS_ROUTE, false);
+
+    // Tiles have to match exactly - do not adjust zoom or position
+    mapPaintWidget->setAvoidBlurredMap(false);
+    mapPaintWidget->setKeepWorldRect(false);
+    mapPaintWidget->setProjection(Marble::Mercator);
+
+    // World width for Mercator is four times the radius
+    mapPaintWidget->setRadius(TILE_SIZE / 4 * (1 << z));
+
+    // Center of tile in spherical Mercator
+    double n = static_cast<double>(1 << z);
+    double lonX = (x + 0.5) / n * 360. - 180.;
+    double latY = atools::geo::toDegree(std::atan(std::sinh(M_PI * (1. - 2. * (y + 0.5) / n))));
+    mapPaintWidget->centerOn(lonX, latY);
+
+    mapPixmap.correctedDistanceKm = mapPixmap.requestedDistanceKm = static_cast<float>(mapPaintWidget->distance());
+    mapPixmap.pixmap = mapPaintWidget->getPixmap(TILE_SIZE, TILE_SIZE);
+    mapPixmap.pos = mapPaintWidget->getCurrentViewCenterPos();
+    mapPixmap.rect = mapPaintWidget->getCurrentViewRect();
+  }
+  else
+    qWarning() << Q_FUNC_INFO << "mapPaintWidget is null";
+  return mapPixmap;
+}
+
+QDebug operator<<(QDebug out, const MapPixmapStats& stats)
+{
+  QDebugStateSaver saver(out);
+  out.nospace().noquote() << "MapPixmapStats[requests " << stats.requests
+                          << ", queue depth " << stats.queueDepth << ", max queue depth " << stats.maxQueueDepth
+                          << ", avg wait " << (stats.requests > 0 ? stats.totalWaitMs / stats.requests : 0)
+                          << " ms, max wait " << stats.maxWaitMs
+                          << " ms, avg render " << (stats.requests > 0 ? stats.totalRenderMs / stats.requests : 0)
+                          << " ms, max render " << stats.maxRenderMs << " ms]";
+  return out;
+}
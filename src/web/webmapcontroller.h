@@ -21,10 +21,20 @@
 #include "web/webflags.h"
 
 #include "geo/rect.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
 #include <QPixmap>
+#include <QQueue>
+#include <QSize>
+#include <QVector>
+#include <QWaitCondition>
 
 class QPixmap;
 class MapPaintWidget;
+class WebTileCache;
 
 /*
  * Result of a map image creating also covering error messages, center position, zoom distance and shown rectangle.
@@ -53,13 +63,49 @@ struct MapPixmap
 };
 
 /*
- * Wraps the MapPaintWidget and provides methods to retreive map images.
+ * Parameters for a map image request which is queued by WebMapController::getPixmapQueued().
+ */
+struct MapPixmapRequest
+{
+  enum Type
+  {
+    CURRENT, /* Current position of visible map - uses width and height */
+    OBJECT, /* Center map object - uses width, height, objectType, ident and distanceKm */
+    POS_DISTANCE, /* Position and distance - uses width, height, pos, distanceKm and mapCommand */
+    RECT, /* Rectangle - uses width, height and rect */
+    TILE /* Slippy map tile in Web Mercator projection - uses tileZ, tileX and tileY */
+  };
+
+  Type type = CURRENT;
+  int width = 0, height = 0;
+  web::ObjectType objectType = web::USER_AIRCRAFT;
+  QString ident, mapCommand;
+  float distanceKm = 0.f;
+  atools::geo::Pos pos;
+  atools::geo::Rect rect;
+  int tileZ = 0, tileX = 0, tileY = 0;
+};
+
+/* Queue and render time statistics for the web map render pool */
+struct MapPixmapStats
+{
+  quint64 requests = 0;
+  int queueDepth = 0, maxQueueDepth = 0;
+  qint64 totalWaitMs = 0, maxWaitMs = 0, totalRenderMs = 0, maxRenderMs = 0;
+};
+
+QDebug operator<<(QDebug out, const MapPixmapStats& stats);
+
+/*
+ * Wraps a pool of MapPaintWidgets and provides methods to retreive map images.
  *
- * The map widget has a state, i.e. it remains in the last shown position and zoom value.
+ * Each map widget has a state, i.e. it remains in the last shown position, size and zoom value.
+ * Clients are assigned to a widget of the pool to keep this state and the Marble tile caches per client.
  * Settings are copied from normal visible map window before rendering.
  *
- * This has to run in the main thread and event queue. Therefore, it is necessary to use queued signals to separate
- * a thread from the HTTP server.
+ * Rendering has to run in the main thread and event queue since Marble widgets cannot paint in other threads.
+ * HTTP server threads call getPixmapQueued() which puts the request into a per client queue and waits for the result.
+ * The main thread processes the queues in round robin order so that a single client cannot starve others.
  *
  * All methods avoid a blurry map by zoomin out to the next best level. This can result in different distances
  * than expected.
@@ -70,30 +116,133 @@ class WebMapController :
   Q_OBJECT
 
 public:
-  explicit WebMapController(QWidget *parent, bool verboseParam);
+  /* poolSizeParam is the number of map widgets - one widget is used if less than one */
+  explicit WebMapController(QWidget *parent, bool verboseParam, int poolSizeParam = 1);
   virtual ~WebMapController() override;
 
-  /* Create or delete the map paint widget */
+  /* Create or delete the map paint widgets. Pending requests are answered with an error on deInit. */
   void init();
   void deInit();
 
+  /* Thread safe. Queue request for the given client id and wait until it is rendered in the main thread. */
+  MapPixmap getPixmapQueued(const QString& clientId, const MapPixmapRequest& request);
+
+  /* Thread safe. Copy of current queue and latency statistics. */
+  MapPixmapStats getStats() const;
+
+  /* Thread safe. Get a PNG encoded 256 pixel tile from the tile cache or queue rendering if not cached.
+   * Tiles contain only static map content. Flight plan, aircraft, track and weather are left out since clients
+   * are expected to draw these as dynamic overlays. Returns false and sets error if rendering failed. */
+  bool getTileQueued(const QString& clientId, int z, int x, int y, QByteArray& png, QString& error);
+
+  /* Drop all cached tiles. Call from main thread if map settings, theme or database changed. */
+  void clearTileCache();
+
+  /* Use new tiles after changes of dynamic content drawn in tiles like online centers or userpoints.
+   * Old tiles are not deleted but removed from the cache over time. */
+  void dynamicDataChanged();
+
+private:
+  /* A request waiting in the queue */
+  struct Job
+  {
+    QString clientId;
+    MapPixmapRequest request;
+    MapPixmap result;
+    QElapsedTimer timer;
+    bool done = false;
+  };
+
+  /* Processes the next job in the main thread */
+  Q_INVOKABLE void processQueue();
+
+  /* Get next job in round robin order from client queues. Caller has to lock mutex. */
+  Job *nextJob();
+
+  /* Get or assign map widget for client */
+  MapPaintWidget *widgetForClient(const QString& clientId);
+
+  /* Dispatch request to one of the methods below */
+  MapPixmap getPixmapRequest(MapPaintWidget *widget, const MapPixmapRequest& request);
+
   /* Get pixmap with given width and height from current position. */
-  MapPixmap getPixmap(int width, int height);
+  MapPixmap getPixmap(MapPaintWidget *widget, int width, int height);
 
   /* Get pixmap with given width and height for a map object like an airport, the user aircraft or a route. */
-  MapPixmap getPixmapObject(int width, int height, web::ObjectType type, QString ident, float distanceKm);
+  MapPixmap getPixmapObject(MapPaintWidget *widget, int width, int height, web::ObjectType type, QString ident,
+                            float distanceKm);
 
   /* Get map at given position and distance. Command can be used to zoom in/out or scroll from the given position:
    * "in", "out", "left", "right", "up" and "down".  */
-  MapPixmap getPixmapPosDistance(int width, int height, atools::geo::Pos pos, float distanceKm, QString mapCommand);
+  MapPixmap getPixmapPosDistance(MapPaintWidget *widget, int width, int height, atools::geo::Pos pos,
+                                 float distanceKm, QString mapCommand);
 
   /* Zoom to rectangel on map. */
-  MapPixmap getPixmapRect(int width, int height, atools::geo::Rect rect);
+  MapPixmap getPixmapRect(MapPaintWidget *widget, int width, int height, atools::geo::Rect rect);
+
+  /* Render slippy map tile z/x/y using Mercator projection */
+  MapPixmap getPixmapTile(MapPaintWidget *widget, int z, int x, int y);
+
+  /* Copy settings and issue a dummy paint event if size, theme or projection has changed */
+  void prepareWidget(MapPaintWidget *widget, int width, int height);
+
+  /* Remove widget assignments of clients which did not send requests for a while */
+  void pruneClients();
+
+  /* State used for the last prepareDraw() of a widget */
+  struct PreparedState
+  {
+    QSize size;
+    QString themeId;
+    int projection = -1;
+
+    bool operator==(const PreparedState& other) const
+    {
+      return size == other.size && themeId == other.themeId && projection == other.projection;
+    }
+
+  };
+
+  /* Index in mapPaintWidgets and time of last request in ms since epoch */
+  struct ClientWidget
+  {
+    int index;
+    qint64 lastUsedMs;
+  };
+
+  /* Remove clients after ten minutes without requests. Checked once a minute. */
+  static Q_DECL_CONSTEXPR qint64 CLIENT_TIMEOUT_MS = 10L * 60L * 1000L;
+  static Q_DECL_CONSTEXPR qint64 CLIENT_PRUNE_INTERVAL_MS = 60L * 1000L;
+
+  QVector<MapPaintWidget *> mapPaintWidgets;
+
+  QHash<MapPaintWidget *, PreparedState> preparedStates;
+
+  /* Client id to assigned widget */
+  QHash<QString, ClientWidget> clientWidgets;
+  int nextWidgetIndex = 0;
+  qint64 lastClientPruneMs = 0;
+
+  /* Pending jobs per client and round robin order of clients. Protected by mutex. */
+  QHash<QString, QQueue<Job *> > clientQueues;
+  QStringList clientOrder;
+  int nextClient = 0;
+
+  mutable QMutex mutex;
+  QWaitCondition jobDone;
+  MapPixmapStats stats;
+
+  /* Rendered tiles in memory and on disk. Keys are prefixed with tileGeneration which is increased
+   * on invalidation so that tiles rendered with old settings are not returned. */
+  WebTileCache *tileCache = nullptr;
+  QAtomicInt tileGeneration;
+
+  /* Second part of the key which is increased on changes of dynamic content */
+  QAtomicInt tileDynamicGeneration;
 
-private:
-  MapPaintWidget *mapPaintWidget = nullptr;
   QWidget *parentWidget;
   bool verbose = false;
+  int poolSize = 1;
 };
 
 #endif // LNM_WEBMAPCONTROLLER_H
@@ -0,0 +1,176 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "web/webtilecache.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+WebTileCache::WebTileCache(const QString& directoryParam, qint64 maxMemoryBytes, qint64 maxDiskBytesParam)
+  : baseDirectory(directoryParam), maxDiskBytes(maxDiskBytesParam)
+{
+  QString session = QString::number(QDateTime::currentMSecsSinceEpoch());
+  directory = baseDirectory + QDir::separator() + session;
+
+  qDebug() << Q_FUNC_INFO << directory << "memory" << maxMemoryBytes << "disk" << maxDiskBytes;
+
+  memoryCache.setMaxCost(static_cast<int>(maxMemoryBytes / 1024));
+
+  // Remove files of previous sessions lazily
+  QStringList oldDirectories;
+  for(const QFileInfo& info : QDir(baseDirectory).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+  {
+    if(info.fileName() != session)
+      oldDirectories.append(info.absoluteFilePath());
+  }
+  removeDirectories(oldDirectories);
+}
+
+WebTileCache::~WebTileCache()
+{
+  qDebug() << Q_FUNC_INFO << getStatistics();
+
+  for(QFuture<void>& future : removeFutures)
+    future.waitForFinished();
+}
+
+bool WebTileCache::getTile(const QString& key, QByteArray& data)
+{
+  QMutexLocker locker(&mutex);
+
+  QByteArray *cached = memoryCache.object(key);
+  if(cached != nullptr)
+  {
+    memoryHits++;
+    data = *cached;
+    return true;
+  }
+
+  if(diskSizes.contains(key))
+  {
+    QFile file(filename(key));
+    if(file.open(QIODevice::ReadOnly))
+    {
+      data = file.readAll();
+      file.close();
+
+      diskHits++;
+      memoryCache.insert(key, new QByteArray(data), std::max(data.size() / 1024, 1));
+      return true;
+    }
+    else
+      qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << file.errorString();
+  }
+
+  misses++;
+  return false;
+}
+
+void WebTileCache::insertTile(const QString& key, const QByteArray& data)
+{
+  QMutexLocker locker(&mutex);
+
+  memoryCache.insert(key, new QByteArray(data), std::max(data.size() / 1024, 1));
+
+  if(maxDiskBytes <= 0 || diskSizes.contains(key))
+    return;
+
+  // Write to disk
+  QString name = filename(key);
+  QDir().mkpath(QFileInfo(name).path());
+  QFile file(name);
+  if(file.open(QIODevice::WriteOnly))
+  {
+    file.write(data);
+    file.close();
+
+    diskKeys.enqueue(key);
+    diskSizes.insert(key, data.size());
+    diskBytes += data.size();
+  }
+  else
+    qWarning() << Q_FUNC_INFO << "Cannot open" << file.fileName() << file.errorString();
+
+  // Remove oldest files if size is exceeded
+  while(diskBytes > maxDiskBytes && !diskKeys.isEmpty())
+  {
+    QString oldKey = diskKeys.dequeue();
+    diskBytes -= diskSizes.take(oldKey);
+    QFile::remove(filename(oldKey));
+  }
+}
+
+void WebTileCache::clear()
+{
+  QMutexLocker locker(&mutex);
+  qDebug() << Q_FUNC_INFO;
+
+  memoryCache.clear();
+
+  if(!diskKeys.isEmpty())
+  {
+    // Continue in a new directory and remove the old one in background
+    QString oldDirectory = directory + QDir::separator() + QString::number(epoch);
+    epoch++;
+
+    diskKeys.clear();
+    diskSizes.clear();
+    diskBytes = 0;
+
+    removeDirectories({oldDirectory});
+  }
+}
+
+QString WebTileCache::getStatistics() const
+{
+  QMutexLocker locker(&mutex);
+  return QString("memory hits %1, disk hits %2, misses %3, memory %4 kB, disk %5 kB, disk files %6").
+         arg(memoryHits).arg(diskHits).arg(misses).
+         arg(memoryCache.totalCost()).arg(diskBytes / 1024).arg(diskKeys.size());
+}
+
+void WebTileCache::removeDirectories(const QStringList& directories)
+{
+  if(directories.isEmpty())
+    return;
+
+  // Forget finished jobs
+  removeFutures.erase(std::remove_if(removeFutures.begin(), removeFutures.end(),
+                                     [ = ](const QFuture<void>& future) -> bool {
+    return future.isFinished();
+  }), removeFutures.end());
+
+  removeFutures.append(QtConcurrent::run([ = ]() -> void {
+    for(const QString& dirname : directories)
+    {
+      QDir dir(dirname);
+      if(dir.exists() && !dir.removeRecursively())
+        qWarning() << Q_FUNC_INFO << "Cannot remove" << dirname;
+    }
+  }));
+}
+
+QString WebTileCache::filename(const QString& key) const
+{
+  return directory + QDir::separator() + QString::number(epoch) + QDir::separator() + key + ".png";
+}
@@ -0,0 +1,85 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LNM_WEBTILECACHE_H
+#define LNM_WEBTILECACHE_H
+
+#include <QCache>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+
+/*
+ * Thread safe two level cache for rendered map tiles. Encoded images are kept in a memory cache
+ * and in a directory on disk which are both bounded by size in bytes. Oldest files are removed first on disk.
+ *
+ * Keys have to be usable as relative file paths like "prefix/z/x/y". The prefix has to contain everything
+ * that changes the tile content like database and options generation.
+ *
+ * Files are stored in a directory for each session and clear call since generation numbers are not valid
+ * across sessions. Outdated directories are removed in background and not in the calling thread.
+ */
+class WebTileCache
+{
+public:
+  WebTileCache(const QString& directoryParam, qint64 maxMemoryBytes, qint64 maxDiskBytesParam);
+  ~WebTileCache();
+
+  /* Get tile from memory or disk. Returns false if not found. */
+  bool getTile(const QString& key, QByteArray& data);
+
+  /* Insert tile into memory and disk cache */
+  void insertTile(const QString& key, const QByteArray& data);
+
+  /* Remove all tiles from memory and disk. Files are deleted in background. */
+  void clear();
+
+  /* Counters for log */
+  QString getStatistics() const;
+
+private:
+  QString filename(const QString& key) const;
+
+  /* Remove directories recursively in a background thread */
+  void removeDirectories(const QStringList& directories);
+
+  /* Base directory containing the session directories */
+  QString baseDirectory;
+
+  /* Directory for the current session and clear counter */
+  QString directory;
+  int epoch = 0;
+
+  /* Waited for on destruction */
+  QVector<QFuture<void> > removeFutures;
+
+  /* Cost is size in kB */
+  QCache<QString, QByteArray> memoryCache;
+
+  /* Disk files in order of insertion and their size */
+  QQueue<QString> diskKeys;
+  QHash<QString, qint64> diskSizes;
+  qint64 diskBytes = 0, maxDiskBytes;
+
+  quint64 memoryHits = 0, diskHits = 0, misses = 0;
+
+  mutable QMutex mutex;
+};
+
+#endif // LNM_WEBTILECACHE_H
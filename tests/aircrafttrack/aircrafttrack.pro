@@ -0,0 +1,50 @@
+#*****************************************************************************
+# Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#****************************************************************************
+
+# =============================================================================
+# Unit test for the aircraft track file format.
+# Uses the same ATOOLS_INC_PATH and ATOOLS_LIB_PATH environment variables as littlenavmap.pro.
+# Run with "qmake && make check".
+# =============================================================================
+
+QT += core gui sql xml network testlib
+
+CONFIG += c++14 console testcase
+CONFIG -= app_bundle debug_and_release debug_and_release_target
+
+TARGET = aircrafttracktest
+TEMPLATE = app
+
+ATOOLS_INC_PATH=$$(ATOOLS_INC_PATH)
+ATOOLS_LIB_PATH=$$(ATOOLS_LIB_PATH)
+
+CONFIG(debug, debug|release) : CONF_TYPE=debug
+CONFIG(release, debug|release) : CONF_TYPE=release
+
+isEmpty(ATOOLS_INC_PATH) : ATOOLS_INC_PATH=$$PWD/../../../atools/src
+isEmpty(ATOOLS_LIB_PATH) : ATOOLS_LIB_PATH=$$PWD/../../../build-atools-$$CONF_TYPE
+
+INCLUDEPATH += $$PWD/../../src $$ATOOLS_INC_PATH
+DEPENDPATH += $$ATOOLS_INC_PATH
+LIBS += -L$$ATOOLS_LIB_PATH -latools -lz
+
+SOURCES += \
+  aircrafttracktest.cpp \
+  ../../src/common/aircrafttrack.cpp
+
+HEADERS += \
+  ../../src/common/aircrafttrack.h
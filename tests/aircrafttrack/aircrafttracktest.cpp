@@ -0,0 +1,160 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/aircrafttrack.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDateTime>
+#include <QtTest>
+
+/* Start of timestamps and distance between positions which is larger than the recording thresholds */
+static const quint32 BASE_TIME = 1577836800;
+static const quint32 TIME_STEP_SEC = 10;
+static const float LONX_STEP_DEG = 0.01f;
+
+/*
+ * Checks that positions pruned from the track between saves are not restored when reading an
+ * appended track file.
+ */
+class AircraftTrackTest :
+  public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void testAppendAfterPrune();
+  void testAppendPruneOnly();
+  void testRewriteRoundTrip();
+
+private:
+  /* Add positions with index from to to (exclusive) */
+  static void appendPositions(AircraftTrack& track, int from, int to);
+
+  static void save(AircraftTrack& track, QByteArray& bytes);
+  static void append(AircraftTrack& track, QByteArray& bytes);
+  static void load(AircraftTrack& track, const QByteArray& bytes);
+
+  static quint32 timestamp(int index)
+  {
+    return BASE_TIME + static_cast<quint32>(index) * TIME_STEP_SEC;
+  }
+
+};
+
+void AircraftTrackTest::appendPositions(AircraftTrack& track, int from, int to)
+{
+  for(int i = from; i < to; i++)
+    track.appendTrackPos(atools::geo::Pos(10.f + i * LONX_STEP_DEG, 50.f, 5000.f),
+                         QDateTime::fromTime_t(timestamp(i), Qt::UTC), false);
+}
+
+void AircraftTrackTest::save(AircraftTrack& track, QByteArray& bytes)
+{
+  QBuffer buffer(&bytes);
+  QVERIFY(buffer.open(QIODevice::WriteOnly));
+  QDataStream out(&buffer);
+  track.saveToStream(out);
+}
+
+void AircraftTrackTest::append(AircraftTrack& track, QByteArray& bytes)
+{
+  QBuffer buffer(&bytes);
+  QVERIFY(buffer.open(QIODevice::WriteOnly | QIODevice::Append));
+  QDataStream out(&buffer);
+  track.appendToStream(out);
+}
+
+void AircraftTrackTest::load(AircraftTrack& track, const QByteArray& bytes)
+{
+  QByteArray copy(bytes);
+  QBuffer buffer(&copy);
+  QVERIFY(buffer.open(QIODevice::ReadOnly));
+  QDataStream in(&buffer);
+  QVERIFY(track.readFromStream(in));
+}
+
+void AircraftTrackTest::testAppendAfterPrune()
+{
+  AircraftTrack track;
+  track.setMaxTrackEntries(1000);
+
+  QByteArray bytes;
+  appendPositions(track, 0, 1000);
+  save(track, bytes);
+
+  // Prunes the oldest 200 positions which are already in the file
+  appendPositions(track, 1000, 1150);
+  QCOMPARE(track.size(), 950);
+  append(track, bytes);
+
+  AircraftTrack loaded;
+  loaded.setMaxTrackEntries(1000);
+  load(loaded, bytes);
+
+  QCOMPARE(loaded.size(), track.size());
+  QCOMPARE(loaded.first().timestamp, timestamp(200));
+  QCOMPARE(loaded.last().timestamp, timestamp(1149));
+}
+
+void AircraftTrackTest::testAppendPruneOnly()
+{
+  AircraftTrack track;
+  track.setMaxTrackEntries(1000);
+
+  QByteArray bytes;
+  appendPositions(track, 0, 1000);
+  save(track, bytes);
+
+  // Prune without adding positions - block contains only the number of pruned positions
+  track.setMaxTrackEntries(500);
+  append(track, bytes);
+
+  AircraftTrack loaded;
+  loaded.setMaxTrackEntries(1000);
+  load(loaded, bytes);
+
+  QCOMPARE(loaded.size(), 500);
+  QCOMPARE(loaded.first().timestamp, timestamp(500));
+  QCOMPARE(loaded.last().timestamp, timestamp(999));
+}
+
+void AircraftTrackTest::testRewriteRoundTrip()
+{
+  AircraftTrack track;
+  track.setMaxTrackEntries(1000);
+  appendPositions(track, 0, 1150);
+
+  // Complete rewrite contains only the current positions
+  QByteArray bytes;
+  save(track, bytes);
+
+  AircraftTrack loaded;
+  loaded.setMaxTrackEntries(1000);
+  load(loaded, bytes);
+
+  QCOMPARE(loaded.size(), track.size());
+  for(int i = 0; i < track.size(); i++)
+  {
+    QCOMPARE(loaded.at(i).timestamp, track.at(i).timestamp);
+    QVERIFY(loaded.getPos(i).almostEqual(track.getPos(i)));
+  }
+}
+
+QTEST_APPLESS_MAIN(AircraftTrackTest)
+
+#include "aircrafttracktest.moc"